@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_BACKEND_HPP
+#define ROC_BANDWIDTH_TEST_BACKEND_HPP
+
+#include "hsa/hsa.h"
+#include "hsa/hsa_ext_amd.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// @brief: Interface to the services of Roc runtime used by the test.
+// Methods mirror the Roc runtime Apis they stand for, including the
+// status values they return, so that callers may treat them alike
+class Backend {
+
+ public:
+
+  virtual ~Backend() {}
+
+  // @brief: Initialize and shut down the runtime
+  virtual hsa_status_t Init() = 0;
+  virtual hsa_status_t ShutDown() = 0;
+
+  // @brief: Query attributes of system, agents and memory pools
+  virtual hsa_status_t SystemGetInfo(hsa_system_info_t attribute, void* value) = 0;
+  virtual hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                     void* data) = 0;
+  virtual hsa_status_t AgentGetInfo(hsa_agent_t agent,
+                                    hsa_agent_info_t attribute, void* value) = 0;
+  virtual hsa_status_t IterateMemoryPools(hsa_agent_t agent,
+                                          hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                   void* data),
+                                          void* data) = 0;
+  virtual hsa_status_t PoolGetInfo(hsa_amd_memory_pool_t pool,
+                                   hsa_amd_memory_pool_info_t attribute, void* value) = 0;
+  virtual hsa_status_t AgentPoolGetInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                        hsa_amd_agent_memory_pool_info_t attribute,
+                                        void* value) = 0;
+
+  // @brief: Allocate, free and grant access to buffers of memory pools
+  virtual hsa_status_t PoolAllocate(hsa_amd_memory_pool_t pool, size_t size,
+                                    uint32_t flags, void** ptr) = 0;
+  virtual hsa_status_t PoolFree(void* ptr) = 0;
+  virtual hsa_status_t AllowAccess(uint32_t num_agents, const hsa_agent_t* agents,
+                                   const uint32_t* flags, const void* ptr) = 0;
+
+  // @brief: Pin a buffer of system memory allocated by the test
+  // and map it for agents, all of them if the list is empty
+  virtual hsa_status_t MemoryLock(void* host_ptr, size_t size,
+                                  hsa_agent_t* agents, int num_agents,
+                                  void** agent_ptr) = 0;
+  virtual hsa_status_t MemoryUnlock(void* host_ptr) = 0;
+
+  // @brief: Copy a buffer asynchronously, completion signal is
+  // decremented once the copy has completed
+  virtual hsa_status_t AsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                 const void* src, hsa_agent_t src_agent,
+                                 size_t size, uint32_t num_dep_signals,
+                                 const hsa_signal_t* dep_signals,
+                                 hsa_signal_t completion_signal) = 0;
+
+  // @brief: Create, update and wait on signals
+  virtual hsa_status_t SignalCreate(hsa_signal_value_t initial_value,
+                                    hsa_signal_t* signal) = 0;
+  virtual hsa_status_t SignalDestroy(hsa_signal_t signal) = 0;
+  virtual void SignalStore(hsa_signal_t signal, hsa_signal_value_t value) = 0;
+  virtual hsa_signal_value_t SignalWait(hsa_signal_t signal,
+                                        hsa_signal_condition_t condition,
+                                        hsa_signal_value_t compare_value,
+                                        hsa_wait_state_t wait_state) = 0;
+
+  // @brief: Enable profiling of copies and read their timestamps
+  virtual hsa_status_t ProfilingEnable(bool enable) = 0;
+  virtual hsa_status_t GetAsyncCopyTime(hsa_signal_t signal,
+                                        hsa_amd_profiling_async_copy_time_t* time) = 0;
+
+  // @brief: Create the backend selected by env key ROCM_BW_BACKEND
+  static Backend* Create();
+};
+
+// @brief: Backend that forwards every call to Roc runtime
+class HsaBackend : public Backend {
+
+ public:
+
+  virtual hsa_status_t Init();
+  virtual hsa_status_t ShutDown();
+  virtual hsa_status_t SystemGetInfo(hsa_system_info_t attribute, void* value);
+  virtual hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                     void* data);
+  virtual hsa_status_t AgentGetInfo(hsa_agent_t agent,
+                                    hsa_agent_info_t attribute, void* value);
+  virtual hsa_status_t IterateMemoryPools(hsa_agent_t agent,
+                                          hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                   void* data),
+                                          void* data);
+  virtual hsa_status_t PoolGetInfo(hsa_amd_memory_pool_t pool,
+                                   hsa_amd_memory_pool_info_t attribute, void* value);
+  virtual hsa_status_t AgentPoolGetInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                        hsa_amd_agent_memory_pool_info_t attribute,
+                                        void* value);
+  virtual hsa_status_t PoolAllocate(hsa_amd_memory_pool_t pool, size_t size,
+                                    uint32_t flags, void** ptr);
+  virtual hsa_status_t PoolFree(void* ptr);
+  virtual hsa_status_t AllowAccess(uint32_t num_agents, const hsa_agent_t* agents,
+                                   const uint32_t* flags, const void* ptr);
+  virtual hsa_status_t MemoryLock(void* host_ptr, size_t size,
+                                  hsa_agent_t* agents, int num_agents,
+                                  void** agent_ptr);
+  virtual hsa_status_t MemoryUnlock(void* host_ptr);
+  virtual hsa_status_t AsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                 const void* src, hsa_agent_t src_agent,
+                                 size_t size, uint32_t num_dep_signals,
+                                 const hsa_signal_t* dep_signals,
+                                 hsa_signal_t completion_signal);
+  virtual hsa_status_t SignalCreate(hsa_signal_value_t initial_value,
+                                    hsa_signal_t* signal);
+  virtual hsa_status_t SignalDestroy(hsa_signal_t signal);
+  virtual void SignalStore(hsa_signal_t signal, hsa_signal_value_t value);
+  virtual hsa_signal_value_t SignalWait(hsa_signal_t signal,
+                                        hsa_signal_condition_t condition,
+                                        hsa_signal_value_t compare_value,
+                                        hsa_wait_state_t wait_state);
+  virtual hsa_status_t ProfilingEnable(bool enable);
+  virtual hsa_status_t GetAsyncCopyTime(hsa_signal_t signal,
+                                        hsa_amd_profiling_async_copy_time_t* time);
+};
+
+// @brief: Backend that simulates a system of Cpu and Gpu devices. Copies
+// move data with memcpy on a host thread and complete at the time given
+// by a model of the links they traverse. Each link is a resource that
+// serves one copy at a time, so copies sharing a link are serialized.
+//
+// The model is configured by env key ROCM_BW_SIM_MODEL, a list of
+// key=value pairs separated by commas e.g. "cpus=2,gpus=8,xgmi_bw=50":
+//
+//    cpus       Number of Cpu devices, i.e. NUMA nodes         (1)
+//    gpus       Number of Gpu devices                          (2)
+//    gpu_mem    Size of memory of a Gpu device in GB           (16)
+//    pcie_bw    Bandwidth of the PCIe link of a Gpu in GB/s    (12)
+//    xgmi_bw    Bandwidth of XGMI link among Gpus in GB/s, 0
+//               if peer copies are routed over PCIe             (0)
+//    socket_bw  Bandwidth of the link among Cpu devices, GB/s  (40)
+//    local_bw   Bandwidth of copies within a device in GB/s    (200)
+//    latency    Time taken to start a copy in microseconds     (10)
+//    sleep      Complete copies at their modeled time (1) or as
+//               soon as their data is moved (0). The latter
+//               exposes the overhead of the test itself         (1)
+class SimBackend : public Backend {
+
+ public:
+
+  SimBackend(const char* model);
+  virtual ~SimBackend();
+
+  virtual hsa_status_t Init();
+  virtual hsa_status_t ShutDown();
+  virtual hsa_status_t SystemGetInfo(hsa_system_info_t attribute, void* value);
+  virtual hsa_status_t IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                     void* data);
+  virtual hsa_status_t AgentGetInfo(hsa_agent_t agent,
+                                    hsa_agent_info_t attribute, void* value);
+  virtual hsa_status_t IterateMemoryPools(hsa_agent_t agent,
+                                          hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                   void* data),
+                                          void* data);
+  virtual hsa_status_t PoolGetInfo(hsa_amd_memory_pool_t pool,
+                                   hsa_amd_memory_pool_info_t attribute, void* value);
+  virtual hsa_status_t AgentPoolGetInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                        hsa_amd_agent_memory_pool_info_t attribute,
+                                        void* value);
+  virtual hsa_status_t PoolAllocate(hsa_amd_memory_pool_t pool, size_t size,
+                                    uint32_t flags, void** ptr);
+  virtual hsa_status_t PoolFree(void* ptr);
+  virtual hsa_status_t AllowAccess(uint32_t num_agents, const hsa_agent_t* agents,
+                                   const uint32_t* flags, const void* ptr);
+  virtual hsa_status_t MemoryLock(void* host_ptr, size_t size,
+                                  hsa_agent_t* agents, int num_agents,
+                                  void** agent_ptr);
+  virtual hsa_status_t MemoryUnlock(void* host_ptr);
+  virtual hsa_status_t AsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                 const void* src, hsa_agent_t src_agent,
+                                 size_t size, uint32_t num_dep_signals,
+                                 const hsa_signal_t* dep_signals,
+                                 hsa_signal_t completion_signal);
+  virtual hsa_status_t SignalCreate(hsa_signal_value_t initial_value,
+                                    hsa_signal_t* signal);
+  virtual hsa_status_t SignalDestroy(hsa_signal_t signal);
+  virtual void SignalStore(hsa_signal_t signal, hsa_signal_value_t value);
+  virtual hsa_signal_value_t SignalWait(hsa_signal_t signal,
+                                        hsa_signal_condition_t condition,
+                                        hsa_signal_value_t compare_value,
+                                        hsa_wait_state_t wait_state);
+  virtual hsa_status_t ProfilingEnable(bool enable);
+  virtual hsa_status_t GetAsyncCopyTime(hsa_signal_t signal,
+                                        hsa_amd_profiling_async_copy_time_t* time);
+
+ private:
+
+  // Signal of the simulator, its address is the handle of the signal
+  struct SimSignal {
+    std::atomic<int64_t> value_;
+    uint64_t start_;
+    uint64_t end_;
+  };
+
+  // Copy waiting to be started or completed by the copy thread
+  struct SimCopy {
+    void* dst_;
+    const void* src_;
+    size_t size_;
+    vector<uint32_t> links_;
+    vector<hsa_signal_t> deps_;
+    SimSignal* signal_;
+    uint64_t submit_;
+    uint64_t end_;
+  };
+
+  // Index of agents: Cpu devices come first followed by Gpu devices
+  uint32_t NumAgents() const { return num_cpus_ + num_gpus_; }
+  bool IsCpu(uint32_t agent_idx) const { return agent_idx < num_cpus_; }
+  uint32_t GetNode(uint32_t agent_idx) const;
+  uint32_t GetAgentIdx(hsa_agent_t agent) const;
+  uint32_t GetPoolIdx(hsa_amd_memory_pool_t pool) const;
+  uint32_t GetPoolOwner(uint32_t pool_idx) const;
+  uint64_t Now() const;
+
+  // Resolve the links traversed by a copy and their bandwidth
+  void GetPathLinks(uint32_t src_idx, uint32_t dst_idx,
+                    vector<uint32_t>& links) const;
+  double GetLinkBandwidth(uint32_t link_idx) const;
+  void GetLinkInfo(uint32_t agent_idx, uint32_t pool_owner,
+                   vector<hsa_amd_memory_pool_link_info_t>& hops) const;
+
+  // Body of the thread that executes copies
+  void CopyThread();
+  bool DepsSatisfied(const SimCopy& copy) const;
+  void StartCopy(SimCopy& copy);
+
+  // Parameters of the model
+  uint32_t num_cpus_;
+  uint32_t num_gpus_;
+  uint64_t gpu_mem_;
+  double pcie_bw_;
+  double xgmi_bw_;
+  double socket_bw_;
+  double local_bw_;
+  uint64_t latency_;
+  bool sleep_;
+
+  // Time until which each link is busy, in nanoseconds
+  vector<uint64_t> link_busy_;
+
+  // Copies waiting on their dependencies and copies in flight
+  std::mutex lock_;
+  std::condition_variable cond_;
+  std::condition_variable done_;
+  std::deque<SimCopy> waiting_;
+  std::deque<SimCopy> running_;
+  bool exit_;
+  std::thread thread_;
+};
+
+#endif  // ROC_BANDWIDTH_TEST_BACKEND_HPP
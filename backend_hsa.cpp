@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "backend.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+Backend* Backend::Create() {
+
+  char* backend = getenv("ROCM_BW_BACKEND");
+  if ((backend != NULL) && (strcmp(backend, "sim") == 0)) {
+    return new SimBackend(getenv("ROCM_BW_SIM_MODEL"));
+  }
+  return new HsaBackend();
+}
+
+hsa_status_t HsaBackend::Init() {
+  return hsa_init();
+}
+
+hsa_status_t HsaBackend::ShutDown() {
+  return hsa_shut_down();
+}
+
+hsa_status_t HsaBackend::SystemGetInfo(hsa_system_info_t attribute, void* value) {
+  return hsa_system_get_info(attribute, value);
+}
+
+hsa_status_t HsaBackend::IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                       void* data) {
+  return hsa_iterate_agents(callback, data);
+}
+
+hsa_status_t HsaBackend::AgentGetInfo(hsa_agent_t agent,
+                                      hsa_agent_info_t attribute, void* value) {
+  return hsa_agent_get_info(agent, attribute, value);
+}
+
+hsa_status_t HsaBackend::IterateMemoryPools(hsa_agent_t agent,
+                                            hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                     void* data),
+                                            void* data) {
+  return hsa_amd_agent_iterate_memory_pools(agent, callback, data);
+}
+
+hsa_status_t HsaBackend::PoolGetInfo(hsa_amd_memory_pool_t pool,
+                                     hsa_amd_memory_pool_info_t attribute, void* value) {
+  return hsa_amd_memory_pool_get_info(pool, attribute, value);
+}
+
+hsa_status_t HsaBackend::AgentPoolGetInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                          hsa_amd_agent_memory_pool_info_t attribute,
+                                          void* value) {
+  return hsa_amd_agent_memory_pool_get_info(agent, pool, attribute, value);
+}
+
+hsa_status_t HsaBackend::PoolAllocate(hsa_amd_memory_pool_t pool, size_t size,
+                                      uint32_t flags, void** ptr) {
+  return hsa_amd_memory_pool_allocate(pool, size, flags, ptr);
+}
+
+hsa_status_t HsaBackend::PoolFree(void* ptr) {
+  return hsa_amd_memory_pool_free(ptr);
+}
+
+hsa_status_t HsaBackend::AllowAccess(uint32_t num_agents, const hsa_agent_t* agents,
+                                     const uint32_t* flags, const void* ptr) {
+  return hsa_amd_agents_allow_access(num_agents, agents, flags, ptr);
+}
+
+hsa_status_t HsaBackend::MemoryLock(void* host_ptr, size_t size,
+                                    hsa_agent_t* agents, int num_agents,
+                                    void** agent_ptr) {
+  return hsa_amd_memory_lock(host_ptr, size, agents, num_agents, agent_ptr);
+}
+
+hsa_status_t HsaBackend::MemoryUnlock(void* host_ptr) {
+  return hsa_amd_memory_unlock(host_ptr);
+}
+
+hsa_status_t HsaBackend::AsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                   const void* src, hsa_agent_t src_agent,
+                                   size_t size, uint32_t num_dep_signals,
+                                   const hsa_signal_t* dep_signals,
+                                   hsa_signal_t completion_signal) {
+  return hsa_amd_memory_async_copy(dst, dst_agent, src, src_agent, size,
+                                   num_dep_signals, dep_signals, completion_signal);
+}
+
+hsa_status_t HsaBackend::SignalCreate(hsa_signal_value_t initial_value,
+                                      hsa_signal_t* signal) {
+  return hsa_signal_create(initial_value, 0, NULL, signal);
+}
+
+hsa_status_t HsaBackend::SignalDestroy(hsa_signal_t signal) {
+  return hsa_signal_destroy(signal);
+}
+
+void HsaBackend::SignalStore(hsa_signal_t signal, hsa_signal_value_t value) {
+  hsa_signal_store_relaxed(signal, value);
+}
+
+hsa_signal_value_t HsaBackend::SignalWait(hsa_signal_t signal,
+                                          hsa_signal_condition_t condition,
+                                          hsa_signal_value_t compare_value,
+                                          hsa_wait_state_t wait_state) {
+  return hsa_signal_wait_acquire(signal, condition, compare_value,
+                                 uint64_t(-1), wait_state);
+}
+
+hsa_status_t HsaBackend::ProfilingEnable(bool enable) {
+  return hsa_amd_profiling_async_copy_enable(enable);
+}
+
+hsa_status_t HsaBackend::GetAsyncCopyTime(hsa_signal_t signal,
+                                          hsa_amd_profiling_async_copy_time_t* time) {
+  return hsa_amd_profiling_get_async_copy_time(signal, time);
+}
@@ -0,0 +1,651 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "backend.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+// Numa distance reported for each kind of link
+static const uint32_t SIM_PCIE_DISTANCE = 20;
+static const uint32_t SIM_XGMI_DISTANCE = 15;
+static const uint32_t SIM_SOCKET_DISTANCE = 32;
+
+// Size of memory pools of Cpu devices
+static const uint64_t SIM_HOST_MEM_SIZE = (64ULL * 1024 * 1024 * 1024);
+static const size_t SIM_ALLOC_ALIGNMENT = 4096;
+
+// @brief: Parse the value of a key of model, exits upon an ill-formed value
+static double ParseModelValue(const std::string& key, const std::string& value) {
+
+  char* end = NULL;
+  double num = strtod(value.c_str(), &end);
+  if ((value.empty()) || (*end != '\0') || (num < 0)) {
+    std::cout << "Invalid value for key: " << key
+              << " of ROCM_BW_SIM_MODEL: " << value << std::endl;
+    exit(1);
+  }
+  return num;
+}
+
+SimBackend::SimBackend(const char* model) {
+
+  // Default model: one Cpu device driving two Gpus over PCIe
+  num_cpus_ = 1;
+  num_gpus_ = 2;
+  gpu_mem_ = 16;
+  pcie_bw_ = 12;
+  xgmi_bw_ = 0;
+  socket_bw_ = 40;
+  local_bw_ = 200;
+  latency_ = 10;
+  sleep_ = true;
+  exit_ = false;
+
+  // Override the defaults with values of user
+  std::stringstream stream((model == NULL) ? "" : model);
+  std::string pair;
+  while (std::getline(stream, pair, ',')) {
+    if (pair.empty()) {
+      continue;
+    }
+    size_t pos = pair.find('=');
+    std::string key = pair.substr(0, pos);
+    std::string value = (pos == std::string::npos) ? "" : pair.substr(pos + 1);
+    double num = ParseModelValue(key, value);
+    if (key == "cpus") {
+      num_cpus_ = num;
+    } else if (key == "gpus") {
+      num_gpus_ = num;
+    } else if (key == "gpu_mem") {
+      gpu_mem_ = num;
+    } else if (key == "pcie_bw") {
+      pcie_bw_ = num;
+    } else if (key == "xgmi_bw") {
+      xgmi_bw_ = num;
+    } else if (key == "socket_bw") {
+      socket_bw_ = num;
+    } else if (key == "local_bw") {
+      local_bw_ = num;
+    } else if (key == "latency") {
+      latency_ = num;
+    } else if (key == "sleep") {
+      sleep_ = (num != 0);
+    } else {
+      std::cout << "Unknown key of ROCM_BW_SIM_MODEL: " << key << std::endl;
+      exit(1);
+    }
+  }
+
+  // A system needs a Cpu device and links need a bandwidth
+  if ((num_cpus_ == 0) || (pcie_bw_ == 0) ||
+      (socket_bw_ == 0) || (local_bw_ == 0)) {
+    std::cout << "ROCM_BW_SIM_MODEL needs a Cpu device and nonzero bandwidths" << std::endl;
+    exit(1);
+  }
+
+  // Convert latency and memory size into the units used internally
+  latency_ *= 1000;
+  gpu_mem_ *= (1024ULL * 1024 * 1024);
+
+  // Links are: Gpu to host and host to Gpu over PCIe, XGMI for every pair
+  // of Gpus, socket for every pair of Cpus and one local link per agent
+  uint32_t num_links = (2 * num_gpus_) + (num_gpus_ * num_gpus_) +
+                       (num_cpus_ * num_cpus_) + NumAgents();
+  link_busy_.resize(num_links, 0);
+}
+
+SimBackend::~SimBackend() {
+  ShutDown();
+}
+
+hsa_status_t SimBackend::Init() {
+  if (thread_.joinable() == false) {
+    exit_ = false;
+    thread_ = std::thread(&SimBackend::CopyThread, this);
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::ShutDown() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      exit_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+uint64_t SimBackend::Now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t SimBackend::GetNode(uint32_t agent_idx) const {
+  return IsCpu(agent_idx) ? agent_idx : ((agent_idx - num_cpus_) % num_cpus_);
+}
+
+uint32_t SimBackend::GetAgentIdx(hsa_agent_t agent) const {
+  return (agent.handle == 0) ? NumAgents() : uint32_t(agent.handle - 1);
+}
+
+// Pools are numbered as: fine-grained and coarse-grained pool
+// of every Cpu device followed by the pool of every Gpu device
+uint32_t SimBackend::GetPoolIdx(hsa_amd_memory_pool_t pool) const {
+  uint32_t num_pools = (2 * num_cpus_) + num_gpus_;
+  return ((pool.handle == 0) || (pool.handle > num_pools)) ?
+                      num_pools : uint32_t(pool.handle - 1);
+}
+
+uint32_t SimBackend::GetPoolOwner(uint32_t pool_idx) const {
+  return (pool_idx < (2 * num_cpus_)) ? (pool_idx / 2) :
+                                        (pool_idx - num_cpus_);
+}
+
+void SimBackend::GetPathLinks(uint32_t src_idx, uint32_t dst_idx,
+                              vector<uint32_t>& links) const {
+
+  uint32_t gpu_up = 0;
+  uint32_t gpu_down = num_gpus_;
+  uint32_t xgmi = 2 * num_gpus_;
+  uint32_t socket = xgmi + (num_gpus_ * num_gpus_);
+  uint32_t local = socket + (num_cpus_ * num_cpus_);
+
+  links.clear();
+  if (src_idx == dst_idx) {
+    links.push_back(local + src_idx);
+    return;
+  }
+
+  // Peer Gpus use XGMI if the model has it
+  bool src_gpu = (IsCpu(src_idx) == false);
+  bool dst_gpu = (IsCpu(dst_idx) == false);
+  if (src_gpu && dst_gpu && (xgmi_bw_ != 0)) {
+    links.push_back(xgmi + ((src_idx - num_cpus_) * num_gpus_) +
+                    (dst_idx - num_cpus_));
+    return;
+  }
+
+  // Otherwise go up the PCIe link of source, across sockets
+  // if needed and down the PCIe link of destination
+  if (src_gpu) {
+    links.push_back(gpu_up + (src_idx - num_cpus_));
+  }
+  uint32_t src_node = GetNode(src_idx);
+  uint32_t dst_node = GetNode(dst_idx);
+  if (src_node != dst_node) {
+    links.push_back(socket + (src_node * num_cpus_) + dst_node);
+  }
+  if (dst_gpu) {
+    links.push_back(gpu_down + (dst_idx - num_cpus_));
+  }
+}
+
+double SimBackend::GetLinkBandwidth(uint32_t link_idx) const {
+
+  uint32_t xgmi = 2 * num_gpus_;
+  uint32_t socket = xgmi + (num_gpus_ * num_gpus_);
+  uint32_t local = socket + (num_cpus_ * num_cpus_);
+  if (link_idx < xgmi) {
+    return pcie_bw_;
+  }
+  if (link_idx < socket) {
+    return xgmi_bw_;
+  }
+  if (link_idx < local) {
+    return socket_bw_;
+  }
+  return local_bw_;
+}
+
+void SimBackend::GetLinkInfo(uint32_t agent_idx, uint32_t pool_owner,
+                             vector<hsa_amd_memory_pool_link_info_t>& hops) const {
+
+  hops.clear();
+  if (agent_idx == pool_owner) {
+    return;
+  }
+
+  uint32_t xgmi = 2 * num_gpus_;
+  uint32_t socket = xgmi + (num_gpus_ * num_gpus_);
+  vector<uint32_t> links;
+  GetPathLinks(agent_idx, pool_owner, links);
+  for (uint32_t idx = 0; idx < links.size(); idx++) {
+    hsa_amd_memory_pool_link_info_t hop;
+    memset(&hop, 0, sizeof(hop));
+    double bw = GetLinkBandwidth(links[idx]);
+    hop.max_bandwidth = uint32_t(bw * 1000);
+    hop.min_bandwidth = hop.max_bandwidth;
+    hop.min_latency = latency_;
+    hop.max_latency = latency_;
+    if (links[idx] < xgmi) {
+      hop.link_type = HSA_AMD_LINK_INFO_TYPE_PCIE;
+      hop.numa_distance = SIM_PCIE_DISTANCE;
+    } else if (links[idx] < socket) {
+      hop.link_type = HSA_AMD_LINK_INFO_TYPE_XGMI;
+      hop.numa_distance = SIM_XGMI_DISTANCE;
+    } else {
+      hop.link_type = HSA_AMD_LINK_INFO_TYPE_HYPERTRANSPORT;
+      hop.numa_distance = SIM_SOCKET_DISTANCE;
+    }
+    hops.push_back(hop);
+  }
+}
+
+hsa_status_t SimBackend::SystemGetInfo(hsa_system_info_t attribute, void* value) {
+  switch (attribute) {
+    case HSA_SYSTEM_INFO_TIMESTAMP:
+      *(uint64_t*)value = Now();
+      return HSA_STATUS_SUCCESS;
+    case HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY:
+      *(uint64_t*)value = 1000000000;
+      return HSA_STATUS_SUCCESS;
+    default:
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+}
+
+hsa_status_t SimBackend::IterateAgents(hsa_status_t (*callback)(hsa_agent_t agent, void* data),
+                                       void* data) {
+  for (uint32_t idx = 0; idx < NumAgents(); idx++) {
+    hsa_agent_t agent;
+    agent.handle = idx + 1;
+    hsa_status_t status = callback(agent, data);
+    if (status != HSA_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::AgentGetInfo(hsa_agent_t agent,
+                                      hsa_agent_info_t attribute, void* value) {
+
+  uint32_t agent_idx = GetAgentIdx(agent);
+  if (agent_idx >= NumAgents()) {
+    return HSA_STATUS_ERROR_INVALID_AGENT;
+  }
+
+  // Bus id is not reported as simulated devices have no sysfs entries
+  switch ((uint32_t)attribute) {
+    case HSA_AGENT_INFO_NAME:
+    case HSA_AMD_AGENT_INFO_PRODUCT_NAME: {
+      std::stringstream name;
+      if (IsCpu(agent_idx)) {
+        name << "Simulated Cpu " << agent_idx;
+      } else {
+        name << "Simulated Gpu " << (agent_idx - num_cpus_);
+      }
+      memset(value, 0, 64);
+      strncpy((char*)value, name.str().c_str(), 63);
+      return HSA_STATUS_SUCCESS;
+    }
+    case HSA_AGENT_INFO_DEVICE:
+      *(hsa_device_type_t*)value = IsCpu(agent_idx) ? HSA_DEVICE_TYPE_CPU :
+                                                      HSA_DEVICE_TYPE_GPU;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AGENT_INFO_NODE:
+      *(uint32_t*)value = agent_idx;
+      return HSA_STATUS_SUCCESS;
+    default:
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+}
+
+hsa_status_t SimBackend::IterateMemoryPools(hsa_agent_t agent,
+                                            hsa_status_t (*callback)(hsa_amd_memory_pool_t pool,
+                                                                     void* data),
+                                            void* data) {
+
+  uint32_t agent_idx = GetAgentIdx(agent);
+  if (agent_idx >= NumAgents()) {
+    return HSA_STATUS_ERROR_INVALID_AGENT;
+  }
+
+  uint32_t num_pools = (2 * num_cpus_) + num_gpus_;
+  for (uint32_t idx = 0; idx < num_pools; idx++) {
+    if (GetPoolOwner(idx) != agent_idx) {
+      continue;
+    }
+    hsa_amd_memory_pool_t pool;
+    pool.handle = idx + 1;
+    hsa_status_t status = callback(pool, data);
+    if (status != HSA_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::PoolGetInfo(hsa_amd_memory_pool_t pool,
+                                     hsa_amd_memory_pool_info_t attribute, void* value) {
+
+  uint32_t pool_idx = GetPoolIdx(pool);
+  if (pool_idx >= ((2 * num_cpus_) + num_gpus_)) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+
+  // First pool of a Cpu device is fine-grained and used for kernargs
+  bool is_cpu = IsCpu(GetPoolOwner(pool_idx));
+  bool is_fine = is_cpu && ((pool_idx % 2) == 0);
+  switch (attribute) {
+    case HSA_AMD_MEMORY_POOL_INFO_SEGMENT:
+      *(hsa_amd_segment_t*)value = HSA_AMD_SEGMENT_GLOBAL;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_MEMORY_POOL_INFO_GLOBAL_FLAGS:
+      *(uint32_t*)value = is_fine ? (HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_KERNARG_INIT |
+                                     HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_FINE_GRAINED) :
+                                    HSA_AMD_MEMORY_POOL_GLOBAL_FLAG_COARSE_GRAINED;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_MEMORY_POOL_INFO_SIZE:
+      *(size_t*)value = is_cpu ? SIM_HOST_MEM_SIZE : gpu_mem_;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALLOWED:
+      *(bool*)value = true;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_GRANULE:
+    case HSA_AMD_MEMORY_POOL_INFO_RUNTIME_ALLOC_ALIGNMENT:
+      *(size_t*)value = SIM_ALLOC_ALIGNMENT;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_MEMORY_POOL_INFO_ACCESSIBLE_BY_ALL:
+      *(bool*)value = is_fine;
+      return HSA_STATUS_SUCCESS;
+    default:
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+}
+
+hsa_status_t SimBackend::AgentPoolGetInfo(hsa_agent_t agent, hsa_amd_memory_pool_t pool,
+                                          hsa_amd_agent_memory_pool_info_t attribute,
+                                          void* value) {
+
+  uint32_t agent_idx = GetAgentIdx(agent);
+  uint32_t pool_idx = GetPoolIdx(pool);
+  if ((agent_idx >= NumAgents()) ||
+      (pool_idx >= ((2 * num_cpus_) + num_gpus_))) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+
+  // Cpu devices cannot access memory of Gpus, all other pools
+  // except those of owner and fine-grained ones need a grant
+  uint32_t owner = GetPoolOwner(pool_idx);
+  hsa_amd_memory_pool_access_t access = HSA_AMD_MEMORY_POOL_ACCESS_DISALLOWED_BY_DEFAULT;
+  if ((IsCpu(agent_idx)) && (IsCpu(owner) == false)) {
+    access = HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED;
+  } else if ((agent_idx == owner) || (IsCpu(agent_idx)) ||
+             ((IsCpu(owner)) && ((pool_idx % 2) == 0))) {
+    access = HSA_AMD_MEMORY_POOL_ACCESS_ALLOWED_BY_DEFAULT;
+  }
+
+  vector<hsa_amd_memory_pool_link_info_t> hops;
+  if (access != HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+    GetLinkInfo(agent_idx, owner, hops);
+  }
+
+  switch (attribute) {
+    case HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS:
+      *(hsa_amd_memory_pool_access_t*)value = access;
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_AGENT_MEMORY_POOL_INFO_NUM_LINK_HOPS:
+      *(uint32_t*)value = hops.size();
+      return HSA_STATUS_SUCCESS;
+    case HSA_AMD_AGENT_MEMORY_POOL_INFO_LINK_INFO:
+      if (hops.size() != 0) {
+        memcpy(value, &hops[0], hops.size() * sizeof(hops[0]));
+      }
+      return HSA_STATUS_SUCCESS;
+    default:
+      return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+}
+
+hsa_status_t SimBackend::PoolAllocate(hsa_amd_memory_pool_t pool, size_t size,
+                                      uint32_t flags, void** ptr) {
+
+  if (GetPoolIdx(pool) >= ((2 * num_cpus_) + num_gpus_)) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+  if (posix_memalign(ptr, SIM_ALLOC_ALIGNMENT, size) != 0) {
+    return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+  }
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::PoolFree(void* ptr) {
+  free(ptr);
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::AllowAccess(uint32_t num_agents, const hsa_agent_t* agents,
+                                     const uint32_t* flags, const void* ptr) {
+  return HSA_STATUS_SUCCESS;
+}
+
+// @brief: System memory of the simulator is accessible to every
+// agent, so locked buffers are used as they are
+hsa_status_t SimBackend::MemoryLock(void* host_ptr, size_t size,
+                                    hsa_agent_t* agents, int num_agents,
+                                    void** agent_ptr) {
+  if ((host_ptr == NULL) || (agent_ptr == NULL)) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+  *agent_ptr = host_ptr;
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::MemoryUnlock(void* host_ptr) {
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::AsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                   const void* src, hsa_agent_t src_agent,
+                                   size_t size, uint32_t num_dep_signals,
+                                   const hsa_signal_t* dep_signals,
+                                   hsa_signal_t completion_signal) {
+
+  uint32_t src_idx = GetAgentIdx(src_agent);
+  uint32_t dst_idx = GetAgentIdx(dst_agent);
+  if ((src_idx >= NumAgents()) || (dst_idx >= NumAgents()) ||
+      (completion_signal.handle == 0)) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+  if (thread_.joinable() == false) {
+    return HSA_STATUS_ERROR_NOT_INITIALIZED;
+  }
+
+  SimCopy copy;
+  copy.dst_ = dst;
+  copy.src_ = src;
+  copy.size_ = size;
+  GetPathLinks(src_idx, dst_idx, copy.links_);
+  copy.deps_.assign(dep_signals, dep_signals + num_dep_signals);
+  copy.signal_ = reinterpret_cast<SimSignal*>(completion_signal.handle);
+  copy.submit_ = Now();
+  copy.end_ = 0;
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    waiting_.push_back(copy);
+  }
+  cond_.notify_all();
+  return HSA_STATUS_SUCCESS;
+}
+
+bool SimBackend::DepsSatisfied(const SimCopy& copy) const {
+  for (uint32_t idx = 0; idx < copy.deps_.size(); idx++) {
+    SimSignal* dep = reinterpret_cast<SimSignal*>(copy.deps_[idx].handle);
+    if (dep->value_.load() > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// @brief: Move the data of a copy and schedule its completion. The copy
+// starts once it is submitted, its dependencies have completed and every
+// link of its path is free, regardless of when the data is actually moved
+void SimBackend::StartCopy(SimCopy& copy) {
+
+  memcpy(copy.dst_, copy.src_, copy.size_);
+
+  uint64_t start = copy.submit_;
+  for (uint32_t idx = 0; idx < copy.deps_.size(); idx++) {
+    SimSignal* dep = reinterpret_cast<SimSignal*>(copy.deps_[idx].handle);
+    start = std::max(start, dep->end_);
+  }
+  double bw = 0;
+  for (uint32_t idx = 0; idx < copy.links_.size(); idx++) {
+    start = std::max(start, link_busy_[copy.links_[idx]]);
+    double link_bw = GetLinkBandwidth(copy.links_[idx]);
+    bw = ((bw == 0) || (link_bw < bw)) ? link_bw : bw;
+  }
+
+  // Bandwidth in GB/s equals bytes per nanosecond
+  copy.end_ = start + latency_ + uint64_t(copy.size_ / bw);
+  for (uint32_t idx = 0; idx < copy.links_.size(); idx++) {
+    link_busy_[copy.links_[idx]] = copy.end_;
+  }
+  copy.signal_->start_ = start;
+  copy.signal_->end_ = copy.end_;
+}
+
+void SimBackend::CopyThread() {
+
+  std::unique_lock<std::mutex> guard(lock_);
+  while (exit_ == false) {
+
+    // Start copies whose dependencies are satisfied
+    for (std::deque<SimCopy>::iterator it = waiting_.begin(); it != waiting_.end(); ) {
+      if (DepsSatisfied(*it)) {
+        StartCopy(*it);
+        running_.push_back(*it);
+        it = waiting_.erase(it);
+      } else {
+        it++;
+      }
+    }
+
+    // Complete the copy that ends first if its time has come
+    if (running_.empty()) {
+      cond_.wait(guard);
+      continue;
+    }
+    std::deque<SimCopy>::iterator first = running_.begin();
+    for (std::deque<SimCopy>::iterator it = running_.begin(); it != running_.end(); it++) {
+      if (it->end_ < first->end_) {
+        first = it;
+      }
+    }
+    uint64_t now = Now();
+    if ((sleep_) && (first->end_ > now)) {
+      cond_.wait_for(guard, std::chrono::nanoseconds(first->end_ - now));
+      continue;
+    }
+    first->signal_->value_--;
+    running_.erase(first);
+    done_.notify_all();
+  }
+}
+
+hsa_status_t SimBackend::SignalCreate(hsa_signal_value_t initial_value,
+                                      hsa_signal_t* signal) {
+  SimSignal* sim_signal = new SimSignal();
+  sim_signal->value_ = initial_value;
+  sim_signal->start_ = 0;
+  sim_signal->end_ = 0;
+  signal->handle = reinterpret_cast<uint64_t>(sim_signal);
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::SignalDestroy(hsa_signal_t signal) {
+  delete reinterpret_cast<SimSignal*>(signal.handle);
+  return HSA_STATUS_SUCCESS;
+}
+
+void SimBackend::SignalStore(hsa_signal_t signal, hsa_signal_value_t value) {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    reinterpret_cast<SimSignal*>(signal.handle)->value_ = value;
+  }
+  cond_.notify_all();
+}
+
+hsa_signal_value_t SimBackend::SignalWait(hsa_signal_t signal,
+                                          hsa_signal_condition_t condition,
+                                          hsa_signal_value_t compare_value,
+                                          hsa_wait_state_t wait_state) {
+
+  SimSignal* sim_signal = reinterpret_cast<SimSignal*>(signal.handle);
+  std::unique_lock<std::mutex> guard(lock_);
+  while (true) {
+    hsa_signal_value_t value = sim_signal->value_.load();
+    bool done = false;
+    switch (condition) {
+      case HSA_SIGNAL_CONDITION_EQ:  done = (value == compare_value); break;
+      case HSA_SIGNAL_CONDITION_NE:  done = (value != compare_value); break;
+      case HSA_SIGNAL_CONDITION_LT:  done = (value < compare_value);  break;
+      case HSA_SIGNAL_CONDITION_GTE: done = (value >= compare_value); break;
+    }
+    if (done) {
+      return value;
+    }
+    done_.wait(guard);
+  }
+}
+
+hsa_status_t SimBackend::ProfilingEnable(bool enable) {
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t SimBackend::GetAsyncCopyTime(hsa_signal_t signal,
+                                          hsa_amd_profiling_async_copy_time_t* time) {
+  SimSignal* sim_signal = reinterpret_cast<SimSignal*>(signal.handle);
+  time->start = sim_signal->start_;
+  time->end = sim_signal->end_;
+  return HSA_STATUS_SUCCESS;
+}
@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "host_buffer.hpp"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <fstream>
+
+// Encoding of size of huge pages in flags of mmap, older
+// headers of libc may not define them
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+// Size of pages of every kind in KB, zero if chosen by runtime
+static const uint32_t PAGE_SIZE_LIST[HOST_PAGE_KIND_COUNT] = {
+  0, 4, 2 * 1024, 1024 * 1024
+};
+
+static const char* PAGE_KIND_NAME_LIST[HOST_PAGE_KIND_COUNT] = {
+  "Pool", "4 KB", "2 MB THP", "1 GB"
+};
+
+static const char* SOURCE_MODE_NAME_LIST[HOST_SOURCE_MODE_COUNT] = {
+  "Pool", "Locked", "Staged"
+};
+
+HostBufferProvider::HostBufferProvider(Backend* backend) {
+  backend_ = backend;
+}
+
+HostBufferProvider::~HostBufferProvider() {
+
+  while (mapping_list_.empty() == false) {
+    Free((void*)mapping_list_.begin()->first);
+  }
+}
+
+uint32_t HostBufferProvider::GetPageKind(uint32_t page_size) {
+
+  for (uint32_t idx = 0; idx < HOST_PAGE_KIND_COUNT; idx++) {
+    if (PAGE_SIZE_LIST[idx] == page_size) {
+      return idx;
+    }
+  }
+  return HOST_PAGE_KIND_COUNT;
+}
+
+const char* HostBufferProvider::GetPageKindName(uint32_t page_kind) {
+  return (page_kind < HOST_PAGE_KIND_COUNT) ? PAGE_KIND_NAME_LIST[page_kind] : "Unknown";
+}
+
+const char* HostBufferProvider::GetSourceModeName(uint32_t source_mode) {
+  return (source_mode < HOST_SOURCE_MODE_COUNT) ? SOURCE_MODE_NAME_LIST[source_mode] : "Unknown";
+}
+
+// @brief: Advise the kernel on pages backing a mapping. Mappings
+// of 4 KB pages opt out of THP, which would otherwise back them
+// with 2 MB pages when THP is enabled always. A kernel built
+// without THP rejects the advice, its mappings are 4 KB anyway
+static bool AdvisePages(void* host_ptr, size_t map_size, uint32_t page_kind) {
+
+  if (page_kind == HOST_PAGE_4K) {
+    return ((madvise(host_ptr, map_size, MADV_NOHUGEPAGE) == 0) || (errno == EINVAL));
+  }
+  if (page_kind == HOST_PAGE_2M_THP) {
+    return (madvise(host_ptr, map_size, MADV_HUGEPAGE) == 0);
+  }
+  return true;
+}
+
+// @brief: Determine if the kernel takes advice on pages of a kind
+// by advising a mapping of one huge page that is never touched
+static bool IsAdviceAccepted(uint32_t page_kind) {
+
+  size_t map_size = (size_t)PAGE_SIZE_LIST[HOST_PAGE_2M_THP] * 1024;
+  void* host_ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (host_ptr == MAP_FAILED) {
+    return false;
+  }
+  bool accepted = AdvisePages(host_ptr, map_size, page_kind);
+  munmap(host_ptr, map_size);
+  return accepted;
+}
+
+// @brief: Transparent huge pages are available unless disabled,
+// while 1 GB pages must be reserved in hugetlbfs ahead of time.
+// Pages of 4 KB and THP also need the kernel to take advice
+bool HostBufferProvider::IsPageKindAvailable(uint32_t page_kind, size_t size,
+                                             const std::string& sysfs_root) {
+
+  if (page_kind == HOST_PAGE_4K) {
+    return IsAdviceAccepted(page_kind);
+  }
+
+  if (page_kind == HOST_PAGE_2M_THP) {
+    std::ifstream file((sysfs_root + "/kernel/mm/transparent_hugepage/enabled").c_str());
+    std::string mode;
+    if ((file.good() == false) || (!std::getline(file, mode))) {
+      return false;
+    }
+    if (mode.find("[never]") != std::string::npos) {
+      return false;
+    }
+    return IsAdviceAccepted(page_kind);
+  }
+
+  if (page_kind == HOST_PAGE_1G) {
+    std::ifstream file((sysfs_root +
+                        "/kernel/mm/hugepages/hugepages-1048576kB/free_hugepages").c_str());
+    size_t free_pages = 0;
+    if ((file.good() == false) || (!(file >> free_pages))) {
+      return false;
+    }
+    size_t page_size = (size_t)PAGE_SIZE_LIST[HOST_PAGE_1G] * 1024;
+    return ((free_pages * page_size) >= size);
+  }
+
+  return (page_kind < HOST_PAGE_KIND_COUNT);
+}
+
+hsa_status_t HostBufferProvider::Allocate(uint32_t page_kind,
+                                          hsa_amd_memory_pool_t pool,
+                                          size_t size, void** ptr) {
+
+  if (page_kind == HOST_PAGE_POOL) {
+    return backend_->PoolAllocate(pool, size, 0, ptr);
+  }
+  if (page_kind >= HOST_PAGE_KIND_COUNT) {
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+
+  // Mappings are rounded up to a whole number of pages. Huge
+  // pages of THP need a mapping aligned to their size, hence
+  // map one more page and trim the mapping to the alignment
+  size_t page_size = (size_t)PAGE_SIZE_LIST[page_kind] * 1024;
+  size_t map_size = ((size + page_size - 1) / page_size) * page_size;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (page_kind == HOST_PAGE_1G) {
+    flags |= MAP_HUGETLB | MAP_HUGE_1GB;
+  }
+  size_t pad_size = (page_kind == HOST_PAGE_2M_THP) ? page_size : 0;
+  char* base = (char*)mmap(NULL, map_size + pad_size, PROT_READ | PROT_WRITE,
+                           flags, -1, 0);
+  if (base == MAP_FAILED) {
+    return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+  }
+
+  char* host_ptr = base;
+  if (pad_size != 0) {
+    uintptr_t addr = (uintptr_t)base;
+    host_ptr = (char*)(((addr + page_size - 1) / page_size) * page_size);
+    size_t head = host_ptr - base;
+    if (head != 0) {
+      munmap(base, head);
+    }
+    if (pad_size != head) {
+      munmap(host_ptr + map_size, pad_size - head);
+    }
+  }
+
+  // Pages not of the kind requested would be reported under its
+  // name, hence fail rather than map pages of the default kind
+  if (AdvisePages(host_ptr, map_size, page_kind) == false) {
+    munmap(host_ptr, map_size);
+    return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+  }
+
+  // Fault in the pages from the calling thread, which places
+  // them on its NUMA node, before pinning them for devices
+  memset(host_ptr, 0, map_size);
+  void* agent_ptr = NULL;
+  hsa_status_t status = backend_->MemoryLock(host_ptr, map_size, NULL, 0, &agent_ptr);
+  if (status != HSA_STATUS_SUCCESS) {
+    munmap(host_ptr, map_size);
+    return status;
+  }
+
+  host_mapping_t mapping;
+  mapping.host_ptr_ = host_ptr;
+  mapping.map_size_ = map_size;
+  mapping_list_[agent_ptr] = mapping;
+  *ptr = agent_ptr;
+  return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t HostBufferProvider::Free(void* ptr) {
+
+  map<const void*, host_mapping_t>::iterator it = mapping_list_.find(ptr);
+  if (it == mapping_list_.end()) {
+    return backend_->PoolFree(ptr);
+  }
+
+  host_mapping_t mapping = it->second;
+  mapping_list_.erase(it);
+  hsa_status_t status = backend_->MemoryUnlock(mapping.host_ptr_);
+  munmap(mapping.host_ptr_, mapping.map_size_);
+  return status;
+}
+
+bool HostBufferProvider::IsLocked(const void* ptr) const {
+  return (mapping_list_.find(ptr) != mapping_list_.end());
+}
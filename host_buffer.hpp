@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef ROC_BANDWIDTH_TEST_HOST_BUFFER_HPP
+#define ROC_BANDWIDTH_TEST_HOST_BUFFER_HPP
+
+#include "backend.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+#include <string>
+
+using namespace std;
+
+// Pages backing buffers of system memory used as endpoints of
+// copies. Buffers other than those of pool are mapped by the test
+// and locked with Roc runtime so that devices can access them
+typedef enum Host_Page_Kind {
+
+  HOST_PAGE_POOL = 0,
+  HOST_PAGE_4K = 1,
+  HOST_PAGE_2M_THP = 2,
+  HOST_PAGE_1G = 3,
+  HOST_PAGE_KIND_COUNT = 4,
+
+} Host_Page_Kind;
+
+// Ways an application may source copies to a device from system
+// memory: a buffer of pool, a buffer of malloc locked around every
+// copy, or a buffer of malloc staged through a locked bounce buffer
+typedef enum Host_Source_Mode {
+
+  HOST_SOURCE_POOL = 0,
+  HOST_SOURCE_LOCKED = 1,
+  HOST_SOURCE_STAGED = 2,
+  HOST_SOURCE_MODE_COUNT = 3,
+
+} Host_Source_Mode;
+
+// @brief: Provides buffers of system memory backed by pages of
+// a given kind. Buffers of pool are allocated by Roc runtime
+// from the system memory pool, with pages of its choice
+class HostBufferProvider {
+
+ public:
+
+  explicit HostBufferProvider(Backend* backend);
+  ~HostBufferProvider();
+
+  // @brief: Allocate a buffer backed by pages of a kind. Pointer
+  // returned is the one devices should use to access the buffer
+  hsa_status_t Allocate(uint32_t page_kind, hsa_amd_memory_pool_t pool,
+                        size_t size, void** ptr);
+
+  // @brief: Free a buffer, which may also be one allocated
+  // directly from a memory pool
+  hsa_status_t Free(void* ptr);
+
+  // @brief: Determine if a buffer is locked by the provider, in
+  // which case it is accessible to every agent of system
+  bool IsLocked(const void* ptr) const;
+
+  // @brief: Map size of page in KB to its kind and back
+  static uint32_t GetPageKind(uint32_t page_size);
+  static const char* GetPageKindName(uint32_t page_kind);
+  static const char* GetSourceModeName(uint32_t source_mode);
+
+  // @brief: Determine if the kernel can back a buffer of size
+  // with pages of a kind, as reported by sysfs
+  static bool IsPageKindAvailable(uint32_t page_kind, size_t size,
+                                  const std::string& sysfs_root);
+
+ private:
+
+  // @brief: Mapping of a buffer locked by the provider
+  typedef struct host_mapping {
+    void* host_ptr_;
+    size_t map_size_;
+  } host_mapping_t;
+
+  Backend* backend_;
+
+  // Buffers locked by the provider, indexed by pointer of agents
+  map<const void*, host_mapping_t> mapping_list_;
+};
+
+#endif  // ROC_BANDWIDTH_TEST_HOST_BUFFER_HPP
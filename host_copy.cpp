@@ -0,0 +1,787 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "host_copy.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HOST_COPY_X86 1
+#include <immintrin.h>
+#endif
+
+// Slices are rounded up to a multiple of a cache line so that
+// no two threads write to the same line
+static const size_t SLICE_ALIGN = 64;
+
+static void CopyMemcpy(void* dst, const void* src, size_t size) {
+  memcpy(dst, src, size);
+}
+
+// @brief: Run a STREAM operation over elements [first, last)
+static inline void StreamScalar(const HostCopyEngine::host_stream_job_t& job,
+                                size_t first, size_t last) {
+
+  double* a = job.a_;
+  double* b = job.b_;
+  double* c = job.c_;
+  double scalar = job.scalar_;
+  switch (job.op_) {
+    case HOST_STREAM_COPY:
+      for (size_t idx = first; idx < last; idx++) c[idx] = a[idx];
+      break;
+    case HOST_STREAM_SCALE:
+      for (size_t idx = first; idx < last; idx++) b[idx] = scalar * c[idx];
+      break;
+    case HOST_STREAM_ADD:
+      for (size_t idx = first; idx < last; idx++) c[idx] = a[idx] + b[idx];
+      break;
+    case HOST_STREAM_TRIAD:
+      for (size_t idx = first; idx < last; idx++) a[idx] = b[idx] + scalar * c[idx];
+      break;
+  }
+}
+
+// @brief: Read or write elements [first, last), returns their
+// sum if read
+static inline double AccessScalar(const HostCopyEngine::host_access_job_t& job,
+                                  size_t first, size_t last) {
+
+  double sum = 0;
+  double* buf = job.buf_;
+  if (job.op_ == HOST_ACCESS_READ) {
+    for (size_t idx = first; idx < last; idx++) sum += buf[idx];
+  } else {
+    for (size_t idx = first; idx < last; idx++) buf[idx] = job.value_;
+  }
+  return sum;
+}
+
+// @brief: Offset of first byte that differs, size if none does
+static inline size_t CompareScalar(const char* expected, const char* actual,
+                                   size_t size) {
+
+  for (size_t idx = 0; idx < size; idx++) {
+    if (expected[idx] != actual[idx]) {
+      return idx;
+    }
+  }
+  return size;
+}
+
+// @brief: Pattern is a sequence of 32-bit words, each a hash of
+// its index keyed by the seed. Words are independent of each other
+// so any slice of a buffer can be generated on its own
+static inline uint32_t PatternKey(uint64_t seed) {
+
+  seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+  seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+  return (uint32_t)(seed ^ (seed >> 31));
+}
+
+static inline uint32_t PatternWord(uint32_t key, size_t word_idx) {
+
+  uint32_t word = (uint32_t)word_idx ^ key;
+  word ^= word >> 16;
+  word *= 0x7FEB352Du;
+  word ^= word >> 15;
+  word *= 0x846CA68Bu;
+  word ^= word >> 16;
+  return word;
+}
+
+// @brief: Fill or check bytes [first, last) with the pattern,
+// returns offset of first byte that differs, last if none does
+static inline size_t PatternScalar(const HostCopyEngine::host_pattern_job_t& job,
+                                   size_t first, size_t last) {
+
+  uint8_t* buf = (uint8_t*)job.buf_;
+  uint32_t key = PatternKey(job.seed_);
+  for (size_t idx = first; idx < last; idx++) {
+    size_t offset = job.offset_ + idx;
+    uint8_t value = (uint8_t)(PatternWord(key, offset / 4) >> (8 * (offset % 4)));
+    if (job.op_ == HOST_PATTERN_FILL) {
+      buf[idx] = value;
+    } else if (buf[idx] != value) {
+      return idx;
+    }
+  }
+  return last;
+}
+
+// @brief: Hash of a block, folding 64-bit words with a multiply
+static inline uint64_t HashScalar(const char* buf, size_t size) {
+
+  uint64_t hash = 0xCBF29CE484222325ull;
+  size_t idx = 0;
+  for (; (idx + 8) <= size; idx += 8) {
+    uint64_t word;
+    memcpy(&word, buf + idx, 8);
+    hash = (hash ^ word) * 0x100000001B3ull;
+  }
+  for (; idx < size; idx++) {
+    hash = (hash ^ (uint8_t)buf[idx]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+#if defined(HOST_COPY_X86)
+
+static void CopyRepMovsb(void* dst, const void* src, size_t size) {
+  asm volatile("rep movsb"
+               : "+D"(dst), "+S"(src), "+c"(size)
+               :
+               : "memory");
+}
+
+// @brief: Vector kernels copy 64 bytes per iteration, after copying
+// leading bytes until destination is aligned to the vector width
+// and before copying the trailing bytes. Alignment is required by
+// non-temporal stores and avoids split stores for the others
+#define HOST_COPY_KERNEL(name, isa, width, vec_t, load, store, fence)   \
+__attribute__((target(isa)))                                             \
+static void name(void* dst, const void* src, size_t size) {              \
+  char* out = (char*)dst;                                                \
+  const char* in = (const char*)src;                                     \
+  size_t head = (width - ((uintptr_t)out & (width - 1))) & (width - 1);  \
+  head = (head < size) ? head : size;                                    \
+  memcpy(out, in, head);                                                 \
+  out += head;                                                           \
+  in += head;                                                            \
+  size -= head;                                                          \
+  for (; size >= 64; size -= 64, in += 64, out += 64) {                  \
+    for (uint32_t idx = 0; idx < 64; idx += width) {                     \
+      vec_t value = load((const vec_t*)(in + idx));                      \
+      store((vec_t*)(out + idx), value);                                 \
+    }                                                                    \
+  }                                                                      \
+  fence;                                                                 \
+  memcpy(out, in, size);                                                 \
+}
+
+HOST_COPY_KERNEL(CopySse2, "sse2", 16, __m128i,
+                 _mm_loadu_si128, _mm_store_si128, (void)0)
+HOST_COPY_KERNEL(CopySse2Nt, "sse2", 16, __m128i,
+                 _mm_loadu_si128, _mm_stream_si128, _mm_sfence())
+HOST_COPY_KERNEL(CopyAvx2, "avx2", 32, __m256i,
+                 _mm256_loadu_si256, _mm256_store_si256, (void)0)
+HOST_COPY_KERNEL(CopyAvx2Nt, "avx2", 32, __m256i,
+                 _mm256_loadu_si256, _mm256_stream_si256, _mm_sfence())
+HOST_COPY_KERNEL(CopyAvx512, "avx512f", 64, __m512i,
+                 _mm512_loadu_si512, _mm512_store_si512, (void)0)
+HOST_COPY_KERNEL(CopyAvx512Nt, "avx512f", 64, __m512i,
+                 _mm512_loadu_si512, _mm512_stream_si512, _mm_sfence())
+
+// @brief: STREAM kernels process a vector of doubles per iteration
+// and leave the trailing elements to the scalar kernel. Slices of
+// arrays are not aligned to the vector width, hence unaligned access
+#define HOST_STREAM_KERNEL(name, isa, width, vec_t, load, store, add, mul, set1) \
+__attribute__((target(isa)))                                                    \
+static void name(const HostCopyEngine::host_stream_job_t& job,                  \
+                 size_t first, size_t last) {                                   \
+  double* a = job.a_;                                                           \
+  double* b = job.b_;                                                           \
+  double* c = job.c_;                                                           \
+  vec_t scalar = set1(job.scalar_);                                             \
+  size_t idx = first;                                                           \
+  switch (job.op_) {                                                            \
+    case HOST_STREAM_COPY:                                                      \
+      for (; (idx + width) <= last; idx += width)                               \
+        store(c + idx, load(a + idx));                                          \
+      break;                                                                    \
+    case HOST_STREAM_SCALE:                                                     \
+      for (; (idx + width) <= last; idx += width)                               \
+        store(b + idx, mul(scalar, load(c + idx)));                             \
+      break;                                                                    \
+    case HOST_STREAM_ADD:                                                       \
+      for (; (idx + width) <= last; idx += width)                               \
+        store(c + idx, add(load(a + idx), load(b + idx)));                      \
+      break;                                                                    \
+    case HOST_STREAM_TRIAD:                                                     \
+      for (; (idx + width) <= last; idx += width)                               \
+        store(a + idx, add(load(b + idx), mul(scalar, load(c + idx))));         \
+      break;                                                                    \
+  }                                                                             \
+  StreamScalar(job, idx, last);                                                 \
+}
+
+HOST_STREAM_KERNEL(StreamSse2, "sse2", 2, __m128d, _mm_loadu_pd,
+                   _mm_storeu_pd, _mm_add_pd, _mm_mul_pd, _mm_set1_pd)
+HOST_STREAM_KERNEL(StreamAvx2, "avx2", 4, __m256d, _mm256_loadu_pd,
+                   _mm256_storeu_pd, _mm256_add_pd, _mm256_mul_pd, _mm256_set1_pd)
+HOST_STREAM_KERNEL(StreamAvx512, "avx512f", 8, __m512d, _mm512_loadu_pd,
+                   _mm512_storeu_pd, _mm512_add_pd, _mm512_mul_pd, _mm512_set1_pd)
+
+// @brief: Access kernels read or write four vectors of doubles per
+// iteration. Reads sum into independent vectors so that additions
+// do not serialize on a single register
+#define HOST_ACCESS_KERNEL(name, isa, width, vec_t, load, store, add, set1, zero) \
+__attribute__((target(isa)))                                                     \
+static double name(const HostCopyEngine::host_access_job_t& job,                 \
+                   size_t first, size_t last) {                                  \
+  double* buf = job.buf_;                                                        \
+  size_t idx = first;                                                            \
+  double sum = 0;                                                                \
+  if (job.op_ == HOST_ACCESS_READ) {                                             \
+    vec_t sum_list[4] = { zero(), zero(), zero(), zero() };                      \
+    for (; (idx + (4 * width)) <= last; idx += (4 * width)) {                    \
+      for (uint32_t vec = 0; vec < 4; vec++) {                                   \
+        sum_list[vec] = add(sum_list[vec], load(buf + idx + (vec * width)));     \
+      }                                                                          \
+    }                                                                            \
+    double lane_list[width];                                                     \
+    for (uint32_t vec = 0; vec < 4; vec++) {                                     \
+      store(lane_list, sum_list[vec]);                                           \
+      for (uint32_t lane = 0; lane < width; lane++) {                            \
+        sum += lane_list[lane];                                                  \
+      }                                                                          \
+    }                                                                            \
+  } else {                                                                       \
+    vec_t value = set1(job.value_);                                              \
+    for (; (idx + (4 * width)) <= last; idx += (4 * width)) {                    \
+      for (uint32_t vec = 0; vec < 4; vec++) {                                   \
+        store(buf + idx + (vec * width), value);                                 \
+      }                                                                          \
+    }                                                                            \
+  }                                                                              \
+  return sum + AccessScalar(job, idx, last);                                     \
+}
+
+HOST_ACCESS_KERNEL(AccessSse2, "sse2", 2, __m128d, _mm_loadu_pd,
+                   _mm_storeu_pd, _mm_add_pd, _mm_set1_pd, _mm_setzero_pd)
+HOST_ACCESS_KERNEL(AccessAvx2, "avx2", 4, __m256d, _mm256_loadu_pd,
+                   _mm256_storeu_pd, _mm256_add_pd, _mm256_set1_pd, _mm256_setzero_pd)
+HOST_ACCESS_KERNEL(AccessAvx512, "avx512f", 8, __m512d, _mm512_loadu_pd,
+                   _mm512_storeu_pd, _mm512_add_pd, _mm512_set1_pd, _mm512_setzero_pd)
+
+// @brief: Compare kernels check 64 bytes per iteration, combining
+// the comparison of every vector into one mask. Block holding the
+// first mismatch is scanned byte by byte to locate it
+#define HOST_COMPARE_KERNEL(name, isa, width, vec_t, load, cmpeq, and_op, movemask, all_ones) \
+__attribute__((target(isa)))                                                           \
+static size_t name(const char* expected, const char* actual, size_t size) {            \
+  size_t idx = 0;                                                                      \
+  for (; (idx + 64) <= size; idx += 64) {                                              \
+    vec_t equal = cmpeq(load((const vec_t*)(expected + idx)),                          \
+                        load((const vec_t*)(actual + idx)));                           \
+    for (uint32_t vec = width; vec < 64; vec += width) {                               \
+      equal = and_op(equal, cmpeq(load((const vec_t*)(expected + idx + vec)),          \
+                                  load((const vec_t*)(actual + idx + vec))));          \
+    }                                                                                  \
+    if ((uint32_t)movemask(equal) != all_ones) {                                       \
+      break;                                                                           \
+    }                                                                                  \
+  }                                                                                    \
+  return idx + CompareScalar(expected + idx, actual + idx, size - idx);                \
+}
+
+HOST_COMPARE_KERNEL(CompareSse2, "sse2", 16, __m128i, _mm_loadu_si128,
+                    _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8, 0xFFFFu)
+HOST_COMPARE_KERNEL(CompareAvx2, "avx2", 32, __m256i, _mm256_loadu_si256,
+                    _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8, 0xFFFFFFFFu)
+
+__attribute__((target("avx2")))
+static inline __m256i PatternIotaAvx2() {
+  return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+}
+
+__attribute__((target("avx2")))
+static inline bool PatternEqualAvx2(__m256i expected, __m256i actual) {
+  return ((uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(expected, actual)) ==
+          0xFFFFFFFFu);
+}
+
+// Shift with all lanes enabled, as unmasked shift of some compilers
+// passes an undefined vector which -Wmaybe-uninitialized reports
+#define PatternSrliAvx512(value, count)                                  \
+  _mm512_maskz_srli_epi32((__mmask16)0xFFFF, value, count)
+
+__attribute__((target("avx512f")))
+static inline __m512i PatternIotaAvx512() {
+  return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+}
+
+__attribute__((target("avx512f")))
+static inline bool PatternEqualAvx512(__m512i expected, __m512i actual) {
+  return (_mm512_cmpeq_epi32_mask(expected, actual) == 0xFFFF);
+}
+
+// @brief: Pattern kernels hash one vector of word indices per
+// iteration, which is stored or compared against the buffer. Slices
+// start at a word boundary, trailing bytes and buffers starting within
+// a word of the pattern are handled by scalar code.
+// Words are stored little endian, matching the scalar byte order
+#define HOST_PATTERN_KERNEL(name, isa, width, vec_t, load, store, set1, iota,     \
+                            add, xor_op, srli, mullo, equal)                      \
+__attribute__((target(isa)))                                                      \
+static size_t name(const HostCopyEngine::host_pattern_job_t& job,                 \
+                   size_t first, size_t last) {                                   \
+  if ((job.offset_ % 4) != 0) {                                                   \
+    return PatternScalar(job, first, last);                                       \
+  }                                                                               \
+  char* buf = (char*)job.buf_;                                                    \
+  vec_t key = set1((int)PatternKey(job.seed_));                                   \
+  vec_t mul_0 = set1((int)0x7FEB352Du);                                           \
+  vec_t mul_1 = set1((int)0x846CA68Bu);                                           \
+  vec_t step = set1(width);                                                       \
+  vec_t index = add(iota(), set1((int)(uint32_t)((job.offset_ + first) / 4)));    \
+  size_t idx = first;                                                             \
+  for (; (idx + (4 * width)) <= last; idx += (4 * width)) {                       \
+    vec_t word = xor_op(index, key);                                              \
+    word = mullo(xor_op(word, srli(word, 16)), mul_0);                            \
+    word = mullo(xor_op(word, srli(word, 15)), mul_1);                            \
+    word = xor_op(word, srli(word, 16));                                          \
+    if (job.op_ == HOST_PATTERN_FILL) {                                           \
+      store((vec_t*)(buf + idx), word);                                           \
+    } else if (equal(word, load((const vec_t*)(buf + idx))) == false) {           \
+      break;                                                                      \
+    }                                                                             \
+    index = add(index, step);                                                     \
+  }                                                                               \
+  return PatternScalar(job, idx, last);                                           \
+}
+
+HOST_PATTERN_KERNEL(PatternAvx2, "avx2", 8, __m256i, _mm256_loadu_si256,
+                    _mm256_storeu_si256, _mm256_set1_epi32, PatternIotaAvx2,
+                    _mm256_add_epi32, _mm256_xor_si256, _mm256_srli_epi32,
+                    _mm256_mullo_epi32, PatternEqualAvx2)
+HOST_PATTERN_KERNEL(PatternAvx512, "avx512f", 16, __m512i, _mm512_loadu_si512,
+                    _mm512_storeu_si512, _mm512_set1_epi32, PatternIotaAvx512,
+                    _mm512_add_epi32, _mm512_xor_si512, PatternSrliAvx512,
+                    _mm512_mullo_epi32, PatternEqualAvx512)
+
+// @brief: Hash of a block as two CRC32C of its even and odd words,
+// which are independent chains and hence overlap in the pipeline
+__attribute__((target("sse4.2")))
+static uint64_t HashCrc32c(const char* buf, size_t size) {
+
+  uint64_t crc_even = 0;
+  uint64_t crc_odd = 0xFFFFFFFFull;
+  size_t idx = 0;
+  for (; (idx + 16) <= size; idx += 16) {
+    uint64_t word_list[2];
+    memcpy(word_list, buf + idx, 16);
+    crc_even = _mm_crc32_u64(crc_even, word_list[0]);
+    crc_odd = _mm_crc32_u64(crc_odd, word_list[1]);
+  }
+  for (; idx < size; idx++) {
+    crc_even = _mm_crc32_u8((uint32_t)crc_even, (uint8_t)buf[idx]);
+  }
+  return ((crc_odd << 32) | (uint32_t)crc_even);
+}
+
+#endif
+
+HostCopyEngine::HostCopyEngine(uint32_t num_threads) {
+
+  num_threads_ = (num_threads == 0) ? 1 : num_threads;
+  SetKernel(GetBestKernel());
+  job_list_ = NULL;
+  num_jobs_ = 0;
+  stream_job_ = NULL;
+  access_job_ = NULL;
+  compare_job_ = NULL;
+  pattern_job_ = NULL;
+  hash_job_ = NULL;
+  partial_sum_.resize(num_threads_);
+  partial_mismatch_.resize(num_threads_);
+  generation_ = 0;
+  pending_ = 0;
+  exit_ = false;
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    threads_.push_back(std::thread(&HostCopyEngine::WorkerLoop, this, idx));
+  }
+}
+
+HostCopyEngine::~HostCopyEngine() {
+
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    exit_ = true;
+  }
+  start_.notify_all();
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    threads_[idx].join();
+  }
+}
+
+bool HostCopyEngine::Bind(const vector<uint32_t>& cpu_list) {
+
+  if (cpu_list.empty()) {
+    return false;
+  }
+
+  bool status = true;
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu_list[idx % cpu_list.size()], &cpu_set);
+    status &= (pthread_setaffinity_np(threads_[idx].native_handle(),
+                                      sizeof(cpu_set), &cpu_set) == 0);
+  }
+  return status;
+}
+
+void HostCopyEngine::Copy(const host_copy_job_t* job_list, uint32_t num_jobs) {
+  Publish(job_list, num_jobs, NULL, NULL, NULL, NULL, NULL);
+}
+
+void HostCopyEngine::Stream(const host_stream_job_t& job) {
+  Publish(NULL, 0, &job, NULL, NULL, NULL, NULL);
+}
+
+void HostCopyEngine::Compare(host_compare_job_t& job) {
+
+  Publish(NULL, 0, NULL, NULL, &job, NULL, NULL);
+  job.mismatch_ = job.size_;
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    job.mismatch_ = std::min(job.mismatch_, partial_mismatch_[idx]);
+  }
+}
+
+void HostCopyEngine::Pattern(host_pattern_job_t& job) {
+
+  Publish(NULL, 0, NULL, NULL, NULL, &job, NULL);
+  job.mismatch_ = job.size_;
+  if (job.op_ == HOST_PATTERN_CHECK) {
+    for (uint32_t idx = 0; idx < num_threads_; idx++) {
+      job.mismatch_ = std::min(job.mismatch_, partial_mismatch_[idx]);
+    }
+  }
+}
+
+void HostCopyEngine::Hash(const host_hash_job_t& job) {
+  Publish(NULL, 0, NULL, NULL, NULL, NULL, &job);
+}
+
+uint8_t HostCopyEngine::GetPatternByte(uint64_t seed, size_t offset) {
+  return (uint8_t)(PatternWord(PatternKey(seed), offset / 4) >> (8 * (offset % 4)));
+}
+
+void HostCopyEngine::Access(host_access_job_t& job) {
+
+  Publish(NULL, 0, NULL, &job, NULL, NULL, NULL);
+  if (job.op_ == HOST_ACCESS_READ) {
+    job.value_ = 0;
+    for (uint32_t idx = 0; idx < num_threads_; idx++) {
+      job.value_ += partial_sum_[idx];
+    }
+  }
+}
+
+void HostCopyEngine::Publish(const host_copy_job_t* job_list, uint32_t num_jobs,
+                             const host_stream_job_t* stream_job,
+                             const host_access_job_t* access_job,
+                             const host_compare_job_t* compare_job,
+                             const host_pattern_job_t* pattern_job,
+                             const host_hash_job_t* hash_job) {
+
+  std::unique_lock<std::mutex> guard(lock_);
+  job_list_ = job_list;
+  num_jobs_ = num_jobs;
+  stream_job_ = stream_job;
+  access_job_ = access_job;
+  compare_job_ = compare_job;
+  pattern_job_ = pattern_job;
+  hash_job_ = hash_job;
+  pending_ = num_threads_;
+  generation_++;
+  start_.notify_all();
+  while (pending_ != 0) {
+    done_.wait(guard);
+  }
+}
+
+// @brief: Range of elements [first, last) of an array owned by a
+// thread. Ranges are multiples of align elements except the last one
+void HostCopyEngine::GetSlice(size_t count, size_t align, uint32_t thread_idx,
+                              size_t& first, size_t& last) const {
+
+  size_t slice = (count + num_threads_ - 1) / num_threads_;
+  slice = (slice + align - 1) & ~(align - 1);
+  first = std::min(slice * thread_idx, count);
+  last = std::min(first + slice, count);
+}
+
+void HostCopyEngine::WorkerLoop(uint32_t thread_idx) {
+
+  uint64_t generation = 0;
+  while (true) {
+
+    // Wait for a new list of copies or a STREAM operation
+    const host_copy_job_t* job_list;
+    const host_stream_job_t* stream_job;
+    const host_access_job_t* access_job;
+    const host_compare_job_t* compare_job;
+    const host_pattern_job_t* pattern_job;
+    const host_hash_job_t* hash_job;
+    copy_kernel_t kernel;
+    uint32_t num_jobs;
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      while ((exit_ == false) && (generation == generation_)) {
+        start_.wait(guard);
+      }
+      if (exit_) {
+        return;
+      }
+      generation = generation_;
+      job_list = job_list_;
+      kernel = kernel_;
+      num_jobs = num_jobs_;
+      stream_job = stream_job_;
+      access_job = access_job_;
+      compare_job = compare_job_;
+      pattern_job = pattern_job_;
+      hash_job = hash_job_;
+    }
+
+    // Copy slice of every buffer owned by this thread
+    size_t first;
+    size_t last;
+    for (uint32_t idx = 0; idx < num_jobs; idx++) {
+      GetSlice(job_list[idx].size_, SLICE_ALIGN, thread_idx, first, last);
+      kernel((char*)job_list[idx].dst_ + first,
+             (const char*)job_list[idx].src_ + first, last - first);
+    }
+
+    // Run STREAM operation on slice of arrays owned by this thread
+    if (stream_job != NULL) {
+      GetSlice(stream_job->count_, SLICE_ALIGN / sizeof(double),
+               thread_idx, first, last);
+      GetStreamFunc()(*stream_job, first, last);
+    }
+
+    // Read or write slice of buffer owned by this thread
+    if (access_job != NULL) {
+      GetSlice(access_job->count_, SLICE_ALIGN / sizeof(double),
+               thread_idx, first, last);
+      partial_sum_[thread_idx] = GetAccessFunc()(*access_job, first, last);
+    }
+
+    // Compare slice of buffers owned by this thread
+    if (compare_job != NULL) {
+      GetSlice(compare_job->size_, SLICE_ALIGN, thread_idx, first, last);
+      size_t offset = GetCompareFunc()((const char*)compare_job->expected_ + first,
+                                       (const char*)compare_job->actual_ + first,
+                                       last - first);
+      partial_mismatch_[thread_idx] = (offset == (last - first)) ?
+                                      compare_job->size_ : (first + offset);
+    }
+
+    // Fill or check slice of buffer owned by this thread
+    if (pattern_job != NULL) {
+      GetSlice(pattern_job->size_, SLICE_ALIGN, thread_idx, first, last);
+      size_t offset = GetPatternFunc()(*pattern_job, first, last);
+      partial_mismatch_[thread_idx] = (offset == last) ? pattern_job->size_ : offset;
+    }
+
+    // Hash every block of buffer assigned to this thread, blocks
+    // being assigned round robin across threads
+    if (hash_job != NULL) {
+      const char* buf = (const char*)hash_job->buf_;
+      size_t block_size = hash_job->block_size_;
+      size_t num_blocks = (hash_job->size_ + block_size - 1) / block_size;
+      for (size_t block = thread_idx; block < num_blocks; block += num_threads_) {
+        size_t offset = block * block_size;
+        hash_job->hash_list_[block] =
+            GetHashFunc()(buf + offset, std::min(block_size, hash_job->size_ - offset));
+      }
+    }
+
+    // Report completion of this thread
+    std::lock_guard<std::mutex> guard(lock_);
+    if (--pending_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
+
+void HostCopyEngine::SetKernel(uint32_t kernel_idx) {
+
+  std::lock_guard<std::mutex> guard(lock_);
+  kernel_idx_ = kernel_idx;
+  kernel_ = GetKernelFunc(kernel_idx);
+}
+
+HostCopyEngine::copy_kernel_t HostCopyEngine::GetKernelFunc(uint32_t kernel_idx) {
+
+#if defined(HOST_COPY_X86)
+  static const copy_kernel_t kernel_list[HOST_COPY_KERNEL_COUNT] = {
+    CopyMemcpy, CopyRepMovsb, CopySse2, CopySse2Nt,
+    CopyAvx2, CopyAvx2Nt, CopyAvx512, CopyAvx512Nt };
+  return (kernel_idx < HOST_COPY_KERNEL_COUNT) ? kernel_list[kernel_idx] : CopyMemcpy;
+#else
+  return CopyMemcpy;
+#endif
+}
+
+bool HostCopyEngine::IsKernelSupported(uint32_t kernel_idx) {
+
+#if defined(HOST_COPY_X86)
+  __builtin_cpu_init();
+  switch (kernel_idx) {
+    case HOST_COPY_MEMCPY:
+    case HOST_COPY_REP_MOVSB:
+      return true;
+    case HOST_COPY_SSE2:
+    case HOST_COPY_SSE2_NT:
+      return __builtin_cpu_supports("sse2");
+    case HOST_COPY_AVX2:
+    case HOST_COPY_AVX2_NT:
+      return __builtin_cpu_supports("avx2");
+    case HOST_COPY_AVX512:
+    case HOST_COPY_AVX512_NT:
+      return __builtin_cpu_supports("avx512f");
+    default:
+      return false;
+  }
+#else
+  return (kernel_idx == HOST_COPY_MEMCPY);
+#endif
+}
+
+// @brief: Widest non-temporal kernel supported by the Cpu. Copies
+// among Cpu devices are large and their destination is not read
+// back, so bypassing the cache gives the best throughput
+uint32_t HostCopyEngine::GetBestKernel() {
+
+  static const uint32_t kernel_list[] = {
+    HOST_COPY_AVX512_NT, HOST_COPY_AVX2_NT, HOST_COPY_SSE2_NT };
+  for (uint32_t idx = 0; idx < sizeof(kernel_list)/sizeof(uint32_t); idx++) {
+    if (IsKernelSupported(kernel_list[idx])) {
+      return kernel_list[idx];
+    }
+  }
+  return HOST_COPY_MEMCPY;
+}
+
+HostCopyEngine::stream_kernel_t HostCopyEngine::GetStreamFunc() {
+
+#if defined(HOST_COPY_X86)
+  if (IsKernelSupported(HOST_COPY_AVX512)) {
+    return StreamAvx512;
+  }
+  if (IsKernelSupported(HOST_COPY_AVX2)) {
+    return StreamAvx2;
+  }
+  if (IsKernelSupported(HOST_COPY_SSE2)) {
+    return StreamSse2;
+  }
+#endif
+  return StreamScalar;
+}
+
+HostCopyEngine::access_kernel_t HostCopyEngine::GetAccessFunc() {
+
+#if defined(HOST_COPY_X86)
+  if (IsKernelSupported(HOST_COPY_AVX512)) {
+    return AccessAvx512;
+  }
+  if (IsKernelSupported(HOST_COPY_AVX2)) {
+    return AccessAvx2;
+  }
+  if (IsKernelSupported(HOST_COPY_SSE2)) {
+    return AccessSse2;
+  }
+#endif
+  return AccessScalar;
+}
+
+HostCopyEngine::compare_kernel_t HostCopyEngine::GetCompareFunc() {
+
+#if defined(HOST_COPY_X86)
+  if (IsKernelSupported(HOST_COPY_AVX2)) {
+    return CompareAvx2;
+  }
+  if (IsKernelSupported(HOST_COPY_SSE2)) {
+    return CompareSse2;
+  }
+#endif
+  return CompareScalar;
+}
+
+HostCopyEngine::pattern_kernel_t HostCopyEngine::GetPatternFunc() {
+
+#if defined(HOST_COPY_X86)
+  if (IsKernelSupported(HOST_COPY_AVX512)) {
+    return PatternAvx512;
+  }
+  if (IsKernelSupported(HOST_COPY_AVX2)) {
+    return PatternAvx2;
+  }
+#endif
+  return PatternScalar;
+}
+
+HostCopyEngine::hash_kernel_t HostCopyEngine::GetHashFunc() {
+
+#if defined(HOST_COPY_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    return HashCrc32c;
+  }
+#endif
+  return HashScalar;
+}
+
+const char* HostCopyEngine::GetStreamOpName(uint32_t op) {
+
+  static const char* name_list[HOST_STREAM_OP_COUNT] = {
+    "Copy", "Scale", "Add", "Triad" };
+  return (op < HOST_STREAM_OP_COUNT) ? name_list[op] : "unknown";
+}
+
+uint32_t HostCopyEngine::GetStreamOpArrays(uint32_t op) {
+  return ((op == HOST_STREAM_ADD) || (op == HOST_STREAM_TRIAD)) ? 3 : 2;
+}
+
+const char* HostCopyEngine::GetKernelName(uint32_t kernel_idx) {
+
+  static const char* name_list[HOST_COPY_KERNEL_COUNT] = {
+    "memcpy", "rep-movsb", "sse2", "sse2-nt",
+    "avx2", "avx2-nt", "avx512", "avx512-nt" };
+  return (kernel_idx < HOST_COPY_KERNEL_COUNT) ? name_list[kernel_idx] : "unknown";
+}
@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_HOST_COPY_HPP
+#define ROC_BANDWIDTH_TEST_HOST_COPY_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Kernels available to copy buffers of system memory. Temporal
+// variants store through the cache while non-temporal ones stream
+// stores to memory, bypassing the cache
+typedef enum Host_Copy_Kernel {
+
+  HOST_COPY_MEMCPY = 0,
+  HOST_COPY_REP_MOVSB = 1,
+  HOST_COPY_SSE2 = 2,
+  HOST_COPY_SSE2_NT = 3,
+  HOST_COPY_AVX2 = 4,
+  HOST_COPY_AVX2_NT = 5,
+  HOST_COPY_AVX512 = 6,
+  HOST_COPY_AVX512_NT = 7,
+  HOST_COPY_KERNEL_COUNT = 8,
+
+} Host_Copy_Kernel;
+
+// Operations of STREAM benchmark, run over arrays of doubles
+//    Copy:  c = a
+//    Scale: b = scalar * c
+//    Add:   c = a + b
+//    Triad: a = b + scalar * c
+typedef enum Host_Stream_Op {
+
+  HOST_STREAM_COPY = 0,
+  HOST_STREAM_SCALE = 1,
+  HOST_STREAM_ADD = 2,
+  HOST_STREAM_TRIAD = 3,
+  HOST_STREAM_OP_COUNT = 4,
+
+} Host_Stream_Op;
+
+// Operations measuring load and store bandwidth of Cpu into a
+// buffer of doubles, by summing up or filling the buffer
+typedef enum Host_Access_Op {
+
+  HOST_ACCESS_READ = 0,
+  HOST_ACCESS_WRITE = 1,
+
+} Host_Access_Op;
+
+// Operations over a pattern derived from a seed, which either fill
+// a buffer with the pattern or check the buffer against it
+typedef enum Host_Pattern_Op {
+
+  HOST_PATTERN_FILL = 0,
+  HOST_PATTERN_CHECK = 1,
+
+} Host_Pattern_Op;
+
+// @brief: Copies buffers of system memory using a set of worker
+// threads. Every buffer is split into as many slices as there are
+// threads and each thread copies its own slice of every buffer
+class HostCopyEngine {
+
+ public:
+
+  // @brief: A buffer to copy
+  typedef struct host_copy_job {
+    void* dst_;
+    const void* src_;
+    size_t size_;
+  } host_copy_job_t;
+
+  // @brief: A STREAM operation over arrays of count_ doubles
+  typedef struct host_stream_job {
+    uint32_t op_;
+    double* a_;
+    double* b_;
+    double* c_;
+    double scalar_;
+    size_t count_;
+  } host_stream_job_t;
+
+  // @brief: A read or write of a buffer of count_ doubles. Write
+  // fills the buffer with value_ while read returns its sum in it
+  typedef struct host_access_job {
+    uint32_t op_;
+    double* buf_;
+    double value_;
+    size_t count_;
+  } host_access_job_t;
+
+  // @brief: A comparison of two buffers of size_ bytes, returns
+  // the offset of first byte that differs in mismatch_, which is
+  // size_ if buffers are equal
+  typedef struct host_compare_job {
+    const void* expected_;
+    const void* actual_;
+    size_t size_;
+    size_t mismatch_;
+  } host_compare_job_t;
+
+  // @brief: A fill or check of a buffer of size_ bytes with the
+  // pattern of seed_, starting at byte offset_ of the pattern. Check
+  // returns the offset of first byte in buffer that differs from the
+  // pattern in mismatch_, which is size_ if none
+  typedef struct host_pattern_job {
+    uint32_t op_;
+    void* buf_;
+    uint64_t seed_;
+    size_t offset_;
+    size_t size_;
+    size_t mismatch_;
+  } host_pattern_job_t;
+
+  // @brief: A hash of every block of block_size_ bytes of a buffer
+  // of size_ bytes, returned in hash_list_. Last block may be shorter
+  typedef struct host_hash_job {
+    const void* buf_;
+    size_t size_;
+    size_t block_size_;
+    uint64_t* hash_list_;
+  } host_hash_job_t;
+
+  // @brief: Launches the worker threads, which wait for copies
+  explicit HostCopyEngine(uint32_t num_threads);
+  ~HostCopyEngine();
+
+  uint32_t GetNumThreads() const { return num_threads_; }
+
+  // @brief: Pin worker threads to the list of cpus, one cpu per
+  // thread, reusing the cpus if there are more threads than cpus
+  bool Bind(const vector<uint32_t>& cpu_list);
+
+  // @brief: Copy a list of buffers concurrently, returns once
+  // all of them are copied
+  void Copy(const host_copy_job_t* job_list, uint32_t num_jobs);
+
+  // @brief: Run a STREAM operation, returns once it is done.
+  // Operations use the widest vectors supported by the Cpu
+  void Stream(const host_stream_job_t& job);
+
+  // @brief: Run a read or write of a buffer, returns once it is
+  // done. Operations use the widest vectors supported by the Cpu
+  void Access(host_access_job_t& job);
+
+  // @brief: Compare two buffers, returns once it is done. Buffers
+  // are compared using the widest vectors supported by the Cpu
+  void Compare(host_compare_job_t& job);
+
+  // @brief: Fill or check a buffer with a pattern, returns once it
+  // is done. Pattern is generated using the widest vectors supported
+  // by the Cpu, with no copy of it kept in memory
+  void Pattern(host_pattern_job_t& job);
+
+  // @brief: Byte of the pattern of a seed at an offset, which lets
+  // the expected value of a mismatching byte be reported
+  static uint8_t GetPatternByte(uint64_t seed, size_t offset);
+
+  // @brief: Hash blocks of a buffer, returns once it is done. Blocks
+  // are spread across threads and hashed using CRC32C instructions
+  // if supported by the Cpu. Hashes are comparable only among runs
+  // of the same machine
+  void Hash(const host_hash_job_t& job);
+
+  // @brief: Name of a STREAM operation and the number of arrays
+  // it reads or writes, which determines the bytes it moves
+  static const char* GetStreamOpName(uint32_t op);
+  static uint32_t GetStreamOpArrays(uint32_t op);
+
+  // @brief: Select the kernel run by workers, which must be
+  // supported by the Cpu. Engine starts with the best kernel
+  void SetKernel(uint32_t kernel_idx);
+  uint32_t GetKernel() const { return kernel_idx_; }
+
+  // @brief: Determine the kernels supported by the Cpu, as
+  // reported by cpuid, and the fastest one among them
+  static bool IsKernelSupported(uint32_t kernel_idx);
+  static uint32_t GetBestKernel();
+  static const char* GetKernelName(uint32_t kernel_idx);
+
+ private:
+
+  void WorkerLoop(uint32_t thread_idx);
+  void GetSlice(size_t count, size_t align, uint32_t thread_idx,
+                size_t& first, size_t& last) const;
+  void Publish(const host_copy_job_t* job_list, uint32_t num_jobs,
+               const host_stream_job_t* stream_job,
+               const host_access_job_t* access_job,
+               const host_compare_job_t* compare_job,
+               const host_pattern_job_t* pattern_job,
+               const host_hash_job_t* hash_job);
+
+  typedef void (*copy_kernel_t)(void* dst, const void* src, size_t size);
+  static copy_kernel_t GetKernelFunc(uint32_t kernel_idx);
+
+  typedef void (*stream_kernel_t)(const host_stream_job_t& job,
+                                  size_t first, size_t last);
+  static stream_kernel_t GetStreamFunc();
+
+  typedef double (*access_kernel_t)(const host_access_job_t& job,
+                                    size_t first, size_t last);
+  static access_kernel_t GetAccessFunc();
+
+  typedef size_t (*compare_kernel_t)(const char* expected, const char* actual,
+                                     size_t size);
+  static compare_kernel_t GetCompareFunc();
+
+  typedef size_t (*pattern_kernel_t)(const host_pattern_job_t& job,
+                                     size_t first, size_t last);
+  static pattern_kernel_t GetPatternFunc();
+
+  typedef uint64_t (*hash_kernel_t)(const char* buf, size_t size);
+  static hash_kernel_t GetHashFunc();
+
+  uint32_t kernel_idx_;
+  copy_kernel_t kernel_;
+  uint32_t num_threads_;
+  vector<std::thread> threads_;
+
+  // Copies or STREAM operation being run, published to workers
+  // under lock_. Workers pick up new work whenever generation_
+  // changes and report back by decrementing pending_
+  std::mutex lock_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const host_copy_job_t* job_list_;
+  uint32_t num_jobs_;
+  const host_stream_job_t* stream_job_;
+  const host_access_job_t* access_job_;
+  const host_compare_job_t* compare_job_;
+  const host_pattern_job_t* pattern_job_;
+  const host_hash_job_t* hash_job_;
+
+  // Sum of slice of buffer read by each worker
+  vector<double> partial_sum_;
+
+  // First mismatch in slice of buffers compared or checked by each worker
+  vector<size_t> partial_mismatch_;
+  uint64_t generation_;
+  uint32_t pending_;
+  bool exit_;
+};
+
+#endif  // ROC_BANDWIDTH_TEST_HOST_COPY_HPP
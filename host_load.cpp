@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "host_load.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+// Bytes streamed by a thread between checks of its rate and of a
+// request to stop
+static const size_t LOAD_CHUNK_SIZE = 256 * 1024;
+
+static double GetTime() {
+  std::chrono::duration<double> now =
+      std::chrono::steady_clock::now().time_since_epoch();
+  return now.count();
+}
+
+// @brief: Sum up words of a buffer, size being a multiple of words
+static uint64_t ReadChunk(const char* buf, size_t size) {
+
+  const uint64_t* word = reinterpret_cast<const uint64_t*>(buf);
+  size_t count = size / sizeof(uint64_t);
+  uint64_t sum = 0;
+  for (size_t idx = 0; idx < count; idx++) {
+    sum += word[idx];
+  }
+  return sum;
+}
+
+HostLoadGenerator::HostLoadGenerator(uint32_t num_threads) {
+
+  num_threads_ = (num_threads == 0) ? 1 : num_threads;
+  bytes_.resize(num_threads_);
+  stop_ = false;
+  sink_ = 0;
+  start_time_ = 0;
+}
+
+HostLoadGenerator::~HostLoadGenerator() {
+
+  if (threads_.empty() == false) {
+    Stop();
+  }
+}
+
+void HostLoadGenerator::Bind(const vector<uint32_t>& cpu_list) {
+  cpu_list_ = cpu_list;
+}
+
+const char* HostLoadGenerator::GetOpName(uint32_t op) {
+
+  static const char* name_list[HOST_LOAD_OP_COUNT] = { "read", "write", "copy" };
+  return (op < HOST_LOAD_OP_COUNT) ? name_list[op] : "unknown";
+}
+
+uint32_t HostLoadGenerator::GetOp(const char* name) {
+
+  for (uint32_t op = 0; op < HOST_LOAD_OP_COUNT; op++) {
+    if (strcmp(name, GetOpName(op)) == 0) {
+      return op;
+    }
+  }
+  return HOST_LOAD_OP_COUNT;
+}
+
+// @brief: Stream over buffers in chunks, wrapping around at their
+// end. A throttled thread sleeps whenever it is ahead of its share
+// of the rate, which keeps its load steady rather than bursty
+void HostLoadGenerator::WorkerLoop(uint32_t thread_idx, uint32_t op, char* src,
+                                   char* dst, size_t size, double rate) {
+
+  double thread_rate = rate / num_threads_;
+  uint64_t bytes = 0;
+  uint64_t sum = 0;
+  size_t offset = 0;
+  double start = GetTime();
+  while (stop_.load() == false) {
+
+    size_t chunk = std::min(LOAD_CHUNK_SIZE, size - offset);
+    switch (op) {
+      case HOST_LOAD_READ:
+        sum += ReadChunk(src + offset, chunk);
+        bytes += chunk;
+        break;
+      case HOST_LOAD_WRITE:
+        memset(src + offset, (int)bytes, chunk);
+        bytes += chunk;
+        break;
+      case HOST_LOAD_COPY:
+        memcpy(dst + offset, src + offset, chunk);
+        bytes += 2 * chunk;
+        break;
+    }
+    offset = ((offset + chunk) == size) ? 0 : (offset + chunk);
+
+    if (thread_rate > 0) {
+      double ahead = (bytes / thread_rate) - (GetTime() - start);
+      if (ahead > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(ahead));
+      }
+    }
+  }
+  bytes_[thread_idx] = bytes;
+  sink_ += sum;
+}
+
+void HostLoadGenerator::Start(uint32_t op, char** buf_list, size_t size, double rate) {
+
+  stop_ = false;
+  start_time_ = GetTime();
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    bytes_[idx] = 0;
+    threads_.push_back(std::thread(&HostLoadGenerator::WorkerLoop, this, idx, op,
+                                   buf_list[2 * idx], buf_list[(2 * idx) + 1],
+                                   size, rate));
+    if (cpu_list_.empty() == false) {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cpu_list_[idx % cpu_list_.size()], &cpu_set);
+      pthread_setaffinity_np(threads_[idx].native_handle(),
+                             sizeof(cpu_set), &cpu_set);
+    }
+  }
+}
+
+double HostLoadGenerator::Stop() {
+
+  stop_ = true;
+  for (uint32_t idx = 0; idx < threads_.size(); idx++) {
+    threads_[idx].join();
+  }
+  threads_.clear();
+
+  double elapsed = GetTime() - start_time_;
+  uint64_t bytes = 0;
+  for (uint32_t idx = 0; idx < num_threads_; idx++) {
+    bytes += bytes_[idx];
+  }
+  return (elapsed > 0) ? (bytes / elapsed) : 0;
+}
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROC_BANDWIDTH_TEST_HOST_LOAD_HPP
+#define ROC_BANDWIDTH_TEST_HOST_LOAD_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Streams run over buffers of system memory to load it. Read sums
+// up a buffer, write fills it and copy moves it into another buffer
+typedef enum Host_Load_Op {
+
+  HOST_LOAD_READ = 0,
+  HOST_LOAD_WRITE = 1,
+  HOST_LOAD_COPY = 2,
+  HOST_LOAD_OP_COUNT = 3,
+
+} Host_Load_Op;
+
+// @brief: Loads system memory in the background using a set of
+// threads, each streaming over buffers of its own until stopped.
+// Streams can be throttled to a target rate, to measure other
+// traffic under increasing pressure on system memory
+class HostLoadGenerator {
+
+ public:
+
+  // @brief: Sets up a generator of num_threads threads, which are
+  // launched only while the load runs
+  explicit HostLoadGenerator(uint32_t num_threads);
+  ~HostLoadGenerator();
+
+  uint32_t GetNumThreads() const { return num_threads_; }
+
+  // @brief: Pin threads to the list of cpus, one cpu per thread,
+  // reusing the cpus if there are more threads than cpus
+  void Bind(const vector<uint32_t>& cpu_list);
+
+  // @brief: Start streaming, thread i over buffers buf_list[2i] and,
+  // for copy, buf_list[2i + 1], each of size bytes. Rate is the bytes
+  // per second read and written by all threads, or 0 for no limit
+  void Start(uint32_t op, char** buf_list, size_t size, double rate);
+
+  // @brief: Stop streaming, returns the bytes per second read and
+  // written by all threads since start
+  double Stop();
+
+  // @brief: Name of an operation and its lookup from its name,
+  // which returns HOST_LOAD_OP_COUNT if the name is not known
+  static const char* GetOpName(uint32_t op);
+  static uint32_t GetOp(const char* name);
+
+ private:
+
+  void WorkerLoop(uint32_t thread_idx, uint32_t op, char* src, char* dst,
+                  size_t size, double rate);
+
+  uint32_t num_threads_;
+  vector<uint32_t> cpu_list_;
+  vector<std::thread> threads_;
+  std::atomic<bool> stop_;
+
+  // Bytes read and written by each thread since start, and the
+  // sum of buffers read, kept so reads are not optimized away
+  vector<uint64_t> bytes_;
+  std::atomic<uint64_t> sink_;
+  double start_time_;
+};
+
+#endif  // ROC_BANDWIDTH_TEST_HOST_LOAD_HPP
@@ -1,592 +1,1099 @@
-////////////////////////////////////////////////////////////////////////////////
-//
-// The University of Illinois/NCSA
-// Open Source License (NCSA)
-// 
-// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
-// 
-// Developed by:
-// 
-//                 AMD Research and AMD HSA Software Development
-// 
-//                 Advanced Micro Devices, Inc.
-// 
-//                 www.amd.com
-// 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to
-// deal with the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-// 
-//  - Redistributions of source code must retain the above copyright notice,
-//    this list of conditions and the following disclaimers.
-//  - Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimers in
-//    the documentation and/or other materials provided with the distribution.
-//  - Neither the names of Advanced Micro Devices, Inc,
-//    nor the names of its contributors may be used to endorse or promote
-//    products derived from this Software without specific prior written
-//    permission.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-// DEALINGS WITH THE SOFTWARE.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-#include "common.hpp"
-#include "rocm_bandwidth_test.hpp"
-
-#include <stdlib.h>
-#include <assert.h>
-#include <algorithm>
-#include <unistd.h>
-#include <cctype>
-#include <sstream>
-#include <limits>
-
-// The values are in megabytes at allocation time
-const uint32_t RocmBandwidthTest::SIZE_LIST[] = { 1 * 1024,
-                                 2 * 1024, 4 * 1024, 8 * 1024,
-                                 16 * 1024, 32 * 1024, 64 * 1024,
-                                 128 * 1024, 256 * 1024, 512 * 1024,
-                                 1 * 1024 * 1024, 2 * 1024 * 1024,
-                                 4 * 1024 * 1024, 8 * 1024 * 1024,
-                                 16 * 1024 * 1024, 32 * 1024 * 1024,
-                                 64 * 1024 * 1024, 128 * 1024 * 1024,
-                                 256 * 1024 * 1024, 512 * 1024 * 1024 };
-
-uint32_t RocmBandwidthTest::GetIterationNum() {
-  return (validate_) ? 1 : (num_iteration_ * 1.2 + 1);
-}
-
-void RocmBandwidthTest::AcquireAccess(hsa_agent_t agent, void* ptr) {
-  err_ = hsa_amd_agents_allow_access(1, &agent, NULL, ptr);
-  ErrorCheck(err_);
-}
-
-void RocmBandwidthTest::AcquirePoolAcceses(uint32_t src_dev_idx,
-                                   hsa_agent_t src_agent, void* src,
-                                   uint32_t dst_dev_idx,
-                                   hsa_agent_t dst_agent, void* dst) {
-
-  if (access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx] == 2) {
-    AcquireAccess(src_agent, dst);
-    AcquireAccess(dst_agent, src);
-    return;
-  }
-
-  // determine which one is a cpu and call acquire on the other agent
-  hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
-  hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
-  if (src_dev_type == HSA_DEVICE_TYPE_CPU) {
-    AcquireAccess(dst_agent, src);
-    return;
-  }
-  if (dst_dev_type == HSA_DEVICE_TYPE_CPU) {
-    AcquireAccess(src_agent, dst);
-    return;
-  }
-  assert(false && "Inconsistent state");
-}
-
-void RocmBandwidthTest::AllocateHostBuffers(uint32_t size,
-                                    uint32_t src_dev_idx,
-                                    uint32_t dst_dev_idx,
-                                    void*& src, void*& dst,
-                                    void* buf_src, void* buf_dst,
-                                    hsa_agent_t src_agent, hsa_agent_t dst_agent,
-                                    hsa_signal_t& signal) {
-
-  // Allocate host buffers and setup accessibility for copy operation
-  err_ = hsa_amd_memory_pool_allocate(sys_pool_, size, 0, (void**)&src);
-  ErrorCheck(err_);
-
-  // Gain access to the pools
-  AcquirePoolAcceses(cpu_index_, cpu_agent_, src,
-                     src_dev_idx, src_agent, buf_src);
-
-  err_ = hsa_amd_memory_pool_allocate(sys_pool_, size, 0, (void**)&dst);
-  ErrorCheck(err_);
-
-  // Gain access to the pools
-  AcquirePoolAcceses(dst_dev_idx, dst_agent, buf_dst,
-                     cpu_index_, cpu_agent_, dst);
-
-  // Initialize host buffers to a determinate value
-  memset(src, 0x23, size);
-  memset(dst, 0x00, size);
-  
-  // Create a signal to wait on copy operation
-  // @TODO: replace it with a signal pool call
-  err_ = hsa_signal_create(1, 0, NULL, &signal);
-  ErrorCheck(err_);
-
-  return;
-}
-
-void RocmBandwidthTest::AllocateCopyBuffers(uint32_t size,
-                        uint32_t src_dev_idx, uint32_t dst_dev_idx,
-                        void*& src, hsa_amd_memory_pool_t src_pool,
-                        void*& dst, hsa_amd_memory_pool_t dst_pool,
-                        hsa_agent_t src_agent, hsa_agent_t dst_agent,
-                        hsa_signal_t& signal) {
-
-  // Allocate buffers in src and dst pools for forward copy
-  err_ = hsa_amd_memory_pool_allocate(src_pool, size, 0, &src);
-  ErrorCheck(err_);
-  err_ = hsa_amd_memory_pool_allocate(dst_pool, size, 0, &dst);
-  ErrorCheck(err_);
-
-  // Create a signal to wait on copy operation
-  // @TODO: replace it with a signal pool call
-  err_ = hsa_signal_create(1, 0, NULL, &signal);
-  ErrorCheck(err_);
-
-  return AcquirePoolAcceses(src_dev_idx, src_agent, src,
-                            dst_dev_idx, dst_agent, dst);
-}
-
-void RocmBandwidthTest::ReleaseBuffers(bool bidir,
-                               void* src_fwd, void* src_rev,
-                               void* dst_fwd, void* dst_rev,
-                               hsa_signal_t signal_fwd,
-                               hsa_signal_t signal_rev) {
-
-  // Free the src and dst buffers used in forward copy
-  // including the signal used to wait
-  err_ = hsa_amd_memory_pool_free(src_fwd);
-  ErrorCheck(err_);
-  err_ = hsa_amd_memory_pool_free(dst_fwd);
-  ErrorCheck(err_);
-  err_ = hsa_signal_destroy(signal_fwd);
-  ErrorCheck(err_);
-
-  // Free the src and dst buffers used in reverse copy
-  // including the signal used to wait
-  if (bidir) {
-    err_ = hsa_amd_memory_pool_free(src_rev);
-    ErrorCheck(err_);
-    err_ = hsa_amd_memory_pool_free(dst_rev);
-    ErrorCheck(err_);
-    err_ = hsa_signal_destroy(signal_rev);
-    ErrorCheck(err_);
-  }
-}
-
-double RocmBandwidthTest::GetGpuCopyTime(bool bidir,
-                                 hsa_signal_t signal_fwd,
-                                 hsa_signal_t signal_rev) {
-
-  // Obtain time taken for forward copy
-  hsa_amd_profiling_async_copy_time_t async_time_fwd = {0};
-  err_= hsa_amd_profiling_get_async_copy_time(signal_fwd, &async_time_fwd);
-  ErrorCheck(err_);
-  if (bidir == false) {
-    return(async_time_fwd.end - async_time_fwd.start);
-  }
-
-  hsa_amd_profiling_async_copy_time_t async_time_rev = {0};
-  err_= hsa_amd_profiling_get_async_copy_time(signal_rev, &async_time_rev);
-  ErrorCheck(err_);
-  double start = min(async_time_fwd.start, async_time_rev.start);
-  double end = max(async_time_fwd.end, async_time_rev.end);
-  return(end - start);
-}
-
-void RocmBandwidthTest::copy_buffer(void* dst, hsa_agent_t dst_agent,
-                            void* src, hsa_agent_t src_agent,
-                            size_t size, hsa_signal_t signal) {
-
-  // Copy from src into dst buffer
-  err_ = hsa_amd_memory_async_copy(dst, dst_agent,
-                                   src, src_agent,
-                                   size, 0, NULL, signal);
-  ErrorCheck(err_);
-
-  // Wait for the forward copy operation to complete
-  while (hsa_signal_wait_acquire(signal, HSA_SIGNAL_CONDITION_LT, 1,
-                                     uint64_t(-1), HSA_WAIT_STATE_ACTIVE));
-}
-
-void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
-
-  // Bind if this transaction is bidirectional
-  bool bidir = trans.copy.bidir_;
-
-  // Initialize size of buffer to equal the largest element of allocation
-  uint32_t size_len = size_list_.size();
-  uint32_t max_size = size_list_.back();
-
-  // Bind to resources such as pool and agents that are involved
-  // in both forward and reverse copy operations
-  void* buf_src_fwd;
-  void* buf_dst_fwd;
-  void* buf_src_rev;
-  void* buf_dst_rev;
-  void* validation_dst;
-  void* validation_src;
-  hsa_signal_t signal_fwd;
-  hsa_signal_t signal_rev;
-  hsa_signal_t validation_signal;
-  uint32_t src_idx = trans.copy.src_idx_;
-  uint32_t dst_idx = trans.copy.dst_idx_;
-  uint32_t src_dev_idx_fwd = pool_list_[src_idx].agent_index_;
-  uint32_t dst_dev_idx_fwd = pool_list_[dst_idx].agent_index_;
-  uint32_t src_dev_idx_rev = dst_dev_idx_fwd;
-  uint32_t dst_dev_idx_rev = src_dev_idx_fwd;
-  hsa_amd_memory_pool_t src_pool_fwd = trans.copy.src_pool_;
-  hsa_amd_memory_pool_t dst_pool_fwd = trans.copy.dst_pool_;
-  hsa_amd_memory_pool_t src_pool_rev = dst_pool_fwd;
-  hsa_amd_memory_pool_t dst_pool_rev = src_pool_fwd;
-  hsa_agent_t src_agent_fwd = pool_list_[src_idx].owner_agent_;
-  hsa_agent_t dst_agent_fwd = pool_list_[dst_idx].owner_agent_;
-  hsa_agent_t src_agent_rev = dst_agent_fwd;
-  hsa_agent_t dst_agent_rev = src_agent_fwd;
-
-  // Allocate buffers and signal objects
-  AllocateCopyBuffers(max_size,
-                      src_dev_idx_fwd,
-                      dst_dev_idx_fwd,
-                      buf_src_fwd, src_pool_fwd,
-                      buf_dst_fwd, dst_pool_fwd,
-                      src_agent_fwd, dst_agent_fwd,
-                      signal_fwd);
-
-  if (bidir) {
-    AllocateCopyBuffers(max_size,
-                        src_dev_idx_rev,
-                        dst_dev_idx_rev,
-                        buf_src_rev, src_pool_rev,
-                        buf_dst_rev, dst_pool_rev,
-                        src_agent_rev, dst_agent_rev,
-                        signal_rev);
-  }
-
-  if (validate_) {
-    AllocateHostBuffers(max_size,
-                        src_dev_idx_fwd,
-                        dst_dev_idx_fwd,
-                        validation_src, validation_dst,
-                        buf_src_fwd, buf_dst_fwd,
-                        src_agent_fwd, dst_agent_fwd,
-                        validation_signal);
-
-    // Initialize source buffer with values from verification buffer
-    copy_buffer(buf_src_fwd, src_agent_fwd,
-                validation_src, cpu_agent_,
-                max_size, validation_signal);
-  }
-
-  // Bind the number of iterations
-  uint32_t iterations = GetIterationNum();
-
-  // TODO: promote iterations count to a command line argument
-  //iterations = 1000; // temporary override
-
-  // Iterate through the different buffer sizes to
-  // compute the bandwidth as determined by copy
-  for (uint32_t idx = 0; idx < size_len; idx++) {
-    
-    // This should not be happening
-    uint32_t curr_size = size_list_[idx];
-    if (curr_size > max_size) {
-      cerr << "ERROR: Illegal DMA buffer size" << endl;
-      break;
-    }
-
-    // verify == false means the verification option was turned on but the data changed after DMA'ing it around
-    bool verify = true;
-
-    cout << endl << "RUNNING " << iterations << " ITERATIONS for buffer size " << curr_size << endl;
-
-    // this is an accumulator for elapsed GPU time to conduct a DMA
-    double accumulated_gpu_time = 0.0;
-
-    // Create a timer object and reset signals
-    PerfTimer timer;
-    uint32_t index = timer.CreateTimer();
-
-    // Start the CPU-side time
-    timer.StartTimer(index);
-
-    // run a number of iterations for this DMA buffer size
-    for (uint32_t it = 0; it < iterations; it++) {
-      /*
-      if (it % 2) {
-        printf(".");
-        fflush(stdout);
-      }
-      */
-      cout << ".";
-
-      hsa_signal_store_relaxed(signal_fwd, 1);
-      if (bidir) {
-        hsa_signal_store_relaxed(signal_rev, 1);
-      }
-
-      if (validate_) { 
-        AcquirePoolAcceses(src_dev_idx_fwd,
-                           src_agent_fwd, buf_src_fwd,
-                           dst_dev_idx_fwd,
-                           dst_agent_fwd, buf_dst_fwd);
-      }
-
-      // Launch forward copy operation
-      err_ = hsa_amd_memory_async_copy(buf_dst_fwd, dst_agent_fwd,
-                                       buf_src_fwd, src_agent_fwd,
-                                       curr_size, 0, NULL, signal_fwd);
-      ErrorCheck(err_);
-
-      // Launch reverse copy operation if it is bidirectional
-      if (bidir) {
-        err_ = hsa_amd_memory_async_copy(buf_dst_rev, dst_agent_rev,
-                                         buf_src_rev, src_agent_rev,
-                                         curr_size, 0, NULL, signal_rev);
-        ErrorCheck(err_);
-      }
-
-      if (bw_blocking_run_ == NULL) {
-        cout << "F";
-        // Wait for the forward copy operation to complete
-        while (hsa_signal_wait_acquire(signal_fwd, HSA_SIGNAL_CONDITION_LT, 1,
-                                       uint64_t(-1), HSA_WAIT_STATE_ACTIVE));
-
-        // Wait for the reverse copy operation to complete
-        if (bidir) {
-	  cout << "R";
-          while (hsa_signal_wait_acquire(signal_rev, HSA_SIGNAL_CONDITION_LT, 1,
-                                         uint64_t(-1), HSA_WAIT_STATE_ACTIVE));
-        }
-
-      } else {
-
-        // Wait for the forward copy operation to complete
-	cout << "f";
-	hsa_signal_wait_acquire(signal_fwd, HSA_SIGNAL_CONDITION_LT, 1,
-                                       uint64_t(-1), HSA_WAIT_STATE_BLOCKED);
-
-        // Wait for the reverse copy operation to complete
-	cout << "r";
-        if (bidir) {
-          hsa_signal_wait_acquire(signal_rev, HSA_SIGNAL_CONDITION_LT, 1,
-                                         uint64_t(-1), HSA_WAIT_STATE_BLOCKED);
-        }
-
-      }
-
-      if (validate_) {
-        cout << "V";
-	cout.flush();
-        // Re-Establish access to destination buffer and host buffer
-        AcquirePoolAcceses(dst_dev_idx_fwd,
-                           dst_agent_fwd, buf_dst_fwd,
-                           cpu_index_, cpu_agent_, validation_dst);
-
-        // Init dst buffer with values from outbuffer of copy operation
-        hsa_signal_store_relaxed(validation_signal, 1);
-        copy_buffer(validation_dst, cpu_agent_,
-                    buf_dst_fwd, dst_agent_fwd,
-                    curr_size, validation_signal);
-
-        // Compare output equals input
-        err_ = (hsa_status_t)memcmp(validation_src, validation_dst, curr_size);
-        if (err_ != HSA_STATUS_SUCCESS) {
-          verify = false;
-          exit_value_ = err_;
-	  cerr << "ERROR: data corrupted during DMA" << endl;
-	  break;
-        }
-      }
-      
-      // Collect time from the signal(s)
-      if (print_cpu_time_ == false) {
-	if (trans.copy.uses_gpu_) {
-	  accumulated_gpu_time += GetGpuCopyTime(bidir, signal_fwd, signal_rev);
-	}
-      }
-
-    }  // end iterations
-
-    // Stop the timer object
-    timer.StopTimer(index);
-
-    cout << endl << "ran " << iterations << " iterations" << endl;
-
-    // aggregate elapsed time for "iterations" count of DMA transfers
-    double aggregate_cpu_time = timer.ReadTimer(index);
-
-    // per-DMA timing is not practical b/c the libC call to get time of day
-    // takes longer than the DMA itself, limiting the ability of the benchmark
-    // to saturate the PCIe bus
-
-    // for this reason, min copy time will equal mean copy time for both the cpu and gpu
-
-    cout << endl;
-    cout << "USING CPU TSC TIMER:" << endl;
-    cout << "elapsed seconds:     " << aggregate_cpu_time << endl;
-    cout << "seconds per DMA:     " << aggregate_cpu_time / iterations << endl;
-    cout << "agg BW (GB/sec):     " << ((double)curr_size / aggregate_cpu_time) * ((double)iterations / (double)(1024 * 1024 * 1024)) << endl;  // watch for integer overflow
-
-
-    // Get Cpu min copy time
-    trans.cpu_min_time_.push_back(aggregate_cpu_time / (double)iterations);  // elapsed time for single buffer
-                                                                           // since Display() thinks only curr_size bytes were sent
-                                                                           // Display() doesn't know about iterations
-
-    // Get Cpu mean copy time and store to the array
-    trans.cpu_avg_time_.push_back(aggregate_cpu_time / (double)iterations);
-
-    if (print_cpu_time_ == false) {
-      if (trans.copy.uses_gpu_) {
-	// Get Gpu min and mean copy times
-	cout << endl << "USING GPU COPY TIMES:" << endl;
-	cout << "elapsed seconds:     " << (double)accumulated_gpu_time / 1E9 << endl;
-        cout << "seconds per DMA:     " << (double)accumulated_gpu_time / 1E9 / iterations << endl;
-        cout << "agg BW (GB/sec):     " << ((double)curr_size * iterations / (double)(1024 * 1024 * 1024) /
-					    ((double)accumulated_gpu_time / 1E9)) << endl;  // watch for integer overflow
-
-        double min_time = (verify) ? accumulated_gpu_time  / (double)iterations: std::numeric_limits<double>::max();
-	double mean_time = (verify) ? accumulated_gpu_time  / (double)iterations: std::numeric_limits<double>::max();
-	trans.gpu_min_time_.push_back(min_time);
-	trans.gpu_avg_time_.push_back(mean_time);
-      }
-    }
-
-  }
-
-
-  // Free up buffers and signal objects used in copy operation
-  ReleaseBuffers(bidir, buf_src_fwd, buf_src_rev,
-                 buf_dst_fwd, buf_dst_rev, signal_fwd, signal_rev);
-
-  if (validate_) {
-    hsa_signal_t fake_signal = {0};
-    ReleaseBuffers(false, validation_src, NULL,
-                   validation_dst, NULL, validation_signal, fake_signal);
-  }
-}
-
-void RocmBandwidthTest::Run() {
-
-  // Enable profiling of Async Copy Activity
-  if (print_cpu_time_ == false) {
-    err_ = hsa_amd_profiling_async_copy_enable(true);
-    ErrorCheck(err_);
-  }
-
-  // Iterate through the list of transactions and execute them
-  uint32_t trans_size = trans_list_.size();
-  for (uint32_t idx = 0; idx < trans_size; idx++) {
-    async_trans_t& trans = trans_list_[idx];
-    if ((trans.req_type_ == REQ_COPY_BIDIR) ||
-        (trans.req_type_ == REQ_COPY_UNIDIR) ||
-        (trans.req_type_ == REQ_COPY_ALL_BIDIR) ||
-        (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) {
-      RunCopyBenchmark(trans);
-      ComputeCopyTime(trans);
-    }
-    if ((trans.req_type_ == REQ_READ) ||
-        (trans.req_type_ == REQ_WRITE)) {
-      RunIOBenchmark(trans);
-    }
-  }
-  std::cout << std::endl;
-
-  // Disable profiling of Async Copy Activity
-  if (print_cpu_time_ == false) {
-    err_ = hsa_amd_profiling_async_copy_enable(false);
-    ErrorCheck(err_);
-  }
-
-}
-
-void RocmBandwidthTest::Close() {
-  hsa_status_t status = hsa_shut_down();
-  ErrorCheck(status);
-  return;
-}
-
-// Sets up the bandwidth test object to enable running
-// the various test scenarios requested by user. The
-// things this proceedure takes care of are:
-//    
-//    Parse user arguments
-//    Discover RocR Device Topology
-//    Determine validity of requested test scenarios
-//    Build the list of transactions to execute
-//    Miscellaneous
-//
-void RocmBandwidthTest::SetUp() {
-
-  // Parse user arguments
-  ParseArguments();
-
-  // Validate input parameters
-  bool status = ValidateArguments();
-  if (status == false) {
-    PrintHelpScreen();
-    exit(1);
-  }
-
-  // Build list of transactions (copy, read, write) to execute
-  status = BuildTransList();
-  if (status == false) {
-    PrintHelpScreen();
-    exit(1);
-  }
-}
-
-RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv, size_t num) : BaseTest(num) {
-
-  usr_argc_ = argc;
-  usr_argv_ = argv;
-
-  pool_index_ = 0;
-  cpu_index_ = -1;
-  agent_index_ = 0;
-  
-  req_read_ = REQ_INVALID;
-  req_write_ = REQ_INVALID;
-  req_copy_bidir_ = REQ_INVALID;
-  req_copy_unidir_ = REQ_INVALID;
-  req_copy_all_bidir_ = REQ_INVALID;
-  req_copy_all_unidir_ = REQ_INVALID;
-  
-  link_matrix_ = NULL;
-  access_matrix_ = NULL;
-  active_agents_list_ = NULL;
-  
-  validate_ = false;
-  print_cpu_time_ = false;
-
-  // Initialize version of the test
-  version_.major_id = 1;
-  version_.minor_id = 0;
-  version_.step_id = 0;
-  version_.reserved = 0;
-
-  bw_default_run_ = getenv("ROCM_BW_DEFAULT_RUN");
-  bw_blocking_run_ = getenv("ROCR_BW_RUN_BLOCKING");
-  skip_fine_grain_ = getenv("ROCM_SKIP_FINE_GRAINED_POOL");
-
-  exit_value_ = 0;
-}
-
-RocmBandwidthTest::~RocmBandwidthTest() { }
-
-std::string RocmBandwidthTest::GetVersion() const {
-
-  std::stringstream stream;
-  stream << version_.major_id << ".";
-  stream << version_.minor_id << ".";
-  stream << version_.step_id;
-  return stream.str();
-}
-
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+#include <assert.h>
+#include <algorithm>
+#include <unistd.h>
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <limits>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// The values are in megabytes at allocation time
+const uint32_t RocmBandwidthTest::SIZE_LIST[] = { 1 * 1024,
+                                 2 * 1024, 4 * 1024, 8 * 1024,
+                                 16 * 1024, 32 * 1024, 64 * 1024,
+                                 128 * 1024, 256 * 1024, 512 * 1024,
+                                 1 * 1024 * 1024, 2 * 1024 * 1024,
+                                 4 * 1024 * 1024, 8 * 1024 * 1024,
+                                 16 * 1024 * 1024, 32 * 1024 * 1024,
+                                 64 * 1024 * 1024, 128 * 1024 * 1024,
+                                 256 * 1024 * 1024, 512 * 1024 * 1024 };
+
+// Number of copies validated per buffer size. Read back and compare
+// of one copy overlaps the next one, so validation is not limited
+// to a single copy
+static const uint32_t VALIDATE_ITERATION_NUM = 4;
+
+// Bytes copied per buffer size when sizes are swept, beyond which
+// larger sizes run fewer iterations, no fewer than the minimum
+static const double SWEEP_BYTES_PER_SIZE = 1024.0 * 1024 * 1024;
+static const uint32_t SWEEP_ITERATION_MIN = 8;
+
+uint32_t RocmBandwidthTest::GetIterationNum() const {
+  return (validate_) ? VALIDATE_ITERATION_NUM : (num_iteration_ * 1.2 + 1);
+}
+
+// @brief: Iterations of copies of a buffer size. A sweep of sizes
+// bounds the bytes copied per size, which keeps the sweep of every
+// pair of pools from being dominated by its largest sizes
+uint32_t RocmBandwidthTest::GetCopyIterationNum(uint32_t size) const {
+
+  uint32_t iterations = GetIterationNum();
+  if (sweep_sizes_ == false) {
+    return iterations;
+  }
+  double budget = SWEEP_BYTES_PER_SIZE / size;
+  if (budget >= iterations) {
+    return iterations;
+  }
+  return std::max(SWEEP_ITERATION_MIN, (uint32_t)budget);
+}
+
+void RocmBandwidthTest::AcquireAccess(hsa_agent_t agent, void* ptr) {
+
+  // Buffers locked by the test are accessible to every agent
+  if (host_buffers_->IsLocked(ptr)) {
+    return;
+  }
+  err_ = backend_->AllowAccess(1, &agent, NULL, ptr);
+  ErrorCheck(err_);
+}
+
+void RocmBandwidthTest::AcquirePoolAcceses(uint32_t src_pool_idx, void* src,
+                                           uint32_t dst_pool_idx, void* dst) {
+
+  assert((GetPoolPathAccess(src_pool_idx, dst_pool_idx) != 0) &&
+         "Inconsistent state");
+
+  // Grant owner of each pool access to the buffer of other
+  // pool, unless the owner can never access that pool
+  uint32_t src_dev_idx = pool_list_[src_pool_idx].agent_index_;
+  uint32_t dst_dev_idx = pool_list_[dst_pool_idx].agent_index_;
+  if (GetPoolAccess(src_dev_idx, dst_pool_idx) !=
+      HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+    AcquireAccess(pool_list_[src_pool_idx].owner_agent_, dst);
+  }
+  if (GetPoolAccess(dst_dev_idx, src_pool_idx) !=
+      HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+    AcquireAccess(pool_list_[dst_pool_idx].owner_agent_, src);
+  }
+}
+
+void RocmBandwidthTest::AcquireHostAccess(uint32_t host_idx, uint32_t pool_idx,
+                                          void* buf, void* host) {
+
+  // System memory is accessible to every agent while Cpu
+  // is granted access to the pool only if it is allowed
+  AcquireAccess(pool_list_[pool_idx].owner_agent_, host);
+  if (GetPoolAccess(host_idx, pool_idx) !=
+      HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+    AcquireAccess(agent_list_[host_idx].agent_, buf);
+  }
+}
+
+void RocmBandwidthTest::AllocateHostBuffers(uint32_t size, uint32_t dst_size,
+                                    uint32_t host_idx,
+                                    uint32_t src_pool_idx,
+                                    uint32_t dst_pool_idx,
+                                    void*& src, void*& dst,
+                                    void* buf_src, void* buf_dst,
+                                    hsa_agent_t src_agent, hsa_agent_t dst_agent,
+                                    hsa_signal_t& signal) {
+
+  // Allocate host buffers and setup accessibility for copy operation
+  hsa_amd_memory_pool_t host_pool = GetHostPool(host_idx);
+  err_ = backend_->PoolAllocate(host_pool, size, 0, (void**)&src);
+  ErrorCheck(err_);
+
+  // Gain access to the pools
+  AcquireHostAccess(host_idx, src_pool_idx, buf_src, src);
+
+  err_ = backend_->PoolAllocate(host_pool, dst_size, 0, (void**)&dst);
+  ErrorCheck(err_);
+
+  // Gain access to the pools
+  AcquireHostAccess(host_idx, dst_pool_idx, buf_dst, dst);
+
+  // Initialize host buffers to a determinate value
+  memset(src, 0x23, size);
+  memset(dst, 0x00, dst_size);
+  
+  // Create a signal to wait on copy operation
+  // @TODO: replace it with a signal pool call
+  err_ = backend_->SignalCreate(1, &signal);
+  ErrorCheck(err_);
+
+  return;
+}
+
+void RocmBandwidthTest::AllocateCopyBuffers(uint32_t size, uint32_t page_kind,
+                        uint32_t src_pool_idx, uint32_t dst_pool_idx,
+                        void*& src, hsa_amd_memory_pool_t src_pool,
+                        void*& dst, hsa_amd_memory_pool_t dst_pool,
+                        hsa_agent_t src_agent, hsa_agent_t dst_agent,
+                        hsa_signal_t& signal) {
+
+  // Allocate buffers in src and dst pools for forward copy. Buffers
+  // of system memory are backed by pages of the requested kind
+  uint32_t src_dev_idx = pool_list_[src_pool_idx].agent_index_;
+  uint32_t dst_dev_idx = pool_list_[dst_pool_idx].agent_index_;
+  bool src_is_host = (agent_list_[src_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU);
+  bool dst_is_host = (agent_list_[dst_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU);
+  err_ = host_buffers_->Allocate((src_is_host) ? page_kind : HOST_PAGE_POOL,
+                                 src_pool, size, &src);
+  ErrorCheck(err_);
+  err_ = host_buffers_->Allocate((dst_is_host) ? page_kind : HOST_PAGE_POOL,
+                                 dst_pool, size, &dst);
+  ErrorCheck(err_);
+
+  // Create a signal to wait on copy operation
+  // @TODO: replace it with a signal pool call
+  err_ = backend_->SignalCreate(1, &signal);
+  ErrorCheck(err_);
+
+  return AcquirePoolAcceses(src_pool_idx, src, dst_pool_idx, dst);
+}
+
+void RocmBandwidthTest::ReleaseBuffers(bool bidir,
+                               void* src_fwd, void* src_rev,
+                               void* dst_fwd, void* dst_rev,
+                               hsa_signal_t signal_fwd,
+                               hsa_signal_t signal_rev) {
+
+  // Free the src and dst buffers used in forward copy
+  // including the signal used to wait
+  err_ = host_buffers_->Free(src_fwd);
+  ErrorCheck(err_);
+  err_ = host_buffers_->Free(dst_fwd);
+  ErrorCheck(err_);
+  err_ = backend_->SignalDestroy(signal_fwd);
+  ErrorCheck(err_);
+
+  // Free the src and dst buffers used in reverse copy
+  // including the signal used to wait
+  if (bidir) {
+    err_ = host_buffers_->Free(src_rev);
+    ErrorCheck(err_);
+    err_ = host_buffers_->Free(dst_rev);
+    ErrorCheck(err_);
+    err_ = backend_->SignalDestroy(signal_rev);
+    ErrorCheck(err_);
+  }
+}
+
+double RocmBandwidthTest::GetGpuCopyTime(bool bidir,
+                                 hsa_signal_t signal_fwd,
+                                 hsa_signal_t signal_rev) {
+
+  // Obtain time taken for forward copy
+  hsa_amd_profiling_async_copy_time_t async_time_fwd = {0};
+  err_= backend_->GetAsyncCopyTime(signal_fwd, &async_time_fwd);
+  ErrorCheck(err_);
+  if (bidir == false) {
+    return(async_time_fwd.end - async_time_fwd.start);
+  }
+
+  hsa_amd_profiling_async_copy_time_t async_time_rev = {0};
+  err_= backend_->GetAsyncCopyTime(signal_rev, &async_time_rev);
+  ErrorCheck(err_);
+  double start = min(async_time_fwd.start, async_time_rev.start);
+  double end = max(async_time_fwd.end, async_time_rev.end);
+  return(end - start);
+}
+
+void RocmBandwidthTest::copy_buffer(void* dst, hsa_agent_t dst_agent,
+                            void* src, hsa_agent_t src_agent,
+                            size_t size, hsa_signal_t signal) {
+
+  // Copy from src into dst buffer
+  err_ = backend_->AsyncCopy(dst, dst_agent,
+                             src, src_agent,
+                             size, 0, NULL, signal);
+  ErrorCheck(err_);
+
+  // Wait for the forward copy operation to complete
+  while (backend_->SignalWait(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                              HSA_WAIT_STATE_ACTIVE));
+}
+
+// Validation by hash reads destination back in chunks that fit in
+// cache, each hashed in blocks compared against blocks of source
+static const uint32_t VALIDATE_CHUNK_SIZE = 4 * 1024 * 1024;
+static const uint32_t VALIDATE_HASH_BLOCK = 64 * 1024;
+
+// @brief: Print bytes of a buffer starting at its first mismatch
+static void PrintMismatch(size_t offset, const uint8_t* expected,
+                          const uint8_t* actual, size_t count) {
+
+  std::stringstream expected_bytes;
+  std::stringstream actual_bytes;
+  expected_bytes << std::hex << std::setfill('0');
+  actual_bytes << std::hex << std::setfill('0');
+  for (size_t idx = 0; idx < count; idx++) {
+    expected_bytes << " " << std::setw(2) << (uint32_t)expected[idx];
+    actual_bytes << " " << std::setw(2) << (uint32_t)actual[idx];
+  }
+  cerr << "ERROR: data corrupted during DMA at offset " << offset
+       << ", expected:" << expected_bytes.str()
+       << ", found:" << actual_bytes.str() << endl;
+}
+
+// @brief: Seed of pattern copied by an iteration of a buffer size,
+// unique to each iteration so that stale data fails validation
+static uint64_t GetPatternSeed(uint32_t size, uint32_t iteration) {
+  return (((uint64_t)size << 32) | iteration);
+}
+
+// @brief: Check destination of a copy read back into a host buffer
+// against the pattern of its source, once the read back signals its
+// completion. Pattern is regenerated by threads of host copy engine
+bool RocmBandwidthTest::CompareValidation(uint64_t seed, const void* actual,
+                                          size_t size, hsa_signal_t signal) {
+
+  while (backend_->SignalWait(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                              HSA_WAIT_STATE_ACTIVE));
+
+  HostCopyEngine::host_pattern_job_t job;
+  job.op_ = HOST_PATTERN_CHECK;
+  job.buf_ = (void*)actual;
+  job.seed_ = seed;
+  job.offset_ = 0;
+  job.size_ = size;
+  host_engine_->Pattern(job);
+  if (job.mismatch_ == size) {
+    return true;
+  }
+
+  // Report bytes starting at first mismatch
+  uint8_t expected[8];
+  size_t count = std::min(size - job.mismatch_, sizeof(expected));
+  for (size_t idx = 0; idx < count; idx++) {
+    expected[idx] = HostCopyEngine::GetPatternByte(seed, job.mismatch_ + idx);
+  }
+  PrintMismatch(job.mismatch_, expected,
+                (const uint8_t*)actual + job.mismatch_, count);
+  return false;
+}
+
+// @brief: Load a window of source of a copy with the pattern of a
+// seed. Window is generated into a host buffer and copied into source
+// at its offset, which is a multiple of a cache line
+void RocmBandwidthTest::LoadSampleWindow(uint64_t seed, size_t offset, void* buf,
+                                         hsa_agent_t buf_agent, hsa_agent_t host_agent,
+                                         void* window, size_t window_size,
+                                         hsa_signal_t signal) {
+
+  HostCopyEngine::host_pattern_job_t job;
+  job.op_ = HOST_PATTERN_FILL;
+  job.buf_ = window;
+  job.seed_ = seed;
+  job.offset_ = offset;
+  job.size_ = window_size;
+  host_engine_->Pattern(job);
+  backend_->SignalStore(signal, 1);
+  copy_buffer((char*)buf + offset, buf_agent, window, host_agent,
+              window_size, signal);
+}
+
+// @brief: Check a window of destination of a copy against the pattern
+// loaded into the same window of its source. Window is read back into
+// a host buffer
+bool RocmBandwidthTest::SampleValidation(uint64_t seed, size_t offset, void* buf,
+                                         hsa_agent_t buf_agent, hsa_agent_t host_agent,
+                                         void* window, size_t window_size,
+                                         hsa_signal_t signal) {
+
+  backend_->SignalStore(signal, 1);
+  copy_buffer(window, host_agent, (char*)buf + offset, buf_agent,
+              window_size, signal);
+
+  HostCopyEngine::host_pattern_job_t job;
+  job.op_ = HOST_PATTERN_CHECK;
+  job.buf_ = window;
+  job.seed_ = seed;
+  job.offset_ = offset;
+  job.size_ = window_size;
+  host_engine_->Pattern(job);
+  if (job.mismatch_ == window_size) {
+    return true;
+  }
+
+  uint8_t expected[8];
+  size_t count = std::min(window_size - job.mismatch_, sizeof(expected));
+  for (size_t idx = 0; idx < count; idx++) {
+    expected[idx] = HostCopyEngine::GetPatternByte(seed, offset + job.mismatch_ + idx);
+  }
+  PrintMismatch(offset + job.mismatch_, expected,
+                (const uint8_t*)window + job.mismatch_, count);
+  return false;
+}
+
+// @brief: Validate buffer against its expected value by reading it
+// back in chunks once signal of its copy completes. Chunks alternate
+// between two host buffers, one being hashed while next is read back.
+// Blocks whose hash differs from that of expected value are compared
+// byte by byte to report the first mismatch
+bool RocmBandwidthTest::HashValidation(const void* expected, void* buf,
+                                       hsa_agent_t buf_agent, hsa_agent_t host_agent,
+                                       void* const* chunk_list,
+                                       const hsa_signal_t* chunk_signal_list,
+                                       size_t size, hsa_signal_t signal) {
+
+  // Hash expected value once, for all of its chunks
+  size_t num_blocks = (size + VALIDATE_HASH_BLOCK - 1) / VALIDATE_HASH_BLOCK;
+  vector<uint64_t> expected_hash_list(num_blocks);
+  HostCopyEngine::host_hash_job_t job;
+  job.buf_ = expected;
+  job.size_ = size;
+  job.block_size_ = VALIDATE_HASH_BLOCK;
+  job.hash_list_ = &expected_hash_list[0];
+  host_engine_->Hash(job);
+
+  bool verify = true;
+  uint64_t hash_list[VALIDATE_CHUNK_SIZE / VALIDATE_HASH_BLOCK];
+  size_t num_chunks = (size + VALIDATE_CHUNK_SIZE - 1) / VALIDATE_CHUNK_SIZE;
+  for (size_t chunk = 0; chunk <= num_chunks; chunk++) {
+
+    // Read back next chunk, into buffer of chunk hashed before last
+    if ((chunk < num_chunks) && verify) {
+      size_t offset = chunk * VALIDATE_CHUNK_SIZE;
+      hsa_signal_t chunk_signal = chunk_signal_list[chunk % 2];
+      backend_->SignalStore(chunk_signal, 1);
+      err_ = backend_->AsyncCopy(chunk_list[chunk % 2], host_agent,
+                                 (char*)buf + offset, buf_agent,
+                                 std::min((size_t)VALIDATE_CHUNK_SIZE, size - offset),
+                                 1, &signal, chunk_signal);
+      ErrorCheck(err_);
+    }
+
+    // Hash previous chunk while next one is being read back
+    if ((chunk == 0) || (verify == false)) {
+      continue;
+    }
+    size_t offset = (chunk - 1) * VALIDATE_CHUNK_SIZE;
+    const char* actual = (const char*)chunk_list[(chunk - 1) % 2];
+    while (backend_->SignalWait(chunk_signal_list[(chunk - 1) % 2],
+                                HSA_SIGNAL_CONDITION_LT, 1, HSA_WAIT_STATE_ACTIVE));
+    job.buf_ = actual;
+    job.size_ = std::min((size_t)VALIDATE_CHUNK_SIZE, size - offset);
+    job.hash_list_ = hash_list;
+    host_engine_->Hash(job);
+
+    size_t first_block = offset / VALIDATE_HASH_BLOCK;
+    size_t chunk_blocks = (job.size_ + VALIDATE_HASH_BLOCK - 1) / VALIDATE_HASH_BLOCK;
+    for (size_t block = 0; block < chunk_blocks; block++) {
+      if (hash_list[block] == expected_hash_list[first_block + block]) {
+        continue;
+      }
+
+      // Locate first byte that differs in the mismatching block
+      size_t block_offset = block * VALIDATE_HASH_BLOCK;
+      HostCopyEngine::host_compare_job_t compare_job;
+      compare_job.expected_ = (const char*)expected + offset + block_offset;
+      compare_job.actual_ = actual + block_offset;
+      compare_job.size_ = std::min((size_t)VALIDATE_HASH_BLOCK, job.size_ - block_offset);
+      host_engine_->Compare(compare_job);
+      size_t mismatch = std::min(compare_job.mismatch_, compare_job.size_ - 1);
+      PrintMismatch(offset + block_offset + mismatch,
+                    (const uint8_t*)compare_job.expected_ + mismatch,
+                    (const uint8_t*)compare_job.actual_ + mismatch,
+                    std::min(compare_job.size_ - mismatch, (size_t)8));
+      verify = false;
+      break;
+    }
+  }
+
+  // Chunk read back may be in flight if a mismatch has been found
+  for (uint32_t slot = 0; slot < 2; slot++) {
+    while (backend_->SignalWait(chunk_signal_list[slot], HSA_SIGNAL_CONDITION_LT, 1,
+                                HSA_WAIT_STATE_ACTIVE));
+  }
+  return verify;
+}
+
+void RocmBandwidthTest::RunCopyBenchmark(async_trans_t& trans) {
+
+  // Bind if this transaction is bidirectional
+  bool bidir = trans.copy.bidir_;
+
+  // Initialize size of buffer to equal the largest element of allocation
+  uint32_t size_len = size_list_.size();
+  uint32_t max_size = size_list_.back();
+
+  // Bind to resources such as pool and agents that are involved
+  // in both forward and reverse copy operations
+  void* buf_src_fwd;
+  void* buf_dst_fwd;
+  void* buf_src_rev;
+  void* buf_dst_rev;
+  void* validation_dst[2];
+  void* validation_src;
+  hsa_signal_t signal_fwd;
+  hsa_signal_t signal_rev;
+  hsa_signal_t validation_signal[2];
+  hsa_signal_t pattern_signal;
+  uint32_t src_idx = trans.copy.src_idx_;
+  uint32_t dst_idx = trans.copy.dst_idx_;
+  hsa_amd_memory_pool_t src_pool_fwd = trans.copy.src_pool_;
+  hsa_amd_memory_pool_t dst_pool_fwd = trans.copy.dst_pool_;
+  hsa_amd_memory_pool_t src_pool_rev = dst_pool_fwd;
+  hsa_amd_memory_pool_t dst_pool_rev = src_pool_fwd;
+  hsa_agent_t src_agent_fwd = pool_list_[src_idx].owner_agent_;
+  hsa_agent_t dst_agent_fwd = pool_list_[dst_idx].owner_agent_;
+  hsa_agent_t src_agent_rev = dst_agent_fwd;
+  hsa_agent_t dst_agent_rev = src_agent_fwd;
+
+  // Submit copies from and validate against the NUMA node
+  // nearest to the devices of transaction
+  uint32_t host_idx = GetTransHostIdx(trans);
+  hsa_agent_t host_agent = agent_list_[host_idx].agent_;
+  PinToNumaNode(agent_list_[host_idx].numa_node_);
+
+  // Allocate buffers and signal objects
+  uint32_t page_kind = trans.copy.page_kind_;
+  AllocateCopyBuffers(max_size, page_kind,
+                      src_idx, dst_idx,
+                      buf_src_fwd, src_pool_fwd,
+                      buf_dst_fwd, dst_pool_fwd,
+                      src_agent_fwd, dst_agent_fwd,
+                      signal_fwd);
+
+  if (bidir) {
+    AllocateCopyBuffers(max_size, page_kind,
+                        dst_idx, src_idx,
+                        buf_src_rev, src_pool_rev,
+                        buf_dst_rev, dst_pool_rev,
+                        src_agent_rev, dst_agent_rev,
+                        signal_rev);
+  }
+
+  // Destination is read back whole unless it is validated by hash
+  uint32_t readback_size = (validate_hash_ == NULL) ? max_size :
+                           std::min(max_size, VALIDATE_CHUNK_SIZE);
+  if (validate_) {
+    AllocateHostBuffers(max_size, readback_size, host_idx,
+                        src_idx, dst_idx,
+                        validation_src, validation_dst[0],
+                        buf_src_fwd, buf_dst_fwd,
+                        src_agent_fwd, dst_agent_fwd,
+                        validation_signal[0]);
+    backend_->SignalStore(validation_signal[0], 0);
+
+    // Source buffer is loaded with a new pattern every iteration,
+    // which is generated into host buffer and copied from it
+    err_ = backend_->SignalCreate(0, &pattern_signal);
+    ErrorCheck(err_);
+
+    // Second host buffer lets destination of one iteration be read
+    // back while that of the previous iteration is being compared,
+    // or one chunk be read back while the previous one is hashed
+    err_ = backend_->PoolAllocate(GetHostPool(host_idx), readback_size, 0,
+                                  &validation_dst[1]);
+    ErrorCheck(err_);
+    AcquireHostAccess(host_idx, dst_idx, buf_dst_fwd, validation_dst[1]);
+    err_ = backend_->SignalCreate(0, &validation_signal[1]);
+    ErrorCheck(err_);
+    BindHostCopyEngine(agent_list_[host_idx].numa_node_);
+  }
+
+  // Sampled validation loads a window of source of some of the
+  // copies with a pattern and reads back that window of destination
+  bool sampled = (validate_budget_ > 0);
+  uint32_t window_size = std::min(max_size, VALIDATE_CHUNK_SIZE);
+  std::mt19937_64 sample_rng(std::random_device{}());
+  if (sampled) {
+    AllocateHostBuffers(window_size, window_size, host_idx,
+                        src_idx, dst_idx,
+                        validation_src, validation_dst[0],
+                        buf_src_fwd, buf_dst_fwd,
+                        src_agent_fwd, dst_agent_fwd,
+                        validation_signal[0]);
+    BindHostCopyEngine(agent_list_[host_idx].numa_node_);
+  }
+
+  // Iterate through the different buffer sizes to
+  // compute the bandwidth as determined by copy
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+    
+    // This should not be happening
+    uint32_t curr_size = size_list_[idx];
+    if (curr_size > max_size) {
+      cerr << "ERROR: Illegal DMA buffer size" << endl;
+      break;
+    }
+
+    // Bind the number of iterations
+    uint32_t iterations = GetCopyIterationNum(curr_size);
+
+    // verify == false means the verification option was turned on but the data changed after DMA'ing it around
+    bool verify = true;
+
+    // Host buffer holding destination read back by previous
+    // iteration, which is compared while this iteration copies
+    int32_t pending_slot = -1;
+
+    // Track time of copies and of their validation. Windows of
+    // sampled copies start at a multiple of a cache line
+    uint32_t sample_size = std::min(curr_size, window_size);
+    size_t num_offsets = ((curr_size - sample_size) / 64) + 1;
+    uint32_t num_samples = 0;
+    double copy_time = 0;
+    double sample_time = 0;
+    double last_sample_time = 0;
+
+    cout << endl << "RUNNING " << iterations << " ITERATIONS for buffer size " << curr_size << endl;
+
+    // this is an accumulator for elapsed GPU time to conduct a DMA
+    double accumulated_gpu_time = 0.0;
+
+    // Create a timer object and reset signals
+    PerfTimer timer;
+    uint32_t index = timer.CreateTimer();
+
+    // Start the CPU-side time
+    timer.StartTimer(index);
+
+    // run a number of iterations for this DMA buffer size
+    for (uint32_t it = 0; it < iterations; it++) {
+
+      // Sample a copy if its validation, estimated to take as long as
+      // the last one, keeps within the budget. Half of the copies that
+      // can be sampled are skipped at random, so that samples do not
+      // follow a fixed period. Window of source of a sampled copy is
+      // loaded with a pattern unique to it before the copy, so that a
+      // copy which leaves destination unchanged does not pass
+      bool sample_copy = false;
+      size_t sample_offset = 0;
+      if (sampled) {
+        uint64_t sample = sample_rng();
+        if (((sample_time + last_sample_time) <= (validate_budget_ * copy_time)) &&
+            ((sample & 1) != 0)) {
+          std::chrono::steady_clock::time_point sample_start = std::chrono::steady_clock::now();
+          sample_copy = true;
+          sample_offset = ((sample >> 1) % num_offsets) * 64;
+          LoadSampleWindow(GetPatternSeed(curr_size, it), sample_offset,
+                           buf_src_fwd, src_agent_fwd, host_agent,
+                           validation_src, sample_size, validation_signal[0]);
+          std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - sample_start;
+          last_sample_time = elapsed.count();
+        }
+      }
+
+      std::chrono::steady_clock::time_point copy_start = std::chrono::steady_clock::now();
+      /*
+      if (it % 2) {
+        printf(".");
+        fflush(stdout);
+      }
+      */
+      cout << ".";
+
+      // Read back of previous iteration depends on forward signal,
+      // which can be reset only once that read back is done
+      if (pending_slot >= 0) {
+        while (backend_->SignalWait(validation_signal[pending_slot],
+                                    HSA_SIGNAL_CONDITION_LT, 1, HSA_WAIT_STATE_ACTIVE));
+      }
+
+      backend_->SignalStore(signal_fwd, 1);
+      if (bidir) {
+        backend_->SignalStore(signal_rev, 1);
+      }
+
+      if (validate_) { 
+        AcquirePoolAcceses(src_idx, buf_src_fwd,
+                           dst_idx, buf_dst_fwd);
+      }
+
+      // Load source with pattern unique to this iteration
+      uint32_t num_deps = 0;
+      hsa_signal_t dep_list[2];
+      if (validate_) {
+        HostCopyEngine::host_pattern_job_t job;
+        job.op_ = HOST_PATTERN_FILL;
+        job.buf_ = validation_src;
+        job.seed_ = GetPatternSeed(curr_size, it);
+        job.offset_ = 0;
+        job.size_ = curr_size;
+        host_engine_->Pattern(job);
+        backend_->SignalStore(pattern_signal, 1);
+        err_ = backend_->AsyncCopy(buf_src_fwd, src_agent_fwd,
+                                   validation_src, host_agent,
+                                   curr_size, 0, NULL, pattern_signal);
+        ErrorCheck(err_);
+        dep_list[num_deps++] = pattern_signal;
+      }
+
+      // Launch forward copy operation. It overwrites destination
+      // read back by previous iteration and hence waits for it
+      if (pending_slot >= 0) {
+        dep_list[num_deps++] = validation_signal[pending_slot];
+      }
+      err_ = backend_->AsyncCopy(buf_dst_fwd, dst_agent_fwd,
+                                 buf_src_fwd, src_agent_fwd,
+                                 curr_size, num_deps,
+                                 (num_deps == 0) ? NULL : dep_list, signal_fwd);
+      ErrorCheck(err_);
+
+      // Validate destination once forward copy is done, either by
+      // hashing it while it is read back in chunks, or by queueing its
+      // read back and comparing the one of previous iteration meanwhile
+      if ((validate_) && (validate_hash_ != NULL)) {
+        cout << "V";
+        cout.flush();
+        verify = HashValidation(validation_src, buf_dst_fwd, dst_agent_fwd,
+                                host_agent, validation_dst, validation_signal,
+                                curr_size, signal_fwd);
+      } else if (validate_) {
+        cout << "V";
+        cout.flush();
+        uint32_t slot = it % 2;
+        AcquireHostAccess(host_idx, dst_idx, buf_dst_fwd, validation_dst[slot]);
+        backend_->SignalStore(validation_signal[slot], 1);
+        err_ = backend_->AsyncCopy(validation_dst[slot], host_agent,
+                                   buf_dst_fwd, dst_agent_fwd,
+                                   curr_size, 1, &signal_fwd, validation_signal[slot]);
+        ErrorCheck(err_);
+        if (pending_slot >= 0) {
+          verify = CompareValidation(GetPatternSeed(curr_size, it - 1),
+                                     validation_dst[pending_slot],
+                                     curr_size, validation_signal[pending_slot]);
+        }
+        pending_slot = slot;
+      }
+
+      // Launch reverse copy operation if it is bidirectional
+      if (bidir) {
+        err_ = backend_->AsyncCopy(buf_dst_rev, dst_agent_rev,
+                                   buf_src_rev, src_agent_rev,
+                                   curr_size, 0, NULL, signal_rev);
+        ErrorCheck(err_);
+      }
+
+      if (bw_blocking_run_ == NULL) {
+        cout << "F";
+        // Wait for the forward copy operation to complete
+        while (backend_->SignalWait(signal_fwd, HSA_SIGNAL_CONDITION_LT, 1,
+                                    HSA_WAIT_STATE_ACTIVE));
+
+        // Wait for the reverse copy operation to complete
+        if (bidir) {
+	  cout << "R";
+          while (backend_->SignalWait(signal_rev, HSA_SIGNAL_CONDITION_LT, 1,
+                                      HSA_WAIT_STATE_ACTIVE));
+        }
+
+      } else {
+
+        // Wait for the forward copy operation to complete
+	cout << "f";
+	backend_->SignalWait(signal_fwd, HSA_SIGNAL_CONDITION_LT, 1,
+                      HSA_WAIT_STATE_BLOCKED);
+
+        // Wait for the reverse copy operation to complete
+	cout << "r";
+        if (bidir) {
+          backend_->SignalWait(signal_rev, HSA_SIGNAL_CONDITION_LT, 1,
+                               HSA_WAIT_STATE_BLOCKED);
+        }
+
+      }
+
+      if (verify == false) {
+        break;
+      }
+      
+      // Collect time from the signal(s)
+      if (print_cpu_time_ == false) {
+	if (trans.copy.uses_gpu_) {
+	  accumulated_gpu_time += GetGpuCopyTime(bidir, signal_fwd, signal_rev);
+	}
+      }
+
+      // Check window of destination of a sampled copy. Its time adds
+      // to that of loading the window of source
+      if (sampled) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - copy_start;
+        copy_time += elapsed.count();
+      }
+      if (sample_copy) {
+        std::chrono::steady_clock::time_point sample_start = std::chrono::steady_clock::now();
+        verify = SampleValidation(GetPatternSeed(curr_size, it), sample_offset,
+                                  buf_dst_fwd, dst_agent_fwd, host_agent,
+                                  validation_dst[0], sample_size,
+                                  validation_signal[0]);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - sample_start;
+        last_sample_time += elapsed.count();
+        sample_time += last_sample_time;
+        num_samples++;
+        if (verify == false) {
+          break;
+        }
+      }
+
+    }  // end iterations
+
+    // Compare destination read back by last iteration, or wait for
+    // its read back if a mismatch has been found already
+    if (pending_slot >= 0) {
+      if (verify) {
+        verify = CompareValidation(GetPatternSeed(curr_size, iterations - 1),
+                                   validation_dst[pending_slot],
+                                   curr_size, validation_signal[pending_slot]);
+      } else {
+        while (backend_->SignalWait(validation_signal[pending_slot],
+                                    HSA_SIGNAL_CONDITION_LT, 1, HSA_WAIT_STATE_ACTIVE));
+      }
+    }
+    if (verify == false) {
+      trans.data_valid_ = false;
+      exit_value_ = 1;
+    }
+
+    // Stop the timer object
+    timer.StopTimer(index);
+
+    cout << endl << "ran " << iterations << " iterations" << endl;
+
+    // Report share of copies and bytes checked, and the confidence
+    // of detecting a corruption at a random offset of a random copy,
+    // or one that recurs in every copy. Every sample catches it with
+    // the odds of its window covering the corruption
+    if (sampled) {
+      double coverage = (double)sample_size / curr_size;
+      double one_off = coverage * num_samples / iterations;
+      double recurring = 1 - std::pow(1 - coverage, (double)num_samples);
+      cout << endl;
+      cout << "USING SAMPLED VALIDATION:" << endl;
+      cout << "sampled copies:      " << num_samples << " of " << iterations
+           << " (" << (100.0 * num_samples / iterations) << "%)" << endl;
+      cout << "bytes per sample:    " << sample_size
+           << " (" << (100.0 * coverage) << "% of copy)" << endl;
+      cout << "overhead (%):        "
+           << ((copy_time > 0) ? (100.0 * sample_time / copy_time) : 0) << endl;
+      cout << "one-off found (%):   " << (100.0 * one_off) << endl;
+      cout << "recurring found (%): " << (100.0 * recurring) << endl;
+    }
+
+    // aggregate elapsed time for "iterations" count of DMA transfers
+    double aggregate_cpu_time = timer.ReadTimer(index);
+
+    // per-DMA timing is not practical b/c the libC call to get time of day
+    // takes longer than the DMA itself, limiting the ability of the benchmark
+    // to saturate the PCIe bus
+
+    // for this reason, min copy time will equal mean copy time for both the cpu and gpu
+
+    cout << endl;
+    cout << "USING CPU TSC TIMER:" << endl;
+    cout << "elapsed seconds:     " << aggregate_cpu_time << endl;
+    cout << "seconds per DMA:     " << aggregate_cpu_time / iterations << endl;
+    cout << "agg BW (GB/sec):     " << ((double)curr_size / aggregate_cpu_time) * ((double)iterations / (double)(1024 * 1024 * 1024)) << endl;  // watch for integer overflow
+
+
+    // Get Cpu min copy time
+    trans.cpu_min_time_.push_back(aggregate_cpu_time / (double)iterations);  // elapsed time for single buffer
+                                                                           // since Display() thinks only curr_size bytes were sent
+                                                                           // Display() doesn't know about iterations
+
+    // Get Cpu mean copy time and store to the array
+    trans.cpu_avg_time_.push_back(aggregate_cpu_time / (double)iterations);
+
+    if (print_cpu_time_ == false) {
+      if (trans.copy.uses_gpu_) {
+	// Get Gpu min and mean copy times
+	cout << endl << "USING GPU COPY TIMES:" << endl;
+	cout << "elapsed seconds:     " << (double)accumulated_gpu_time / 1E9 << endl;
+        cout << "seconds per DMA:     " << (double)accumulated_gpu_time / 1E9 / iterations << endl;
+        cout << "agg BW (GB/sec):     " << ((double)curr_size * iterations / (double)(1024 * 1024 * 1024) /
+					    ((double)accumulated_gpu_time / 1E9)) << endl;  // watch for integer overflow
+
+        double min_time = (verify) ? accumulated_gpu_time  / (double)iterations: std::numeric_limits<double>::max();
+	double mean_time = (verify) ? accumulated_gpu_time  / (double)iterations: std::numeric_limits<double>::max();
+	trans.gpu_min_time_.push_back(min_time);
+	trans.gpu_avg_time_.push_back(mean_time);
+      }
+    }
+
+  }
+
+
+  // Free up buffers and signal objects used in copy operation
+  ReleaseBuffers(bidir, buf_src_fwd, buf_src_rev,
+                 buf_dst_fwd, buf_dst_rev, signal_fwd, signal_rev);
+
+  if (validate_) {
+    hsa_signal_t fake_signal = {0};
+    ReleaseBuffers(false, validation_src, NULL,
+                   validation_dst[0], NULL, validation_signal[0], fake_signal);
+    err_ = host_buffers_->Free(validation_dst[1]);
+    ErrorCheck(err_);
+    err_ = backend_->SignalDestroy(validation_signal[1]);
+    ErrorCheck(err_);
+    err_ = backend_->SignalDestroy(pattern_signal);
+    ErrorCheck(err_);
+  }
+
+  if (sampled) {
+    hsa_signal_t fake_signal = {0};
+    ReleaseBuffers(false, validation_src, NULL,
+                   validation_dst[0], NULL, validation_signal[0], fake_signal);
+  }
+}
+
+void RocmBandwidthTest::Run() {
+
+  // Enable profiling of Async Copy Activity
+  if (print_cpu_time_ == false) {
+    err_ = backend_->ProfilingEnable(true);
+    ErrorCheck(err_);
+  }
+
+  // A sweep of sizes across every pair of pools may run for long,
+  // hence print its estimated runtime before starting it
+  uint32_t trans_size = trans_list_.size();
+  if (sweep_sizes_) {
+    double total_time = 0;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      if ((trans.req_type_ != REQ_COPY_ALL_BIDIR) &&
+          (trans.req_type_ != REQ_COPY_ALL_UNIDIR)) {
+        continue;
+      }
+      for (uint32_t jdx = 0; jdx < size_list_.size(); jdx++) {
+        total_time += EstimateCopyTime(trans, size_list_[jdx]);
+      }
+    }
+    std::cout << "Estimated runtime of size sweep (s): " << total_time << std::endl;
+  }
+
+  // Iterate through the list of transactions and execute them
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t& trans = trans_list_[idx];
+    if ((trans.req_type_ == REQ_COPY_BIDIR) ||
+        (trans.req_type_ == REQ_COPY_UNIDIR) ||
+        (trans.req_type_ == REQ_COPY_ALL_BIDIR) ||
+        (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) {
+      if (trans.copy.uses_gpu_) {
+        RunCopyBenchmark(trans);
+      } else {
+        RunHostCopyBenchmark(trans);
+      }
+      ComputeCopyTime(trans);
+    }
+    if ((trans.req_type_ == REQ_READ) ||
+        (trans.req_type_ == REQ_WRITE)) {
+      RunIOBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_STREAM) {
+      RunStreamBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_LATENCY) {
+      RunLatencyBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_HOST_SOURCE) {
+      RunHostSourceBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_COLLECTIVE) {
+      RunCollectiveBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_BISECTION) {
+      RunBisectionBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_INTERFERENCE) {
+      RunInterferenceBenchmark(trans);
+    }
+    if (trans.req_type_ == REQ_HOST_LOAD) {
+      RunHostLoadBenchmark(trans);
+    }
+  }
+  std::cout << std::endl;
+
+  // Disable profiling of Async Copy Activity
+  if (print_cpu_time_ == false) {
+    err_ = backend_->ProfilingEnable(false);
+    ErrorCheck(err_);
+  }
+
+}
+
+void RocmBandwidthTest::Close() {
+
+  // Roc runtime is not initialized when replaying a topology
+  if (topology_replay_ != NULL) {
+    return;
+  }
+
+  hsa_status_t status = backend_->ShutDown();
+  ErrorCheck(status);
+  return;
+}
+
+// Sets up the bandwidth test object to enable running
+// the various test scenarios requested by user. The
+// things this proceedure takes care of are:
+//    
+//    Parse user arguments
+//    Discover RocR Device Topology
+//    Determine validity of requested test scenarios
+//    Build the list of transactions to execute
+//    Miscellaneous
+//
+void RocmBandwidthTest::SetUp() {
+
+  // Parse user arguments
+  ParseArguments();
+
+  // Validate input parameters
+  bool status = ValidateArguments();
+  if (status == false) {
+    PrintHelpScreen();
+    exit(1);
+  }
+
+  // Build list of transactions (copy, read, write) to execute
+  status = BuildTransList();
+  if (status == false) {
+    PrintHelpScreen();
+    exit(1);
+  }
+
+  // Report transactions and their estimated runtime
+  // if user has requested a dry run
+  if (dry_run_) {
+    PrintTransList();
+    DisplayRunEstimate();
+    exit(0);
+  }
+}
+
+RocmBandwidthTest::RocmBandwidthTest(int argc, char** argv, size_t num) : BaseTest(num) {
+
+  usr_argc_ = argc;
+  usr_argv_ = argv;
+
+  pool_index_ = 0;
+  cpu_index_ = -1;
+  agent_index_ = 0;
+  
+  req_read_ = REQ_INVALID;
+  req_write_ = REQ_INVALID;
+  req_copy_bidir_ = REQ_INVALID;
+  req_copy_unidir_ = REQ_INVALID;
+  req_copy_all_bidir_ = REQ_INVALID;
+  req_copy_all_unidir_ = REQ_INVALID;
+  
+  link_matrix_ = NULL;
+  access_matrix_ = NULL;
+  pool_access_ = NULL;
+  link_bw_matrix_ = NULL;
+  link_type_matrix_ = NULL;
+  active_agents_list_ = NULL;
+  
+  validate_ = false;
+  dry_run_ = false;
+  pool_matrix_ = false;
+  numa_sweep_ = false;
+  kernel_sweep_ = false;
+  stream_sweep_ = false;
+  latency_sweep_ = false;
+  source_sweep_ = false;
+  collective_sweep_ = false;
+  bisection_sweep_ = false;
+  interference_sweep_ = false;
+  host_load_sweep_ = false;
+  host_load_op_ = HOST_LOAD_COPY;
+  sweep_sizes_ = false;
+  report_efficiency_ = false;
+  print_cpu_time_ = false;
+
+  // Initialize version of the test
+  version_.major_id = 1;
+  version_.minor_id = 0;
+  version_.step_id = 0;
+  version_.reserved = 0;
+
+  bw_default_run_ = getenv("ROCM_BW_DEFAULT_RUN");
+  bw_blocking_run_ = getenv("ROCR_BW_RUN_BLOCKING");
+  skip_fine_grain_ = getenv("ROCM_SKIP_FINE_GRAINED_POOL");
+  topology_cache_ = getenv("ROCM_BW_TOPOLOGY_CACHE");
+  host_copy_threads_ = getenv("ROCM_BW_HOST_COPY_THREADS");
+  validate_hash_ = getenv("ROCM_BW_VALIDATE_HASH");
+  host_load_op_name_ = getenv("ROCM_BW_HOST_LOAD_OP");
+  host_load_threads_ = getenv("ROCM_BW_HOST_LOAD_THREADS");
+  bisection_seed_str_ = getenv("ROCM_BW_BISECTION_SEED");
+  bisection_split_count_ = 0;
+  bisection_sampled_ = false;
+  bisection_seed_ = 0;
+  validate_budget_ = 0;
+  topology_record_ = NULL;
+  topology_replay_ = NULL;
+  backend_ = Backend::Create();
+  host_engine_ = NULL;
+  host_buffers_ = new HostBufferProvider(backend_);
+
+  exit_value_ = 0;
+}
+
+RocmBandwidthTest::~RocmBandwidthTest() {
+  delete host_engine_;
+  delete host_buffers_;
+  delete backend_;
+}
+
+std::string RocmBandwidthTest::GetVersion() const {
+
+  std::stringstream stream;
+  stream << version_.major_id << ".";
+  stream << version_.minor_id << ".";
+  stream << version_.step_id;
+  return stream.str();
+}
+
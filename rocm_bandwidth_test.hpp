@@ -47,6 +47,10 @@
 #include "base_test.hpp"
 #include "hsatimer.hpp"
 #include "common.hpp"
+#include "backend.hpp"
+#include "host_copy.hpp"
+#include "host_load.hpp"
+#include "host_buffer.hpp"
 #include <vector>
 
 using namespace std;
@@ -59,6 +63,13 @@ typedef struct agent_info {
     agent_ = agent;
     index_ = index;
     device_type_ = device_type;
+    bdf_id_ = 0;
+    pcie_cur_speed_ = 0;
+    pcie_cur_width_ = 0;
+    pcie_max_speed_ = 0;
+    pcie_max_width_ = 0;
+    numa_node_ = 0;
+    host_pool_.handle = 0;
   }
 
   agent_info() {}
@@ -68,6 +79,20 @@ typedef struct agent_info {
   hsa_device_type_t device_type_;
   char name_[64];   // Size specified in public header file
 
+  // PCIe location and link of a Gpu device as reported
+  // by sysfs. Link speed is expressed in GT/s per lane
+  uint32_t bdf_id_;
+  double pcie_cur_speed_;
+  uint32_t pcie_cur_width_;
+  double pcie_max_speed_;
+  uint32_t pcie_max_width_;
+
+  // NUMA node of a Cpu device, or of the Cpu device nearest
+  // to a Gpu device, and the kernarg pool of a Cpu device
+  // which serves as system memory local to its node
+  uint32_t numa_node_;
+  hsa_amd_memory_pool_t host_pool_;
+
 } agent_info_t;
 
 typedef struct pool_info {
@@ -123,6 +148,9 @@ typedef struct async_trans {
     struct {
       bool bidir_;
       bool uses_gpu_;
+      uint32_t kernel_idx_;
+      uint32_t page_kind_;
+      uint32_t source_mode_;
       uint32_t src_idx_;
       uint32_t dst_idx_;
       hsa_amd_memory_pool_t src_pool_;
@@ -134,6 +162,7 @@ typedef struct async_trans {
       hsa_agent_t agent_;
       uint32_t pool_idx_;
       hsa_amd_memory_pool_t pool_;
+      uint32_t op_;
     } kernel;
   };
 
@@ -157,7 +186,32 @@ typedef struct async_trans {
   vector<double> min_time_;
   vector<double> peak_bandwidth_;
 
-  async_trans(uint32_t req_type) { req_type_ = req_type; }
+  // Mean time spent preparing buffers of copy for a device,
+  // such as locking them, included in the copy times above
+  vector<double> setup_time_;
+
+  // Set to false if data copied by any size of the
+  // transaction failed validation
+  bool data_valid_;
+
+  // Gpu devices on one side of a bisection, as a mask of their ranks
+  uint64_t side_mask_;
+
+  // Mean bandwidth of copy while other traffic runs alongside, per
+  // size and traffic: the copy of another path of an interference
+  // sweep, whose entry for its own path holds the bandwidth of copy
+  // running alone, or a level of load of host memory sweep
+  vector<double> shared_bandwidth_;
+
+  // Bytes per second read and written by load generator, per size
+  // and level of load of host memory sweep
+  vector<double> load_rate_;
+
+  async_trans(uint32_t req_type) {
+    req_type_ = req_type;
+    data_valid_ = true;
+    side_mask_ = 0;
+  }
 } async_trans_t;
 
 typedef enum Request_Type {
@@ -168,10 +222,28 @@ typedef enum Request_Type {
   REQ_COPY_UNIDIR = 4,
   REQ_COPY_ALL_BIDIR = 5,
   REQ_COPY_ALL_UNIDIR = 6,
-  REQ_INVALID = 7,
+  REQ_STREAM = 7,
+  REQ_LATENCY = 8,
+  REQ_HOST_SOURCE = 9,
+  REQ_COLLECTIVE = 10,
+  REQ_BISECTION = 11,
+  REQ_INTERFERENCE = 12,
+  REQ_HOST_LOAD = 13,
+  REQ_INVALID = 14,
 
 } Request_Type;
 
+// Collectives run across Gpu devices, composed of copies
+typedef enum Collective_Op {
+
+  COLLECTIVE_ALLREDUCE_RING = 0,
+  COLLECTIVE_BROADCAST_TREE = 1,
+  COLLECTIVE_ALL_TO_ALL = 2,
+  COLLECTIVE_REDUCE_SCATTER_RING = 3,
+  COLLECTIVE_OP_COUNT = 4,
+
+} Collective_Op;
+
 class RocmBandwidthTest : public BaseTest {
 
  public:
@@ -197,20 +269,67 @@ class RocmBandwidthTest : public BaseTest {
   // @brief: Return exit value, useful in case of error
   int32_t GetExitValue() { return exit_value_; }
 
+  // @brief: Root of sysfs tree, may be overridden to test
+  // the models built from sysfs against a recorded snapshot
+  static std::string GetSysfsRoot();
+
  private:
 
   // @brief: Print Help Menu Screen
   void PrintHelpScreen();
 
   // @brief: Discover the topology of pools on Rocm Platform
-  void DiscoverTopology();
+  void DiscoverTopology(bool eager);
 
-  // @brief: Populate link weight for the set of agents
-  void DiscoverLinkWeight();
+  // @brief: Populate link weight for the set of agents. Unless
+  // eager, links are discovered per pair of agents on first use
+  void DiscoverLinkWeight(bool eager);
   void BindLinkWeight(uint32_t idx1, uint32_t idx2);
-
-  // @brief: Populates the access matrix
-  void PopulateAccessMatrix();
+  void BindLinkPath(uint32_t idx1, uint32_t idx2);
+
+  // @brief: Populates the access matrix. Unless eager, access
+  // of agents to pools is queried on first use
+  void PopulateAccessMatrix(bool eager);
+
+  // @brief: Helpers to read and update access of agents to memory
+  // pools, which is packed as two bits per agent and pool
+  uint32_t GetPoolAccessWords() const;
+  hsa_amd_memory_pool_access_t GetPoolAccess(uint32_t agent_idx,
+                                             uint32_t pool_idx) const;
+  void SetPoolAccess(uint32_t agent_idx, uint32_t pool_idx,
+                     hsa_amd_memory_pool_access_t access);
+
+  // @brief: Determine access among a pair of memory pools, using the
+  // same values as access matrix: 0 for none, 1 for unidirectional
+  // and 2 for bidirectional access
+  uint32_t GetPoolPathAccess(uint32_t src_pool_idx, uint32_t dst_pool_idx) const;
+
+  // @brief: Persist topology of system so that later runs on the
+  // same system can skip discovery of access and link matrices
+  uint64_t GetTopologyFingerprint() const;
+  bool ReadTopology(const char* path, bool replay);
+  bool ReadTopologyRecords(std::istream& file,
+                           uint32_t num_agents, uint32_t num_pools);
+  void SaveTopology(const char* path) const;
+  void WritePoolAccess(std::ostream& file) const;
+  bool ReadPoolAccess(std::istream& file);
+
+  // @brief: Capacity model used to compute theoretical peak
+  // bandwidth of a data path from its links
+  void DiscoverPcieLink(agent_info_t& agent_info);
+  double GetPcieCapacity(uint32_t dev_idx) const;
+  double GetPathCapacity(uint32_t src_dev_idx,
+                         uint32_t dst_dev_idx, bool bidir) const;
+  double EstimateCopyTime(const async_trans_t& trans, uint32_t size) const;
+
+  // @brief: Helpers to place host buffers and the thread that
+  // submits copies on the NUMA node nearest to a transaction
+  void BindNumaNodes();
+  uint32_t GetTransHostIdx(const async_trans_t& trans) const;
+  uint32_t GetPoolHostIdx(uint32_t pool_idx) const;
+  hsa_amd_memory_pool_t GetHostPool(uint32_t host_idx) const;
+  bool PinToNumaNode(uint32_t numa_node);
+  void GetNumaCpuList(uint32_t numa_node, vector<uint32_t>& cpu_list) const;
 
   // @brief: Print topology info
   void PrintTopology();
@@ -218,6 +337,13 @@ class RocmBandwidthTest : public BaseTest {
   // @brief: Print link matrix
   void PrintLinkMatrix() const;
 
+  // @brief: Print properties of every hop of links among devices
+  void PrintLinkDescriptors() const;
+
+  // @brief: Describe the links traversed between two devices
+  // as the list of their types e.g. "PCIe > QPI > PCIe"
+  std::string GetLinkPathStr(uint32_t src_dev_idx, uint32_t dst_dev_idx) const;
+
   // @brief: Print access matrix
   void PrintAccessMatrix() const;
 
@@ -240,8 +366,62 @@ class RocmBandwidthTest : public BaseTest {
   // @brief: Run copy requests of users
   void RunCopyBenchmark(async_trans_t& trans);
 
+  // @brief: Run copy requests among Cpu devices on a set of
+  // threads pinned to the NUMA node of the source device
+  void RunHostCopyBenchmark(async_trans_t& trans);
+  void BindHostCopyEngine(uint32_t numa_node);
+
+  // @brief: Run STREAM operations on arrays of a memory pool
+  // using threads pinned to the NUMA node nearest to the pool
+  void RunStreamBenchmark(async_trans_t& trans);
+  void AcquireHostPoolAccess(uint32_t host_idx, uint32_t pool_idx, void* buf);
+
+  // @brief: Run a pointer chase over a buffer of a memory pool
+  // from a thread pinned to the NUMA node of a Cpu device
+  void RunLatencyBenchmark(async_trans_t& trans);
+  size_t GetLatencyBufferSize() const;
+
+  // @brief: Run copies to a Gpu from system memory of its NUMA
+  // node, sourced from pool, locked or staged buffers of host
+  void RunHostSourceBenchmark(async_trans_t& trans);
+  void CopyStaged(void* dst, hsa_agent_t dst_agent, const char* src,
+                  char** bounce_list, hsa_signal_t* signal_list,
+                  hsa_agent_t host_agent, size_t size);
+
+  // @brief: Run a collective across Gpu devices, composed of
+  // copies chained by dependency signals
+  void RunCollectiveBenchmark(async_trans_t& trans);
+  static const char* GetCollectiveName(uint32_t op);
+  static double GetCollectiveBusFactor(uint32_t op, uint32_t num_ranks);
+
+  // @brief: Run copies across a bipartition of Gpu devices, all
+  // pairs crossing it in both directions at once
+  void RunBisectionBenchmark(async_trans_t& trans);
+
+  // @brief: Run copy of a path alone and then alongside the copies
+  // of every other path of interference sweep
+  void RunInterferenceBenchmark(async_trans_t& trans);
+
+  // @brief: Run copy between a Cpu and a Gpu device while system
+  // memory of the Cpu is loaded at increasing levels
+  void RunHostLoadBenchmark(async_trans_t& trans);
+
+  // @brief: Time a copy by wall clock, from its submission until
+  // its completion signal is seen
+  double TimeAsyncCopy(void* dst, hsa_agent_t dst_agent,
+                       void* src, hsa_agent_t src_agent,
+                       size_t size, hsa_signal_t signal);
+
+  // @brief: Time copies back to back after one that warms up the
+  // path, returning minimum and mean of their times
+  void TimeAsyncCopies(void* dst, hsa_agent_t dst_agent,
+                       void* src, hsa_agent_t src_agent,
+                       size_t size, hsa_signal_t signal, uint32_t iterations,
+                       double& min_time, double& avg_time);
+
   // @brief: Get iteration number
-  uint32_t GetIterationNum();
+  uint32_t GetIterationNum() const;
+  uint32_t GetCopyIterationNum(uint32_t size) const;
 
   // @brief: Get the mean copy time
   double GetMeanTime(std::vector<double>& vec);
@@ -253,8 +433,27 @@ class RocmBandwidthTest : public BaseTest {
   void DisplayDevInfo() const;
   void DisplayIOTime(async_trans_t& trans) const;
   void DisplayCopyTime(async_trans_t& trans) const;
-  void DisplayCopyTimeMatrix(bool peak) const;
+  void DisplayCopyTimeMatrix(bool peak, uint32_t size_idx) const;
+  void DisplayCopyTimeMatrices(bool peak) const;
   void DisplayValidationMatrix() const;
+  void DisplayEfficiencyMatrix(bool peak, uint32_t size_idx) const;
+  void DisplayRunEstimate() const;
+  void DisplayNumaMatrix(bool host_to_dev, uint32_t page_kind) const;
+  void DisplayPoolKernelMatrix() const;
+  void DisplayLatencyMatrix(uint32_t stride) const;
+  void DisplayHostSourceMatrix() const;
+  void DisplayCollectiveMatrix() const;
+  void DisplayBisectionMatrix() const;
+  void DisplayInterferenceMatrix() const;
+  void DisplayHostLoadMatrix() const;
+
+  // @brief: Helpers to lay out result matrices either per device
+  // or per memory pool, as requested by user
+  uint32_t GetMatrixDim() const;
+  uint32_t GetMatrixIdx(uint32_t pool_idx) const;
+  void PrintPoolLegend() const;
+  void PrintMatrixHeader() const;
+  void PrintMatrixRowId(uint32_t idx) const;
  
  private:
 
@@ -276,6 +475,15 @@ class RocmBandwidthTest : public BaseTest {
   // @brief: Builds a list of transaction per user request
   void ComputeCopyTime(async_trans_t& trans);
   bool BuildTransList();
+  bool BuildNumaCopyTrans();
+  bool BuildHostKernelTrans();
+  bool BuildStreamTrans();
+  bool BuildLatencyTrans();
+  bool BuildHostSourceTrans();
+  bool BuildCollectiveTrans();
+  bool BuildBisectionTrans();
+  bool BuildInterferenceTrans();
+  bool BuildHostLoadTrans();
   bool BuildReadTrans();
   bool BuildWriteTrans();
   bool BuildBidirCopyTrans();
@@ -288,8 +496,8 @@ class RocmBandwidthTest : public BaseTest {
                       vector<uint32_t>& src_list,
                       vector<uint32_t>& dst_list);
 
-  void AllocateCopyBuffers(uint32_t size,
-                           uint32_t src_dev_idx, uint32_t dst_dev_idx,
+  void AllocateCopyBuffers(uint32_t size, uint32_t page_kind,
+                           uint32_t src_pool_idx, uint32_t dst_pool_idx,
                            void*& src, hsa_amd_memory_pool_t src_pool,
                            void*& dst, hsa_amd_memory_pool_t dst_pool,
                            hsa_agent_t src_agent, hsa_agent_t dst_agent,
@@ -299,9 +507,23 @@ class RocmBandwidthTest : public BaseTest {
                       void* dst_fwd, void* dst_rev,
                       hsa_signal_t signal_fwd, hsa_signal_t signal_rev);
   double GetGpuCopyTime(bool bidir, hsa_signal_t signal_fwd, hsa_signal_t signal_rev);
-  void AllocateHostBuffers(uint32_t size,
-                           uint32_t src_dev_idx,
-                           uint32_t dst_dev_idx,
+  bool CompareValidation(uint64_t seed, const void* actual,
+                         size_t size, hsa_signal_t signal);
+  bool HashValidation(const void* expected, void* buf, hsa_agent_t buf_agent,
+                      hsa_agent_t host_agent, void* const* chunk_list,
+                      const hsa_signal_t* chunk_signal_list,
+                      size_t size, hsa_signal_t signal);
+  void LoadSampleWindow(uint64_t seed, size_t offset, void* buf,
+                        hsa_agent_t buf_agent, hsa_agent_t host_agent,
+                        void* window, size_t window_size,
+                        hsa_signal_t signal);
+  bool SampleValidation(uint64_t seed, size_t offset, void* buf,
+                        hsa_agent_t buf_agent, hsa_agent_t host_agent,
+                        void* window, size_t window_size,
+                        hsa_signal_t signal);
+  void AllocateHostBuffers(uint32_t size, uint32_t dst_size, uint32_t host_idx,
+                           uint32_t src_pool_idx,
+                           uint32_t dst_pool_idx,
                            void*& src, void*& dst,
                            void* buf_src, void* buf_dst,
                            hsa_agent_t src_agent, hsa_agent_t dst_agent,
@@ -316,8 +538,13 @@ class RocmBandwidthTest : public BaseTest {
   // @brief: Check if agent and access memory pool, if so, set 
   // access to the agent, if not, exit
   void AcquireAccess(hsa_agent_t agent, void* ptr);
-  void AcquirePoolAcceses(uint32_t src_dev_idx, hsa_agent_t src_agent, void* src,
-                          uint32_t dst_dev_idx, hsa_agent_t dst_agent, void* dst);
+  void AcquirePoolAcceses(uint32_t src_pool_idx, void* src,
+                          uint32_t dst_pool_idx, void* dst);
+
+  // @brief: Set access among a buffer of memory pool and a buffer
+  // of system memory used for validation
+  void AcquireHostAccess(uint32_t host_idx, uint32_t pool_idx,
+                         void* buf, void* host);
 
   // Functions to find agents and memory pools and udpate
   // relevant data structures used to maintain system topology
@@ -411,6 +638,24 @@ class RocmBandwidthTest : public BaseTest {
   // Matrix used to track Access among agents
   uint32_t* access_matrix_;
   uint32_t* link_matrix_;
+
+  // Access of every agent to every memory pool, packed two
+  // bits per entry holding a hsa_amd_memory_pool_access_t
+  uint32_t* pool_access_;
+
+  // Matrices used to track the types of links traversed
+  // between agents, as a mask of (1 << link type), and the
+  // least max bandwidth reported by those links in MB/s
+  uint32_t* link_type_matrix_;
+  uint32_t* link_bw_matrix_;
+
+  // Descriptors of every hop of the link between agents,
+  // as reported by Roc runtime, indexed as link matrix
+  vector<vector<hsa_amd_memory_pool_link_info_t> > link_hops_;
+
+  // Links among agents that have been discovered, indexed as link
+  // matrix. It is empty if links among all agents are known
+  vector<bool> link_bound_;
   
   // Env key to determine if Fine-grained or
   // Coarse-grained pool should be filtered out
@@ -423,6 +668,36 @@ class RocmBandwidthTest : public BaseTest {
   // Env key to determine if the run is a default one
   char* bw_default_run_;
 
+  // Env key to locate file used to cache topology of system
+  char* topology_cache_;
+
+  // Env key to set the number of threads copying among Cpu
+  // devices, defaults to the number of cores of a NUMA node
+  char* host_copy_threads_;
+
+  // Env key to validate copies by hashing their destination as it
+  // is read back in chunks, instead of reading back all of it
+  char* validate_hash_;
+
+  // Env keys to set the stream run by load generator of host memory
+  // sweep, copy by default, and its number of threads, which
+  // defaults to the cores of a NUMA node less one
+  char* host_load_op_name_;
+  char* host_load_threads_;
+
+  // Fraction of time of copies that may be spent validating a random
+  // sample of them, zero if copies are not sampled
+  double validate_budget_;
+
+  // Files to record topology of system into, or to replay
+  // topology from instead of discovering it
+  char* topology_record_;
+  char* topology_replay_;
+
+  // Determines if transactions are only built and their
+  // runtime estimated without executing them
+  bool dry_run_;
+
   // Variable to store argument number
   uint32_t usr_argc_;
 
@@ -435,6 +710,86 @@ class RocmBandwidthTest : public BaseTest {
   // Determines if user has requested validation
   bool validate_;
 
+  // Determines if measured bandwidth is reported against
+  // theoretical capacity of the data path
+  bool report_efficiency_;
+
+  // Determines if all-pairs modes sweep every buffer size
+  // instead of using only the default size
+  bool sweep_sizes_;
+
+  // Determines if result matrices are indexed by memory
+  // pool rather than by the device owning the pool
+  bool pool_matrix_;
+
+  // Determines if every Gpu is measured against the
+  // system memory of every NUMA node
+  bool numa_sweep_;
+
+  // Kinds of pages backing host buffers of NUMA sweep, which
+  // is run once per kind
+  vector<uint32_t> page_kind_list_;
+
+  // Determines if every host copy kernel supported by the
+  // Cpu is measured against every pool it can access
+  bool kernel_sweep_;
+
+  // Determines if STREAM operations are measured against
+  // every pool accessible to Cpu
+  bool stream_sweep_;
+
+  // Determines if latency of loads by every Cpu device is
+  // measured against every pool it can access
+  bool latency_sweep_;
+
+  // Determines if copies to every Gpu are measured from pool,
+  // locked and staged buffers of system memory
+  bool source_sweep_;
+
+  // Determines if collectives are measured across Gpu devices,
+  // whose memory pools are listed in order of their ranks
+  bool collective_sweep_;
+  vector<uint32_t> collective_pool_list_;
+
+  // Determines if bandwidth is measured across bipartitions of Gpu
+  // devices, whose memory pools are listed in order of their ranks.
+  // User may list devices of one side, else balanced bipartitions
+  // are enumerated
+  bool bisection_sweep_;
+  vector<uint32_t> bisection_side_list_;
+  vector<uint32_t> bisection_pool_list_;
+
+  // Number of balanced bipartitions of Gpu devices and the seed
+  // used to draw a sample of them when they are too many to be
+  // measured. Env key sets the seed, which is random by default
+  uint64_t bisection_split_count_;
+  bool bisection_sampled_;
+  uint64_t bisection_seed_;
+  char* bisection_seed_str_;
+
+  // Determines if copy paths are measured while another path runs,
+  // among devices listed by user or all devices. Transactions of
+  // the paths are listed by their index in transaction list
+  bool interference_sweep_;
+  vector<uint32_t> interference_dev_list_;
+  vector<uint32_t> interference_trans_list_;
+
+  // Determines if copies between Cpu and Gpu devices are measured
+  // under load of system memory, at levels listed in percent of the
+  // unthrottled rate of load generator
+  bool host_load_sweep_;
+  vector<uint32_t> load_level_list_;
+  uint32_t host_load_op_;
+
+  // Runtime serving the test, Roc runtime or a simulator
+  Backend* backend_;
+
+  // Engine copying among Cpu devices, created on first use
+  HostCopyEngine* host_engine_;
+
+  // Provider of host buffers backed by pages of a given kind
+  HostBufferProvider* host_buffers_;
+
   // CPU agent used for validation
   int32_t cpu_index_;
   hsa_agent_t cpu_agent_;
@@ -445,6 +800,9 @@ class RocmBandwidthTest : public BaseTest {
   // static const uint32_t SIZE_LIST[4];
   static const uint32_t SIZE_LIST[20];
 
+  // Strides of pointer chase chains measuring latency
+  static const uint32_t LATENCY_STRIDE_LIST[2];
+
   // Exit value to return in case of error
   int32_t exit_value_;
 };
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// @brief: Run copies across a bipartition of Gpu devices. Every pair
+// of devices on opposite sides whose pools reach each other copies in
+// both directions, all copies of an iteration running at once. Every
+// copy has its own destination buffer, while copies out of a device
+// share its source buffer. Time of an iteration spans the submission
+// of its copies until all are done, and bandwidth is the sum of bytes
+// crossing the cut over it
+void RocmBandwidthTest::RunBisectionBenchmark(async_trans_t& trans) {
+
+  uint32_t num_ranks = bisection_pool_list_.size();
+  uint32_t max_size = size_list_.back();
+  PinToNumaNode(agent_list_[GetPoolHostIdx(bisection_pool_list_[0])].numa_node_);
+
+  vector<void*> src_list(num_ranks);
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    err_ = backend_->PoolAllocate(pool_list_[bisection_pool_list_[rank]].pool_,
+                                  max_size, 0, &src_list[rank]);
+    ErrorCheck(err_);
+  }
+
+  vector<uint32_t> src_rank_list;
+  vector<uint32_t> dst_rank_list;
+  vector<void*> dst_list;
+  vector<hsa_signal_t> signal_list;
+  for (uint32_t src = 0; src < num_ranks; src++) {
+    for (uint32_t dst = 0; dst < num_ranks; dst++) {
+      uint32_t src_pool = bisection_pool_list_[src];
+      uint32_t dst_pool = bisection_pool_list_[dst];
+      if ((((trans.side_mask_ >> src) & 1) == ((trans.side_mask_ >> dst) & 1)) ||
+          (GetPoolPathAccess(src_pool, dst_pool) == 0)) {
+        continue;
+      }
+      void* buf;
+      err_ = backend_->PoolAllocate(pool_list_[dst_pool].pool_, max_size, 0, &buf);
+      ErrorCheck(err_);
+      AcquirePoolAcceses(src_pool, src_list[src], dst_pool, buf);
+      hsa_signal_t signal;
+      err_ = backend_->SignalCreate(0, &signal);
+      ErrorCheck(err_);
+      src_rank_list.push_back(src);
+      dst_rank_list.push_back(dst);
+      dst_list.push_back(buf);
+      signal_list.push_back(signal);
+    }
+  }
+
+  uint32_t num_copies = signal_list.size();
+  uint32_t iterations = GetIterationNum();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    cout << endl << "RUNNING " << iterations << " ITERATIONS of "
+         << num_copies << " copies across bisection of " << num_ranks
+         << " Gpu devices for buffer size " << curr_size << endl;
+
+    double total_time = 0;
+    double min_time = std::numeric_limits<double>::max();
+    for (uint32_t it = 0; it < iterations; it++) {
+
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        backend_->SignalStore(signal_list[copy_idx], 1);
+      }
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        uint32_t src = src_rank_list[copy_idx];
+        uint32_t dst = dst_rank_list[copy_idx];
+        err_ = backend_->AsyncCopy(dst_list[copy_idx],
+                                   pool_list_[bisection_pool_list_[dst]].owner_agent_,
+                                   src_list[src],
+                                   pool_list_[bisection_pool_list_[src]].owner_agent_,
+                                   curr_size, 0, NULL, signal_list[copy_idx]);
+        ErrorCheck(err_);
+      }
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        while (backend_->SignalWait(signal_list[copy_idx], HSA_SIGNAL_CONDITION_LT, 1,
+                                    HSA_WAIT_STATE_ACTIVE));
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      total_time += elapsed.count();
+      min_time = std::min(min_time, elapsed.count());
+    }
+
+    double avg_time = total_time / iterations;
+    double total_size = (double)curr_size * num_copies;
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.avg_bandwidth_.push_back(total_size / avg_time / 1000 / 1000 / 1000);
+    trans.peak_bandwidth_.push_back(total_size / min_time / 1000 / 1000 / 1000);
+  }
+
+  for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+    err_ = backend_->SignalDestroy(signal_list[copy_idx]);
+    ErrorCheck(err_);
+    err_ = backend_->PoolFree(dst_list[copy_idx]);
+    ErrorCheck(err_);
+  }
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    err_ = backend_->PoolFree(src_list[rank]);
+    ErrorCheck(err_);
+  }
+}
@@ -0,0 +1,440 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+#include <fstream>
+#include <sstream>
+
+// Identifies the format of a topology file, bump the
+// version if the layout of the file is changed
+static const char* TOPOLOGY_FILE_MAGIC = "rocm_bandwidth_test_topology";
+static const uint32_t TOPOLOGY_FILE_VERSION = 3;
+
+// @brief: Accumulate a string into FNV-1a hash
+static void HashString(uint64_t& hash, const std::string& str) {
+
+  for (size_t idx = 0; idx < str.size(); idx++) {
+    hash ^= (uint8_t)str[idx];
+    hash *= 0x100000001b3ULL;
+  }
+  hash ^= 0xFF;
+  hash *= 0x100000001b3ULL;
+}
+
+template <typename T>
+static void HashValue(uint64_t& hash, T value) {
+
+  std::stringstream stream;
+  stream << value;
+  HashString(hash, stream.str());
+}
+
+// @brief: Read the first line of a file, empty if it cannot be read
+static std::string ReadLine(const char* path) {
+
+  std::string line;
+  std::ifstream file(path);
+  if (file.good()) {
+    std::getline(file, line);
+  }
+  return line;
+}
+
+// @brief: Describe the version of kernel driver. Generation id of
+// KFD topology changes whenever devices are added or removed
+static std::string GetDriverVersion() {
+
+  std::stringstream version;
+  struct utsname name;
+  if (uname(&name) == 0) {
+    version << name.release;
+  }
+  version << ";" << ReadLine("/sys/module/amdgpu/version");
+  version << ";" << ReadLine("/sys/class/kfd/kfd/topology/generation_id");
+  return version.str();
+}
+
+uint64_t RocmBandwidthTest::GetTopologyFingerprint() const {
+
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  HashString(hash, GetDriverVersion());
+
+  uint32_t count = agent_list_.size();
+  for (uint32_t idx = 0; idx < count; idx++) {
+    const agent_info_t& agent = agent_list_[idx];
+    HashValue(hash, agent.device_type_);
+    HashValue(hash, agent.bdf_id_);
+    HashString(hash, agent.name_);
+  }
+
+  count = pool_list_.size();
+  for (uint32_t idx = 0; idx < count; idx++) {
+    const pool_info_t& pool = pool_list_[idx];
+    HashValue(hash, pool.agent_index_);
+    HashValue(hash, pool.allocable_size_);
+    HashValue(hash, pool.is_fine_grained_);
+    HashValue(hash, pool.is_kernarg_);
+    HashValue(hash, pool.access_to_all_);
+    HashValue(hash, pool.owner_access_);
+  }
+  return hash;
+}
+
+static void WriteMatrix(std::ostream& file, const char* key,
+                        const uint32_t* matrix, uint32_t dim) {
+
+  file << key;
+  for (uint32_t idx = 0; idx < (dim * dim); idx++) {
+    file << " " << matrix[idx];
+  }
+  file << std::endl;
+}
+
+static bool ReadMatrix(std::istream& file, const char* key,
+                       uint32_t* matrix, uint32_t dim) {
+
+  std::string token;
+  file >> token;
+  if (token != key) {
+    return false;
+  }
+  for (uint32_t idx = 0; idx < (dim * dim); idx++) {
+    file >> matrix[idx];
+  }
+  return (file.fail() == false);
+}
+
+// @brief: Hops of links are written as their count followed by
+// the properties of each hop, for every pair of agents
+static void WriteLinkHops(std::ostream& file,
+                          const vector<vector<hsa_amd_memory_pool_link_info_t> >& link_hops) {
+
+  file << "link_hops";
+  for (uint32_t idx = 0; idx < link_hops.size(); idx++) {
+    const vector<hsa_amd_memory_pool_link_info_t>& hops = link_hops[idx];
+    file << " " << hops.size();
+    for (uint32_t hop_idx = 0; hop_idx < hops.size(); hop_idx++) {
+      const hsa_amd_memory_pool_link_info_t& hop = hops[hop_idx];
+      file << " " << hop.link_type << " " << hop.numa_distance;
+      file << " " << hop.min_latency << " " << hop.max_latency;
+      file << " " << hop.min_bandwidth << " " << hop.max_bandwidth;
+      file << " " << hop.atomic_support_32bit << " " << hop.atomic_support_64bit;
+      file << " " << hop.coherent_support;
+    }
+  }
+  file << std::endl;
+}
+
+static bool ReadLinkHops(std::istream& file, uint32_t dim,
+                         vector<vector<hsa_amd_memory_pool_link_info_t> >& link_hops) {
+
+  std::string token;
+  file >> token;
+  if (token != "link_hops") {
+    return false;
+  }
+
+  link_hops.resize(dim * dim);
+  for (uint32_t idx = 0; idx < (dim * dim); idx++) {
+    uint32_t count = 0;
+    file >> count;
+    if (file.fail()) {
+      return false;
+    }
+    link_hops[idx].resize(count);
+    for (uint32_t hop_idx = 0; hop_idx < count; hop_idx++) {
+      hsa_amd_memory_pool_link_info_t& hop = link_hops[idx][hop_idx];
+      uint32_t link_type = 0;
+      file >> link_type >> hop.numa_distance;
+      file >> hop.min_latency >> hop.max_latency;
+      file >> hop.min_bandwidth >> hop.max_bandwidth;
+      file >> hop.atomic_support_32bit >> hop.atomic_support_64bit;
+      file >> hop.coherent_support;
+      hop.link_type = (hsa_amd_link_info_type_t)link_type;
+    }
+  }
+  return (file.fail() == false);
+}
+
+// @brief: Access of agents to pools is written one value per entry
+// rather than as packed words, so the file stays readable
+void RocmBandwidthTest::WritePoolAccess(std::ostream& file) const {
+
+  file << "pool_access";
+  for (uint32_t agent_idx = 0; agent_idx < agent_index_; agent_idx++) {
+    for (uint32_t pool_idx = 0; pool_idx < pool_index_; pool_idx++) {
+      file << " " << GetPoolAccess(agent_idx, pool_idx);
+    }
+  }
+  file << std::endl;
+}
+
+bool RocmBandwidthTest::ReadPoolAccess(std::istream& file) {
+
+  std::string token;
+  file >> token;
+  if (token != "pool_access") {
+    return false;
+  }
+
+  pool_access_ = new uint32_t[GetPoolAccessWords()]();
+  for (uint32_t agent_idx = 0; agent_idx < agent_index_; agent_idx++) {
+    for (uint32_t pool_idx = 0; pool_idx < pool_index_; pool_idx++) {
+      uint32_t access = 0;
+      file >> access;
+      if (access > HSA_AMD_MEMORY_POOL_ACCESS_DISALLOWED_BY_DEFAULT) {
+        file.setstate(std::ios::failbit);
+      }
+      SetPoolAccess(agent_idx, pool_idx, (hsa_amd_memory_pool_access_t)access);
+    }
+  }
+  if (file.fail()) {
+    delete[] pool_access_;
+    pool_access_ = NULL;
+    return false;
+  }
+  return true;
+}
+
+// @brief: Write topology of system into a file. The file is written
+// under a temporary name and renamed so that a concurrent reader
+// never observes a partially written file
+void RocmBandwidthTest::SaveTopology(const char* path) const {
+
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid();
+  std::ofstream file(tmp_path.str().c_str());
+  if (file.good() == false) {
+    std::cerr << "WARNING: Unable to write topology file: " << path << std::endl;
+    return;
+  }
+
+  file << TOPOLOGY_FILE_MAGIC << " " << TOPOLOGY_FILE_VERSION << std::endl;
+  file << "fingerprint " << std::hex << GetTopologyFingerprint() << std::dec << std::endl;
+  file << "agents " << agent_index_ << " pools " << pool_index_ << std::endl;
+
+  for (uint32_t idx = 0; idx < agent_index_; idx++) {
+    const agent_info_t& agent = agent_list_[idx];
+    file << "agent " << agent.index_ << " " << agent.device_type_;
+    file << " " << agent.bdf_id_;
+    file << " " << agent.pcie_cur_speed_ << " " << agent.pcie_cur_width_;
+    file << " " << agent.pcie_max_speed_ << " " << agent.pcie_max_width_;
+    file << " " << agent.name_ << std::endl;
+  }
+
+  for (uint32_t idx = 0; idx < pool_index_; idx++) {
+    const pool_info_t& pool = pool_list_[idx];
+    file << "pool " << pool.index_ << " " << pool.agent_index_;
+    file << " " << pool.segment_ << " " << pool.allocable_size_;
+    file << " " << pool.is_fine_grained_ << " " << pool.is_kernarg_;
+    file << " " << pool.access_to_all_ << " " << pool.owner_access_ << std::endl;
+  }
+
+  WriteMatrix(file, "access", access_matrix_, agent_index_);
+  WriteMatrix(file, "link", link_matrix_, agent_index_);
+  WriteMatrix(file, "link_type", link_type_matrix_, agent_index_);
+  WriteMatrix(file, "link_bw", link_bw_matrix_, agent_index_);
+  WriteLinkHops(file, link_hops_);
+  WritePoolAccess(file);
+  file.close();
+
+  if ((file.fail()) || (rename(tmp_path.str().c_str(), path) != 0)) {
+    std::cerr << "WARNING: Unable to write topology file: " << path << std::endl;
+    unlink(tmp_path.str().c_str());
+  }
+}
+
+// @brief: Bind topology of system from a topology file. A cache is
+// used only if its fingerprint matches that of the agents and pools
+// discovered, which is checked before anything else is read. A
+// snapshot being replayed instead provides the agents and pools
+bool RocmBandwidthTest::ReadTopology(const char* path, bool replay) {
+
+  std::ifstream file(path);
+  if (file.good() == false) {
+    return false;
+  }
+
+  std::string magic;
+  uint32_t version = 0;
+  file >> magic >> version;
+  if ((magic != TOPOLOGY_FILE_MAGIC) || (version != TOPOLOGY_FILE_VERSION)) {
+    return false;
+  }
+
+  std::string key;
+  uint64_t fingerprint = 0;
+  file >> key >> std::hex >> fingerprint >> std::dec;
+  if ((key != "fingerprint") ||
+      ((replay == false) && (fingerprint != GetTopologyFingerprint()))) {
+    return false;
+  }
+
+  uint32_t num_agents = 0;
+  uint32_t num_pools = 0;
+  std::string key2;
+  file >> key >> num_agents >> key2 >> num_pools;
+  if ((replay == false) &&
+      ((num_agents != agent_index_) || (num_pools != pool_index_))) {
+    return false;
+  }
+
+  std::string line;
+  std::getline(file, line);
+  if (replay) {
+    if (ReadTopologyRecords(file, num_agents, num_pools) == false) {
+      return false;
+    }
+  } else {
+    // Skip agent and pool records, live ones are already bound
+    for (uint32_t idx = 0; idx < (num_agents + num_pools); idx++) {
+      std::getline(file, line);
+    }
+  }
+
+  uint32_t dim = num_agents;
+  uint32_t* access = new uint32_t[dim * dim]();
+  uint32_t* link = new uint32_t[dim * dim]();
+  uint32_t* link_type = new uint32_t[dim * dim]();
+  uint32_t* link_bw = new uint32_t[dim * dim]();
+  bool status = ((ReadMatrix(file, "access", access, dim)) &&
+                 (ReadMatrix(file, "link", link, dim)) &&
+                 (ReadMatrix(file, "link_type", link_type, dim)) &&
+                 (ReadMatrix(file, "link_bw", link_bw, dim)) &&
+                 (ReadLinkHops(file, dim, link_hops_)) &&
+                 (ReadPoolAccess(file)));
+  if (status == false) {
+    delete[] access;
+    delete[] link;
+    delete[] link_type;
+    delete[] link_bw;
+    link_hops_.clear();
+    return false;
+  }
+
+  access_matrix_ = access;
+  link_matrix_ = link;
+  link_type_matrix_ = link_type;
+  link_bw_matrix_ = link_bw;
+  return true;
+}
+
+// @brief: Rebuild lists of agents and pools from the records of a
+// snapshot. Runtime handles are synthesized from the index of the
+// agent or pool, they identify the object but cannot be passed
+// to Roc runtime
+bool RocmBandwidthTest::ReadTopologyRecords(std::istream& file,
+                                            uint32_t num_agents,
+                                            uint32_t num_pools) {
+
+  std::string key;
+  for (uint32_t idx = 0; idx < num_agents; idx++) {
+    uint32_t index = 0;
+    uint32_t device_type = 0;
+    file >> key >> index >> device_type;
+    if ((key != "agent") || (index != idx)) {
+      return false;
+    }
+
+    hsa_agent_t agent;
+    agent.handle = idx + 1;
+    agent_info_t agent_info(agent, idx, (hsa_device_type_t)device_type);
+    file >> agent_info.bdf_id_;
+    file >> agent_info.pcie_cur_speed_ >> agent_info.pcie_cur_width_;
+    file >> agent_info.pcie_max_speed_ >> agent_info.pcie_max_width_;
+
+    // Name is the remainder of the record
+    std::string name;
+    std::getline(file, name);
+    size_t start = name.find_first_not_of(' ');
+    name = (start == std::string::npos) ? std::string() : name.substr(start);
+    snprintf(agent_info.name_, sizeof(agent_info.name_), "%s", name.c_str());
+
+    if (agent_info.device_type_ == HSA_DEVICE_TYPE_CPU) {
+      cpu_agent_ = agent;
+      cpu_index_ = idx;
+    }
+    agent_list_.push_back(agent_info);
+
+    agent_pool_info node;
+    node.agent = agent_info;
+    agent_pool_list_.push_back(node);
+  }
+
+  for (uint32_t idx = 0; idx < num_pools; idx++) {
+    uint32_t index = 0;
+    uint32_t agent_idx = 0;
+    uint32_t segment = 0;
+    size_t size = 0;
+    bool is_fine_grained = false;
+    bool is_kernarg = false;
+    bool access_to_all = false;
+    uint32_t owner_access = 0;
+    file >> key >> index >> agent_idx >> segment >> size;
+    file >> is_fine_grained >> is_kernarg >> access_to_all >> owner_access;
+    if ((key != "pool") || (index != idx) || (agent_idx >= num_agents)) {
+      return false;
+    }
+
+    hsa_amd_memory_pool_t pool;
+    pool.handle = idx + 1;
+    pool_info_t pool_info(agent_list_[agent_idx].agent_, agent_idx, pool,
+                          (hsa_amd_segment_t)segment, size, idx,
+                          is_fine_grained, is_kernarg, access_to_all,
+                          (hsa_amd_memory_pool_access_t)owner_access);
+    if (is_kernarg) {
+      sys_pool_ = pool;
+      agent_list_[agent_idx].host_pool_ = pool;
+    }
+    pool_list_.push_back(pool_info);
+    agent_pool_list_[agent_idx].pool_list.push_back(pool_info);
+  }
+
+  agent_index_ = num_agents;
+  pool_index_ = num_pools;
+  return (file.fail() == false);
+}
@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <dirent.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+// Capacity assumed for an XGMI link when its max bandwidth
+// is not reported by the runtime, in GB/s per direction
+static const double XGMI_LINK_CAPACITY = 25.0;
+
+// Capacity assumed when estimating the runtime of a copy whose
+// path capacity is not known e.g. a copy within a device, in GB/s
+static const double DEFAULT_PATH_CAPACITY = 10.0;
+
+// Time taken to launch a copy and wait on its completion, in seconds
+static const double COPY_LAUNCH_OVERHEAD = 10e-6;
+
+std::string RocmBandwidthTest::GetSysfsRoot() {
+
+  char* root = getenv("ROCM_BW_SYSFS_ROOT");
+  return (root == NULL) ? std::string("/sys") : std::string(root);
+}
+
+// @brief: Locate sysfs folder of a PCIe device given its bus, device
+// and function. Domain is not known to the runtime so prefer domain
+// zero and fall back on any domain that hosts the same BDF
+static std::string GetPciDevicePath(uint32_t bdf_id) {
+
+  char bdf[16];
+  snprintf(bdf, sizeof(bdf), "%02x:%02x.%x",
+           (bdf_id >> 8) & 0xFF, (bdf_id >> 3) & 0x1F, bdf_id & 0x7);
+
+  std::string devices = RocmBandwidthTest::GetSysfsRoot() + "/bus/pci/devices/";
+  std::string path = devices + "0000:" + bdf;
+  std::ifstream probe((path + "/current_link_speed").c_str());
+  if (probe.good()) {
+    return path;
+  }
+
+  DIR* dir = opendir(devices.c_str());
+  if (dir == NULL) {
+    return std::string();
+  }
+
+  std::string match;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    const char* name = strchr(entry->d_name, ':');
+    if ((name != NULL) && (strcmp(name + 1, bdf) == 0)) {
+      match = devices + entry->d_name;
+      break;
+    }
+  }
+  closedir(dir);
+  return match;
+}
+
+// @brief: Read the leading numeric value of a sysfs attribute such
+// as "8.0 GT/s PCIe" or "16". Returns zero if it cannot be read
+static double ReadSysfsValue(const std::string& path) {
+
+  double value = 0;
+  std::ifstream file(path.c_str());
+  if (file.good()) {
+    file >> value;
+  }
+  return (file.fail()) ? 0 : value;
+}
+
+void RocmBandwidthTest::DiscoverPcieLink(agent_info_t& agent_info) {
+
+  hsa_status_t status;
+  status = backend_->AgentGetInfo(agent_info.agent_,
+                                  (hsa_agent_info_t)HSA_AMD_AGENT_INFO_BDFID,
+                                  &agent_info.bdf_id_);
+  if (status != HSA_STATUS_SUCCESS) {
+    return;
+  }
+
+  std::string path = GetPciDevicePath(agent_info.bdf_id_);
+  if (path.empty()) {
+    return;
+  }
+
+  agent_info.pcie_cur_speed_ = ReadSysfsValue(path + "/current_link_speed");
+  agent_info.pcie_cur_width_ = ReadSysfsValue(path + "/current_link_width");
+  agent_info.pcie_max_speed_ = ReadSysfsValue(path + "/max_link_speed");
+  agent_info.pcie_max_width_ = ReadSysfsValue(path + "/max_link_width");
+}
+
+// @brief: Theoretical bandwidth in GB/s, per direction, of the
+// PCIe link of a device. Capacity is computed from what the link
+// supports rather than what it trained to, so that a link running
+// at a reduced speed or width shows up as a loss of efficiency
+double RocmBandwidthTest::GetPcieCapacity(uint32_t dev_idx) const {
+
+  const agent_info_t& agent = agent_list_[dev_idx];
+  if ((agent.pcie_max_speed_ == 0) || (agent.pcie_max_width_ == 0)) {
+    return 0;
+  }
+
+  // Gen1 and Gen2 links use 8b/10b encoding, later ones 128b/130b
+  double encoding = (agent.pcie_max_speed_ < 8) ? (8.0 / 10.0) : (128.0 / 130.0);
+  return (agent.pcie_max_speed_ * encoding * agent.pcie_max_width_) / 8;
+}
+
+// @brief: Theoretical bandwidth in GB/s of the data path between
+// two devices, determined by the narrowest link it traverses.
+// Returns zero if the capacity of the path cannot be determined
+double RocmBandwidthTest::GetPathCapacity(uint32_t src_dev_idx,
+                                          uint32_t dst_dev_idx,
+                                          bool bidir) const {
+
+  // Copies within a device do not traverse a link
+  if (src_dev_idx == dst_dev_idx) {
+    return 0;
+  }
+
+  // Link properties are reported for an agent accessing the pool
+  // of its peer, consult reverse direction if one is missing
+  uint32_t path_idx = (src_dev_idx * agent_index_) + dst_dev_idx;
+  if (link_type_matrix_[path_idx] == 0) {
+    path_idx = (dst_dev_idx * agent_index_) + src_dev_idx;
+  }
+  uint32_t link_types = link_type_matrix_[path_idx];
+
+  // Paths made up only of XGMI links are bound by those links,
+  // all others are bound by the PCIe links of their Gpu devices
+  double capacity = 0;
+  if (link_types == (1U << HSA_AMD_LINK_INFO_TYPE_XGMI)) {
+    uint32_t link_bw = link_bw_matrix_[path_idx];
+    capacity = (link_bw != 0) ? (link_bw / 1000.0) : XGMI_LINK_CAPACITY;
+  } else {
+    uint32_t dev_list[2] = { src_dev_idx, dst_dev_idx };
+    for (uint32_t idx = 0; idx < 2; idx++) {
+      if (agent_list_[dev_list[idx]].device_type_ != HSA_DEVICE_TYPE_GPU) {
+        continue;
+      }
+      double pcie_capacity = GetPcieCapacity(dev_list[idx]);
+      if (pcie_capacity == 0) {
+        return 0;
+      }
+      capacity = (capacity == 0) ? pcie_capacity : min(capacity, pcie_capacity);
+    }
+  }
+
+  // Links are full duplex, bidirectional copies can use both directions
+  return (bidir) ? (capacity * 2) : capacity;
+}
+
+// @brief: Estimate time in seconds taken to run all iterations of a
+// copy transaction for one buffer size. The estimate assumes copies
+// run at the theoretical capacity of their path
+double RocmBandwidthTest::EstimateCopyTime(const async_trans_t& trans,
+                                           uint32_t size) const {
+
+  bool bidir = trans.copy.bidir_;
+  uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+  uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+  double capacity = GetPathCapacity(src_dev_idx, dst_dev_idx, bidir);
+  if (capacity == 0) {
+    capacity = (bidir) ? (DEFAULT_PATH_CAPACITY * 2) : DEFAULT_PATH_CAPACITY;
+  }
+
+  double data_size = (bidir) ? (2.0 * size) : size;
+  double copy_time = (data_size / (capacity * 1000 * 1000 * 1000)) +
+                     COPY_LAUNCH_OVERHEAD;
+
+  // Validation copies the destination buffer back to host
+  if (validate_) {
+    copy_time *= 2;
+  }
+  return (copy_time * GetCopyIterationNum(size));
+}
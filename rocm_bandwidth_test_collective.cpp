@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Size of chunks pipelined down the tree of a broadcast, letting a
+// device forward a chunk while it receives the next one
+static const size_t COLLECTIVE_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// @brief: A copy of a collective, from the buffer of a device into
+// the buffer or scratch buffer of another. Copy starts once the copy
+// at index dep_ of the schedule is done, unless dep_ is negative
+typedef struct collective_copy {
+  uint32_t src_rank_;
+  uint32_t dst_rank_;
+  bool dst_scratch_;
+  size_t src_offset_;
+  size_t dst_offset_;
+  size_t size_;
+  int32_t dep_;
+} collective_copy_t;
+
+// @brief: Offset and size of a chunk of a buffer split in equal
+// parts, last part taking the remainder
+static void GetChunk(size_t size, uint32_t num_chunks, uint32_t chunk,
+                     size_t& offset, size_t& chunk_size) {
+
+  size_t part = size / num_chunks;
+  offset = part * chunk;
+  chunk_size = (chunk == (num_chunks - 1)) ? (size - offset) : part;
+}
+
+// @brief: Append steps of a ring, where every device sends a chunk
+// to its successor per step. Device r sends chunk (r + first - step)
+// of its buffer, which it received in previous step, and hence its
+// copy depends on the copy into it of previous step, which may be
+// the last step of a previous phase
+static void BuildRingSteps(uint32_t num_ranks, size_t size, uint32_t first,
+                           uint32_t num_steps, bool dst_scratch,
+                           vector<collective_copy_t>& schedule) {
+
+  for (uint32_t step = 0; step < num_steps; step++) {
+    for (uint32_t rank = 0; rank < num_ranks; rank++) {
+      collective_copy_t copy;
+      uint32_t chunk = (rank + first + (num_ranks - step)) % num_ranks;
+      GetChunk(size, num_ranks, chunk, copy.src_offset_, copy.size_);
+      copy.dst_offset_ = copy.src_offset_;
+      copy.src_rank_ = rank;
+      copy.dst_rank_ = (rank + 1) % num_ranks;
+      copy.dst_scratch_ = dst_scratch;
+      copy.dep_ = -1;
+      if (schedule.size() >= num_ranks) {
+        uint32_t prev_rank = (rank + num_ranks - 1) % num_ranks;
+        copy.dep_ = schedule.size() - num_ranks - rank + prev_rank;
+      }
+      schedule.push_back(copy);
+    }
+  }
+}
+
+// @brief: Build schedule of copies moving the data of a collective
+// among devices. Copies only move data, reductions of a ring land
+// in scratch buffers where a kernel would reduce them
+static void BuildCollectiveSchedule(uint32_t op, uint32_t num_ranks, size_t size,
+                                    vector<collective_copy_t>& schedule) {
+
+  schedule.clear();
+  switch (op) {
+
+    // Reduce-scatter moves chunks into scratch buffers of successors,
+    // allgather then circulates the reduced chunks into buffers
+    case COLLECTIVE_ALLREDUCE_RING:
+      BuildRingSteps(num_ranks, size, 0, num_ranks - 1, true, schedule);
+      BuildRingSteps(num_ranks, size, 1, num_ranks - 1, false, schedule);
+      break;
+
+    case COLLECTIVE_REDUCE_SCATTER_RING:
+      BuildRingSteps(num_ranks, size, 0, num_ranks - 1, true, schedule);
+      break;
+
+    // Device 0 is the root of a binary tree, every device forwards
+    // a chunk to its children once it has received it
+    case COLLECTIVE_BROADCAST_TREE: {
+      uint32_t num_chunks = (size + COLLECTIVE_CHUNK_SIZE - 1) / COLLECTIVE_CHUNK_SIZE;
+      for (uint32_t chunk = 0; chunk < num_chunks; chunk++) {
+        uint32_t first = schedule.size();
+        for (uint32_t rank = 1; rank < num_ranks; rank++) {
+          collective_copy_t copy;
+          copy.src_offset_ = chunk * COLLECTIVE_CHUNK_SIZE;
+          copy.dst_offset_ = copy.src_offset_;
+          copy.size_ = std::min(COLLECTIVE_CHUNK_SIZE, size - copy.src_offset_);
+          copy.src_rank_ = (rank - 1) / 2;
+          copy.dst_rank_ = rank;
+          copy.dst_scratch_ = false;
+          copy.dep_ = (copy.src_rank_ == 0) ? -1 : (first + copy.src_rank_ - 1);
+          schedule.push_back(copy);
+        }
+      }
+      break;
+    }
+
+    // Every device sends chunk j of its buffer to device j, into
+    // the chunk of scratch buffer indexed by the sending device
+    case COLLECTIVE_ALL_TO_ALL:
+      for (uint32_t rank = 0; rank < num_ranks; rank++) {
+        for (uint32_t peer = 0; peer < num_ranks; peer++) {
+          if (peer == rank) {
+            continue;
+          }
+          collective_copy_t copy;
+          size_t chunk_size;
+          GetChunk(size, num_ranks, peer, copy.src_offset_, copy.size_);
+          GetChunk(size, num_ranks, rank, copy.dst_offset_, chunk_size);
+          copy.size_ = std::min(copy.size_, chunk_size);
+          copy.src_rank_ = rank;
+          copy.dst_rank_ = peer;
+          copy.dst_scratch_ = true;
+          copy.dep_ = -1;
+          schedule.push_back(copy);
+        }
+      }
+      break;
+  }
+}
+
+const char* RocmBandwidthTest::GetCollectiveName(uint32_t op) {
+
+  static const char* name_list[COLLECTIVE_OP_COUNT] = {
+    "AllReduce Ring", "Broadcast Tree", "AllToAll", "ReduceScatter Ring" };
+  return (op < COLLECTIVE_OP_COUNT) ? name_list[op] : "unknown";
+}
+
+// @brief: Ratio of bus bandwidth to algorithm bandwidth, as defined
+// by NCCL tests. It scales the bandwidth seen by the application to
+// the bandwidth of links an optimal algorithm would need
+double RocmBandwidthTest::GetCollectiveBusFactor(uint32_t op, uint32_t num_ranks) {
+
+  switch (op) {
+    case COLLECTIVE_ALLREDUCE_RING:
+      return (2.0 * (num_ranks - 1)) / num_ranks;
+    case COLLECTIVE_ALL_TO_ALL:
+    case COLLECTIVE_REDUCE_SCATTER_RING:
+      return (double)(num_ranks - 1) / num_ranks;
+    default:
+      return 1.0;
+  }
+}
+
+// @brief: Run a collective across Gpu devices, composed of copies
+// chained by their completion signals. Every device holds a buffer
+// and a scratch buffer of the size of the collective. Time of an
+// iteration spans the submission of its copies until all are done
+void RocmBandwidthTest::RunCollectiveBenchmark(async_trans_t& trans) {
+
+  uint32_t op = trans.kernel.op_;
+  uint32_t num_ranks = collective_pool_list_.size();
+  uint32_t max_size = size_list_.back();
+  PinToNumaNode(agent_list_[GetPoolHostIdx(collective_pool_list_[0])].numa_node_);
+
+  vector<void*> buf_list(num_ranks);
+  vector<void*> scratch_list(num_ranks);
+  vector<hsa_agent_t> agent_list(num_ranks);
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    uint32_t pool_idx = collective_pool_list_[rank];
+    agent_list[rank] = pool_list_[pool_idx].owner_agent_;
+    err_ = backend_->PoolAllocate(pool_list_[pool_idx].pool_, max_size, 0, &buf_list[rank]);
+    ErrorCheck(err_);
+    err_ = backend_->PoolAllocate(pool_list_[pool_idx].pool_, max_size, 0, &scratch_list[rank]);
+    ErrorCheck(err_);
+  }
+
+  // Every device copies into buffers of every other device
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    for (uint32_t peer = 0; peer < num_ranks; peer++) {
+      if (peer != rank) {
+        AcquirePoolAcceses(collective_pool_list_[rank], buf_list[rank],
+                           collective_pool_list_[peer], buf_list[peer]);
+        AcquirePoolAcceses(collective_pool_list_[rank], buf_list[rank],
+                           collective_pool_list_[peer], scratch_list[peer]);
+      }
+    }
+  }
+
+  vector<hsa_signal_t> signal_list;
+  vector<collective_copy_t> schedule;
+  uint32_t iterations = GetIterationNum();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    BuildCollectiveSchedule(op, num_ranks, curr_size, schedule);
+    while (signal_list.size() < schedule.size()) {
+      hsa_signal_t signal;
+      err_ = backend_->SignalCreate(0, &signal);
+      ErrorCheck(err_);
+      signal_list.push_back(signal);
+    }
+
+    cout << endl << "RUNNING " << iterations << " ITERATIONS of "
+         << GetCollectiveName(op) << " across " << num_ranks
+         << " Gpu devices for buffer size " << curr_size << endl;
+
+    double total_time = 0;
+    double min_time = std::numeric_limits<double>::max();
+    uint32_t num_copies = schedule.size();
+    for (uint32_t it = 0; it < iterations; it++) {
+
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        backend_->SignalStore(signal_list[copy_idx], 1);
+      }
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        const collective_copy_t& copy = schedule[copy_idx];
+        void* dst = (copy.dst_scratch_) ? scratch_list[copy.dst_rank_] :
+                                          buf_list[copy.dst_rank_];
+        uint32_t num_deps = (copy.dep_ < 0) ? 0 : 1;
+        err_ = backend_->AsyncCopy((char*)dst + copy.dst_offset_,
+                                   agent_list[copy.dst_rank_],
+                                   (char*)buf_list[copy.src_rank_] + copy.src_offset_,
+                                   agent_list[copy.src_rank_], copy.size_, num_deps,
+                                   (copy.dep_ < 0) ? NULL : &signal_list[copy.dep_],
+                                   signal_list[copy_idx]);
+        ErrorCheck(err_);
+      }
+      for (uint32_t copy_idx = 0; copy_idx < num_copies; copy_idx++) {
+        while (backend_->SignalWait(signal_list[copy_idx], HSA_SIGNAL_CONDITION_LT, 1,
+                                    HSA_WAIT_STATE_ACTIVE));
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      total_time += elapsed.count();
+      min_time = std::min(min_time, elapsed.count());
+    }
+
+    // Bandwidth of a collective is its algorithm bandwidth, size
+    // of buffer of each device over time of collective
+    double avg_time = total_time / iterations;
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.avg_bandwidth_.push_back((double)curr_size / avg_time / 1000 / 1000 / 1000);
+    trans.peak_bandwidth_.push_back((double)curr_size / min_time / 1000 / 1000 / 1000);
+  }
+
+  for (uint32_t idx = 0; idx < signal_list.size(); idx++) {
+    err_ = backend_->SignalDestroy(signal_list[idx]);
+    ErrorCheck(err_);
+  }
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    err_ = backend_->PoolFree(buf_list[rank]);
+    ErrorCheck(err_);
+    err_ = backend_->PoolFree(scratch_list[rank]);
+    ErrorCheck(err_);
+  }
+}
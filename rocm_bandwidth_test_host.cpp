@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+// @brief: Create the engine copying among Cpu devices if needed and
+// pin its threads to the cores of a NUMA node. Threads are left
+// unpinned if the cores of node are not known
+void RocmBandwidthTest::BindHostCopyEngine(uint32_t numa_node) {
+
+  vector<uint32_t> cpu_list;
+  GetNumaCpuList(numa_node, cpu_list);
+
+  if (host_engine_ == NULL) {
+    uint32_t num_threads = cpu_list.size();
+    if (host_copy_threads_ != NULL) {
+      num_threads = strtoul(host_copy_threads_, NULL, 0);
+    }
+    if (num_threads == 0) {
+      num_threads = std::thread::hardware_concurrency();
+    }
+    host_engine_ = new HostCopyEngine(num_threads);
+  }
+  host_engine_->Bind(cpu_list);
+}
+
+// @brief: Grant a Cpu device access to a buffer of a memory pool if
+// it may access the pool but is not allowed to by default
+void RocmBandwidthTest::AcquireHostPoolAccess(uint32_t host_idx,
+                                              uint32_t pool_idx, void* buf) {
+
+  if (GetPoolAccess(host_idx, pool_idx) ==
+      HSA_AMD_MEMORY_POOL_ACCESS_DISALLOWED_BY_DEFAULT) {
+    AcquireAccess(agent_list_[host_idx].agent_, buf);
+  }
+}
+
+void RocmBandwidthTest::RunHostCopyBenchmark(async_trans_t& trans) {
+
+  // Bind if this transaction is bidirectional
+  bool bidir = trans.copy.bidir_;
+
+  // Initialize size of buffer to equal the largest element of allocation
+  uint32_t size_len = size_list_.size();
+  uint32_t max_size = size_list_.back();
+
+  // Allocate buffers of forward and reverse copies
+  void* buf_src_fwd;
+  void* buf_dst_fwd;
+  void* buf_src_rev = NULL;
+  void* buf_dst_rev = NULL;
+  hsa_amd_memory_pool_t src_pool = trans.copy.src_pool_;
+  hsa_amd_memory_pool_t dst_pool = trans.copy.dst_pool_;
+  err_ = backend_->PoolAllocate(src_pool, max_size, 0, &buf_src_fwd);
+  ErrorCheck(err_);
+  err_ = backend_->PoolAllocate(dst_pool, max_size, 0, &buf_dst_fwd);
+  ErrorCheck(err_);
+  if (bidir) {
+    err_ = backend_->PoolAllocate(dst_pool, max_size, 0, &buf_src_rev);
+    ErrorCheck(err_);
+    err_ = backend_->PoolAllocate(src_pool, max_size, 0, &buf_dst_rev);
+    ErrorCheck(err_);
+  }
+
+  // Gain access to buffers of pools that Cpu may access
+  // but is not allowed to by default e.g. pools of a Gpu
+  uint32_t host_idx = GetTransHostIdx(trans);
+  AcquireHostPoolAccess(host_idx, trans.copy.src_idx_, buf_src_fwd);
+  AcquireHostPoolAccess(host_idx, trans.copy.dst_idx_, buf_dst_fwd);
+  if (bidir) {
+    AcquireHostPoolAccess(host_idx, trans.copy.dst_idx_, buf_src_rev);
+    AcquireHostPoolAccess(host_idx, trans.copy.src_idx_, buf_dst_rev);
+  }
+
+  // Touch buffers so that page faults are not timed
+  memset(buf_src_fwd, 0x23, max_size);
+  memset(buf_dst_fwd, 0x00, max_size);
+  if (bidir) {
+    memset(buf_src_rev, 0x23, max_size);
+    memset(buf_dst_rev, 0x00, max_size);
+  }
+
+  // Copy on threads pinned to the NUMA node of source device
+  BindHostCopyEngine(agent_list_[host_idx].numa_node_);
+  host_engine_->SetKernel(trans.copy.kernel_idx_);
+
+  // Iterate through the different buffer sizes to
+  // compute the bandwidth as determined by copy
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    uint32_t iterations = GetCopyIterationNum(curr_size);
+    HostCopyEngine::host_copy_job_t job_list[2] = {
+      { buf_dst_fwd, buf_src_fwd, curr_size },
+      { buf_dst_rev, buf_src_rev, curr_size } };
+    uint32_t num_jobs = (bidir) ? 2 : 1;
+
+    cout << endl << "RUNNING " << iterations << " ITERATIONS for buffer size "
+         << curr_size << " on " << host_engine_->GetNumThreads()
+         << " Cpu threads using "
+         << HostCopyEngine::GetKernelName(trans.copy.kernel_idx_) << endl;
+
+    // Create a timer object to time all iterations
+    PerfTimer timer;
+    uint32_t index = timer.CreateTimer();
+    timer.StartTimer(index);
+
+    bool verify = true;
+    for (uint32_t it = 0; it < iterations; it++) {
+      host_engine_->Copy(job_list, num_jobs);
+
+      // Compare output equals input
+      if (validate_) {
+        for (uint32_t job_idx = 0; job_idx < num_jobs; job_idx++) {
+          HostCopyEngine::host_compare_job_t compare_job;
+          compare_job.expected_ = job_list[job_idx].src_;
+          compare_job.actual_ = job_list[job_idx].dst_;
+          compare_job.size_ = curr_size;
+          host_engine_->Compare(compare_job);
+          if (compare_job.mismatch_ != curr_size) {
+            verify = false;
+          }
+        }
+        if (verify == false) {
+          trans.data_valid_ = false;
+          exit_value_ = 1;
+          cerr << "ERROR: data corrupted during Cpu copy" << endl;
+          break;
+        }
+      }
+    }
+
+    // Stop the timer object
+    timer.StopTimer(index);
+    double aggregate_cpu_time = timer.ReadTimer(index);
+
+    // Time taken per copy, which is reported both as its min
+    // and mean as copies are not timed individually
+    double copy_time = (verify) ? (aggregate_cpu_time / iterations) :
+                                  std::numeric_limits<double>::max();
+    trans.cpu_min_time_.push_back(copy_time);
+    trans.cpu_avg_time_.push_back(copy_time);
+  }
+
+  // Free up buffers used in copy operation
+  err_ = backend_->PoolFree(buf_src_fwd);
+  ErrorCheck(err_);
+  err_ = backend_->PoolFree(buf_dst_fwd);
+  ErrorCheck(err_);
+  if (bidir) {
+    err_ = backend_->PoolFree(buf_src_rev);
+    ErrorCheck(err_);
+    err_ = backend_->PoolFree(buf_dst_rev);
+    ErrorCheck(err_);
+  }
+}
+
+void RocmBandwidthTest::RunStreamBenchmark(async_trans_t& trans) {
+
+  // Allocate the three arrays of STREAM from the pool
+  uint32_t max_size = size_list_.back();
+  uint32_t pool_idx = trans.kernel.pool_idx_;
+  uint32_t host_idx = trans.kernel.agent_idx_;
+  double* array_list[3];
+  for (uint32_t idx = 0; idx < 3; idx++) {
+    err_ = backend_->PoolAllocate(trans.kernel.pool_, max_size, 0,
+                                  (void**)&array_list[idx]);
+    ErrorCheck(err_);
+    AcquireHostPoolAccess(host_idx, pool_idx, array_list[idx]);
+  }
+
+  // Initialize arrays as STREAM does, which also
+  // keeps page faults out of the timed region
+  size_t max_count = max_size / sizeof(double);
+  for (size_t idx = 0; idx < max_count; idx++) {
+    array_list[0][idx] = 1.0;
+    array_list[1][idx] = 2.0;
+    array_list[2][idx] = 0.0;
+  }
+
+  // Run on threads pinned to the NUMA node nearest to the pool
+  BindHostCopyEngine(agent_list_[host_idx].numa_node_);
+  HostCopyEngine::host_stream_job_t job;
+  job.op_ = trans.kernel.op_;
+  job.a_ = array_list[0];
+  job.b_ = array_list[1];
+  job.c_ = array_list[2];
+  job.scalar_ = 3.0;
+
+  uint32_t iterations = GetIterationNum();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    job.count_ = curr_size / sizeof(double);
+    cout << endl << "RUNNING " << iterations << " ITERATIONS of STREAM "
+         << HostCopyEngine::GetStreamOpName(job.op_) << " for array size "
+         << curr_size << " on " << host_engine_->GetNumThreads()
+         << " Cpu threads" << endl;
+
+    // Time every iteration, STREAM reports the best one
+    double total_time = 0;
+    double min_time = std::numeric_limits<double>::max();
+    for (uint32_t it = 0; it < iterations; it++) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      host_engine_->Stream(job);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      total_time += elapsed.count();
+      min_time = std::min(min_time, elapsed.count());
+    }
+
+    // Bytes moved count every array read or written once
+    double data_size = (double)curr_size * HostCopyEngine::GetStreamOpArrays(job.op_);
+    double avg_time = total_time / iterations;
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.avg_bandwidth_.push_back(data_size / avg_time / 1000 / 1000 / 1000);
+    trans.peak_bandwidth_.push_back(data_size / min_time / 1000 / 1000 / 1000);
+  }
+
+  for (uint32_t idx = 0; idx < 3; idx++) {
+    err_ = backend_->PoolFree(array_list[idx]);
+    ErrorCheck(err_);
+  }
+}
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rocm_bandwidth_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Copies of a path timed per pairing of paths. Kept small since
+// pairings grow with the square of the number of paths
+static const uint32_t INTERFERENCE_ITERATION_NUM = 20;
+
+// @brief: Runs copies of a path back to back until told to stop,
+// keeping the path busy while copy of another path is timed. Flags
+// started once its first copy is submitted
+static void RunInterferingCopies(Backend* backend, void* dst, hsa_agent_t dst_agent,
+                                 void* src, hsa_agent_t src_agent, size_t size,
+                                 hsa_signal_t signal, std::atomic<bool>* started,
+                                 std::atomic<bool>* stop) {
+
+  while (stop->load() == false) {
+    backend->SignalStore(signal, 1);
+    hsa_status_t status = backend->AsyncCopy(dst, dst_agent, src, src_agent,
+                                             size, 0, NULL, signal);
+    ErrorCheck(status);
+    started->store(true);
+    while (backend->SignalWait(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                               HSA_WAIT_STATE_ACTIVE));
+  }
+}
+
+// @brief: Time a copy from submission until it is done
+double RocmBandwidthTest::TimeAsyncCopy(void* dst, hsa_agent_t dst_agent,
+                                        void* src, hsa_agent_t src_agent,
+                                        size_t size, hsa_signal_t signal) {
+
+  backend_->SignalStore(signal, 1);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  err_ = backend_->AsyncCopy(dst, dst_agent, src, src_agent, size, 0, NULL, signal);
+  ErrorCheck(err_);
+  while (backend_->SignalWait(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                              HSA_WAIT_STATE_ACTIVE));
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// @brief: Time a number of copies back to back, returning the minimum
+// and mean of their times. First copy warms up the path and is not timed
+void RocmBandwidthTest::TimeAsyncCopies(void* dst, hsa_agent_t dst_agent,
+                                        void* src, hsa_agent_t src_agent,
+                                        size_t size, hsa_signal_t signal,
+                                        uint32_t iterations,
+                                        double& min_time, double& avg_time) {
+
+  TimeAsyncCopy(dst, dst_agent, src, src_agent, size, signal);
+  double total_time = 0;
+  min_time = 0;
+  for (uint32_t it = 0; it < iterations; it++) {
+    double time = TimeAsyncCopy(dst, dst_agent, src, src_agent, size, signal);
+    total_time += time;
+    min_time = ((it == 0) || (time < min_time)) ? time : min_time;
+  }
+  avg_time = total_time / iterations;
+}
+
+// @brief: Run copy of a path alone and then alongside copies of every
+// other path of interference sweep, which a thread runs back to back
+// for as long as the copy is timed. Every path has its own buffers,
+// so paths sharing a device contend only for its links and engines
+void RocmBandwidthTest::RunInterferenceBenchmark(async_trans_t& trans) {
+
+  uint32_t src_idx = trans.copy.src_idx_;
+  uint32_t dst_idx = trans.copy.dst_idx_;
+  hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
+  hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
+  uint32_t max_size = size_list_.back();
+  PinToNumaNode(agent_list_[GetPoolHostIdx(src_idx)].numa_node_);
+
+  void* src;
+  void* dst;
+  err_ = backend_->PoolAllocate(trans.copy.src_pool_, max_size, 0, &src);
+  ErrorCheck(err_);
+  err_ = backend_->PoolAllocate(trans.copy.dst_pool_, max_size, 0, &dst);
+  ErrorCheck(err_);
+  AcquirePoolAcceses(src_idx, src, dst_idx, dst);
+
+  hsa_signal_t signal;
+  hsa_signal_t other_signal;
+  err_ = backend_->SignalCreate(0, &signal);
+  ErrorCheck(err_);
+  err_ = backend_->SignalCreate(0, &other_signal);
+  ErrorCheck(err_);
+
+  uint32_t num_paths = interference_trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  trans.shared_bandwidth_.assign(size_len * num_paths, 0);
+  for (uint32_t path = 0; path < num_paths; path++) {
+
+    const async_trans_t& other = trans_list_[interference_trans_list_[path]];
+    bool alone = (&other == &trans);
+    uint32_t other_src_idx = other.copy.src_idx_;
+    uint32_t other_dst_idx = other.copy.dst_idx_;
+    void* other_src = NULL;
+    void* other_dst = NULL;
+    if (alone == false) {
+      err_ = backend_->PoolAllocate(other.copy.src_pool_, max_size, 0, &other_src);
+      ErrorCheck(err_);
+      err_ = backend_->PoolAllocate(other.copy.dst_pool_, max_size, 0, &other_dst);
+      ErrorCheck(err_);
+      AcquirePoolAcceses(other_src_idx, other_src, other_dst_idx, other_dst);
+    }
+
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+
+      uint32_t curr_size = size_list_[idx];
+      cout << endl << "RUNNING " << INTERFERENCE_ITERATION_NUM << " ITERATIONS of copy "
+           << pool_list_[src_idx].agent_index_ << "->" << pool_list_[dst_idx].agent_index_;
+      if (alone == false) {
+        cout << " alongside " << pool_list_[other_src_idx].agent_index_ << "->"
+             << pool_list_[other_dst_idx].agent_index_;
+      }
+      cout << " for buffer size " << curr_size << endl;
+
+      // Copy is timed only once the interfering path is busy
+      std::atomic<bool> started(alone);
+      std::atomic<bool> stop(false);
+      std::thread other_thread;
+      if (alone == false) {
+        other_thread = std::thread(RunInterferingCopies, backend_,
+                                   other_dst, pool_list_[other_dst_idx].owner_agent_,
+                                   other_src, pool_list_[other_src_idx].owner_agent_,
+                                   curr_size, other_signal, &started, &stop);
+      }
+      while (started.load() == false) {
+        std::this_thread::yield();
+      }
+
+      double min_time = 0;
+      double avg_time = 0;
+      TimeAsyncCopies(dst, dst_agent, src, src_agent, curr_size, signal,
+                      INTERFERENCE_ITERATION_NUM, min_time, avg_time);
+
+      if (alone == false) {
+        stop.store(true);
+        other_thread.join();
+      }
+
+      double avg_bandwidth = (double)curr_size / avg_time / 1000 / 1000 / 1000;
+      trans.shared_bandwidth_[(idx * num_paths) + path] = avg_bandwidth;
+      if (alone) {
+        trans.min_time_.push_back(min_time);
+        trans.avg_time_.push_back(avg_time);
+        trans.avg_bandwidth_.push_back(avg_bandwidth);
+        trans.peak_bandwidth_.push_back((double)curr_size / min_time / 1000 / 1000 / 1000);
+      }
+    }
+
+    if (alone == false) {
+      err_ = backend_->PoolFree(other_src);
+      ErrorCheck(err_);
+      err_ = backend_->PoolFree(other_dst);
+      ErrorCheck(err_);
+    }
+  }
+
+  err_ = backend_->SignalDestroy(signal);
+  ErrorCheck(err_);
+  err_ = backend_->SignalDestroy(other_signal);
+  ErrorCheck(err_);
+  err_ = backend_->PoolFree(src);
+  ErrorCheck(err_);
+  err_ = backend_->PoolFree(dst);
+  ErrorCheck(err_);
+}
@@ -49,9 +49,79 @@
 #include <unistd.h>
 #include <cctype>
 #include <sstream>
+#include <chrono>
 
+// Value used to fill buffers, chosen so that sums of the
+// buffer sizes in use are exact in double precision
+static const double IO_FILL_VALUE = 1.0;
+
+// @brief: Run read or write requests of users. Requests are run by
+// Cpu devices only, whose threads sum up or fill a buffer of the pool
 void RocmBandwidthTest::RunIOBenchmark(async_trans_t& trans) {
 
-  std::cout << "Unsupported Request - Read / Write" << std::endl;
-  exit(1);
+  uint32_t exec_idx = trans.kernel.agent_idx_;
+  uint32_t pool_idx = trans.kernel.pool_idx_;
+  if (agent_list_[exec_idx].device_type_ != HSA_DEVICE_TYPE_CPU) {
+    std::cout << "Unsupported Request - Read / Write by Gpu" << std::endl;
+    exit(1);
+  }
+
+  // Allocate buffer and initialize it so that reads can be validated
+  // and page faults are kept out of the timed region
+  uint32_t max_size = size_list_.back();
+  double* buf = NULL;
+  err_ = backend_->PoolAllocate(trans.kernel.pool_, max_size, 0, (void**)&buf);
+  ErrorCheck(err_);
+  AcquireHostPoolAccess(exec_idx, pool_idx, buf);
+  std::fill(buf, buf + (max_size / sizeof(double)), IO_FILL_VALUE);
+
+  // Run on threads pinned to the NUMA node of executing device
+  BindHostCopyEngine(agent_list_[exec_idx].numa_node_);
+  HostCopyEngine::host_access_job_t job;
+  job.op_ = (trans.req_type_ == REQ_READ) ? HOST_ACCESS_READ : HOST_ACCESS_WRITE;
+  job.buf_ = buf;
+
+  uint32_t iterations = GetIterationNum();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    job.count_ = curr_size / sizeof(double);
+    cout << endl << "RUNNING " << iterations << " ITERATIONS of "
+         << ((job.op_ == HOST_ACCESS_READ) ? "Read" : "Write")
+         << " for buffer size " << curr_size << " on "
+         << host_engine_->GetNumThreads() << " Cpu threads" << endl;
+
+    std::vector<double> time_list;
+    for (uint32_t it = 0; it < iterations; it++) {
+      job.value_ = IO_FILL_VALUE;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      host_engine_->Access(job);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      time_list.push_back(elapsed.count());
+
+      // Sum read back must account for every element of buffer. It
+      // is computed by every read, hence checked whether or not -v
+      // is given, which selects validation of all-pairs copies
+      if ((job.op_ == HOST_ACCESS_READ) &&
+          (job.value_ != (job.count_ * IO_FILL_VALUE))) {
+        trans.data_valid_ = false;
+        exit_value_ = 1;
+        cerr << "ERROR: data corrupted during Read" << endl;
+      }
+    }
+
+    // Reduce times with the same statistics as copies, the mean
+    // drops outliers which needs all iterations to be run
+    double min_time = GetMinTime(time_list);
+    double avg_time = (iterations < num_iteration_) ? min_time :
+                                                      GetMeanTime(time_list);
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.avg_bandwidth_.push_back((double)curr_size / avg_time / 1000 / 1000 / 1000);
+    trans.peak_bandwidth_.push_back((double)curr_size / min_time / 1000 / 1000 / 1000);
+  }
+
+  err_ = backend_->PoolFree(buf);
+  ErrorCheck(err_);
 }
@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+// Strides of pointer chase chains in bytes, one per cache line
+// and one per page so that every access also misses the TLB
+const uint32_t RocmBandwidthTest::LATENCY_STRIDE_LIST[] = { 64, 4 * 1024 };
+
+// Number of accesses timed in every iteration of a chain walk
+static const size_t LATENCY_STEPS = 16 * 1024;
+
+// Seed of the shuffle building chains, fixed to let runs be compared
+static const uint32_t LATENCY_SEED = 0x5EED;
+
+// Size of last level cache assumed when sysfs does not report it
+static const size_t LATENCY_DEFAULT_LLC = 32 * 1024 * 1024;
+
+// @brief: Size of the largest cache of cpu0 as reported by sysfs
+static size_t GetLastLevelCacheSize() {
+
+  size_t llc_size = 0;
+  uint32_t llc_level = 0;
+  for (uint32_t idx = 0; ; idx++) {
+    std::stringstream path;
+    path << RocmBandwidthTest::GetSysfsRoot()
+         << "/devices/system/cpu/cpu0/cache/index" << idx << "/";
+    std::ifstream level_file((path.str() + "level").c_str());
+    std::ifstream size_file((path.str() + "size").c_str());
+    if ((level_file.good() == false) || (size_file.good() == false)) {
+      break;
+    }
+
+    // Sizes are listed as "32768K" or "32M"
+    uint32_t level = 0;
+    size_t size = 0;
+    char unit = 0;
+    std::string size_str;
+    level_file >> level;
+    std::getline(size_file, size_str);
+    if (sscanf(size_str.c_str(), "%zu%c", &size, &unit) < 1) {
+      continue;
+    }
+    size *= (unit == 'K') ? 1024 : ((unit == 'M') ? (1024 * 1024) : 1);
+    if (level >= llc_level) {
+      llc_level = level;
+      llc_size = size;
+    }
+  }
+  return (llc_size == 0) ? LATENCY_DEFAULT_LLC : llc_size;
+}
+
+// @brief: Walk a chain of pointers, every load depending on the
+// one before it so that no two accesses can overlap
+static void* ChaseChain(void* head, size_t steps) {
+
+  void** ptr = (void**)head;
+  for (size_t idx = 0; idx < steps; idx += 8) {
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+    ptr = (void**)*ptr;
+  }
+  return ptr;
+}
+
+// @brief: Size of buffer holding a chain, large enough for the
+// chain to miss every level of cache of Cpu
+size_t RocmBandwidthTest::GetLatencyBufferSize() const {
+
+  size_t buf_size = 4 * GetLastLevelCacheSize();
+  return std::max(buf_size, (size_t)size_list_.back());
+}
+
+// @brief: Measure latency of loads from a memory pool by a Cpu
+// device, walking a chain of pointers laid out in random order
+// so that hardware prefetchers can not anticipate the accesses
+void RocmBandwidthTest::RunLatencyBenchmark(async_trans_t& trans) {
+
+  uint32_t host_idx = trans.kernel.agent_idx_;
+  uint32_t pool_idx = trans.kernel.pool_idx_;
+  uint32_t stride = trans.kernel.op_;
+  size_t buf_size = GetLatencyBufferSize();
+  char* buf = NULL;
+  err_ = backend_->PoolAllocate(trans.kernel.pool_, buf_size, 0, (void**)&buf);
+  ErrorCheck(err_);
+  AcquireHostPoolAccess(host_idx, pool_idx, buf);
+
+  // Link one pointer per stride into a single cycle visiting
+  // every stride of buffer in a shuffled order
+  size_t count = buf_size / stride;
+  vector<size_t> order(count);
+  for (size_t idx = 0; idx < count; idx++) {
+    order[idx] = idx;
+  }
+  std::mt19937_64 engine(LATENCY_SEED);
+  std::shuffle(order.begin() + 1, order.end(), engine);
+  for (size_t idx = 0; idx < count; idx++) {
+    size_t next = order[(idx + 1) % count];
+    *(void**)(buf + (order[idx] * stride)) = buf + (next * stride);
+  }
+
+  // Walk from a thread pinned to the NUMA node of Cpu device,
+  // visiting the whole chain once to keep page faults and TLB
+  // fills of a cold buffer out of the timed region
+  PinToNumaNode(agent_list_[host_idx].numa_node_);
+  void* volatile sink = ChaseChain(buf, count);
+
+  size_t steps = std::min(count, LATENCY_STEPS);
+  uint32_t iterations = GetIterationNum();
+  cout << endl << "RUNNING " << iterations << " ITERATIONS of Pointer Chase"
+       << " with stride " << stride << " over buffer size " << buf_size
+       << " of Pool " << pool_idx << " by Device " << host_idx << endl;
+
+  // Walk resumes where the previous iteration stopped, its end
+  // stored in a volatile to keep the walk inside the timed region
+  double total_time = 0;
+  double min_time = std::numeric_limits<double>::max();
+  for (uint32_t it = 0; it < iterations; it++) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sink = ChaseChain(sink, steps);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    total_time += elapsed.count();
+    min_time = std::min(min_time, elapsed.count());
+  }
+
+  // Steps are walked in groups of eight
+  steps = ((steps + 7) / 8) * 8;
+  trans.min_time_.push_back(min_time / steps);
+  trans.avg_time_.push_back(total_time / iterations / steps);
+
+  err_ = backend_->PoolFree(buf);
+  ErrorCheck(err_);
+}
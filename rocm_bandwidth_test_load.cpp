@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rocm_bandwidth_test.hpp"
+
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+// Copies timed per level of load. Kept small since every copy path
+// is timed at every level
+static const uint32_t HOST_LOAD_ITERATION_NUM = 20;
+
+// Size of each buffer a thread of load generator streams over,
+// large enough for streams to miss in caches
+static const size_t HOST_LOAD_BUFFER_SIZE = 8 * 1024 * 1024;
+
+// Time load generator runs unthrottled to find the rate that
+// levels of load are percents of
+static const uint32_t HOST_LOAD_PEAK_MSEC = 250;
+
+// @brief: Run copy between a Cpu and a Gpu device while threads
+// pinned to the NUMA node of the Cpu load its system memory. Load is
+// throttled to each level in percent of its unthrottled rate, the
+// top level running unthrottled and level zero running no load
+void RocmBandwidthTest::RunHostLoadBenchmark(async_trans_t& trans) {
+
+  uint32_t src_idx = trans.copy.src_idx_;
+  uint32_t dst_idx = trans.copy.dst_idx_;
+  uint32_t host_idx = GetTransHostIdx(trans);
+  uint32_t numa_node = agent_list_[host_idx].numa_node_;
+  hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
+  hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
+  uint32_t max_size = size_list_.back();
+  PinToNumaNode(numa_node);
+
+  void* src;
+  void* dst;
+  hsa_signal_t signal;
+  err_ = backend_->PoolAllocate(trans.copy.src_pool_, max_size, 0, &src);
+  ErrorCheck(err_);
+  err_ = backend_->PoolAllocate(trans.copy.dst_pool_, max_size, 0, &dst);
+  ErrorCheck(err_);
+  AcquirePoolAcceses(src_idx, src, dst_idx, dst);
+  err_ = backend_->SignalCreate(0, &signal);
+  ErrorCheck(err_);
+
+  // Load generator leaves a core of the node to the thread timing
+  // copies, unless user sets its number of threads
+  vector<uint32_t> cpu_list;
+  GetNumaCpuList(numa_node, cpu_list);
+  uint32_t num_threads = cpu_list.size();
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  num_threads = (num_threads > 1) ? (num_threads - 1) : 1;
+  if (host_load_threads_ != NULL) {
+    num_threads = strtoul(host_load_threads_, NULL, 0);
+  }
+  HostLoadGenerator load(num_threads);
+  load.Bind(cpu_list);
+  num_threads = load.GetNumThreads();
+
+  vector<char*> load_buf_list(2 * num_threads);
+  for (uint32_t idx = 0; idx < load_buf_list.size(); idx++) {
+    void* buf;
+    err_ = backend_->PoolAllocate(GetHostPool(host_idx), HOST_LOAD_BUFFER_SIZE, 0, &buf);
+    ErrorCheck(err_);
+    memset(buf, 0, HOST_LOAD_BUFFER_SIZE);
+    load_buf_list[idx] = (char*)buf;
+  }
+
+  load.Start(host_load_op_, &load_buf_list[0], HOST_LOAD_BUFFER_SIZE, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(HOST_LOAD_PEAK_MSEC));
+  double peak_rate = load.Stop();
+
+  uint32_t num_levels = load_level_list_.size();
+  uint32_t size_len = size_list_.size();
+  trans.shared_bandwidth_.assign(size_len * num_levels, 0);
+  trans.load_rate_.assign(size_len * num_levels, 0);
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    for (uint32_t level_idx = 0; level_idx < num_levels; level_idx++) {
+
+      uint32_t level = load_level_list_[level_idx];
+      cout << endl << "RUNNING " << HOST_LOAD_ITERATION_NUM << " ITERATIONS of copy "
+           << pool_list_[src_idx].agent_index_ << "->" << pool_list_[dst_idx].agent_index_
+           << " under " << level << "% " << HostLoadGenerator::GetOpName(host_load_op_)
+           << " load of " << num_threads << " threads for buffer size " << curr_size << endl;
+
+      if (level != 0) {
+        double rate = (level == 100) ? 0 : (peak_rate * level / 100);
+        load.Start(host_load_op_, &load_buf_list[0], HOST_LOAD_BUFFER_SIZE, rate);
+      }
+
+      double min_time = 0;
+      double avg_time = 0;
+      TimeAsyncCopies(dst, dst_agent, src, src_agent, curr_size, signal,
+                      HOST_LOAD_ITERATION_NUM, min_time, avg_time);
+
+      double load_rate = (level != 0) ? load.Stop() : 0;
+      double avg_bandwidth = (double)curr_size / avg_time / 1000 / 1000 / 1000;
+      trans.shared_bandwidth_[(idx * num_levels) + level_idx] = avg_bandwidth;
+      trans.load_rate_[(idx * num_levels) + level_idx] = load_rate / 1000 / 1000 / 1000;
+      if (level_idx == 0) {
+        trans.min_time_.push_back(min_time);
+        trans.avg_time_.push_back(avg_time);
+        trans.avg_bandwidth_.push_back(avg_bandwidth);
+        trans.peak_bandwidth_.push_back((double)curr_size / min_time / 1000 / 1000 / 1000);
+      }
+    }
+  }
+
+  for (uint32_t idx = 0; idx < load_buf_list.size(); idx++) {
+    err_ = backend_->PoolFree(load_buf_list[idx]);
+    ErrorCheck(err_);
+  }
+  err_ = backend_->SignalDestroy(signal);
+  ErrorCheck(err_);
+  err_ = backend_->PoolFree(src);
+  ErrorCheck(err_);
+  err_ = backend_->PoolFree(dst);
+  ErrorCheck(err_);
+}
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+
+// @brief: Read a list of ids from sysfs e.g. "0-7,16-23", ids
+// being appended in order. Returns false if the file is not found
+static bool ReadSysfsList(const std::string& path, vector<uint32_t>& id_list) {
+
+  std::ifstream file(path.c_str());
+  std::string id_ranges;
+  if ((file.good() == false) || (!std::getline(file, id_ranges))) {
+    return false;
+  }
+
+  std::stringstream stream(id_ranges);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    int count = sscanf(range.c_str(), "%u-%u", &first, &last);
+    if (count < 1) {
+      continue;
+    }
+    last = (count == 1) ? first : last;
+    for (uint32_t id = first; (id <= last) && (id < CPU_SETSIZE); id++) {
+      id_list.push_back(id);
+    }
+  }
+  return true;
+}
+
+// @brief: Bind the NUMA node of every device. Cpu devices are
+// reported by Roc runtime in the order of their NUMA nodes, whose
+// ids may be sparse e.g. nodes 0 and 2, hence ids are taken in order
+// from nodes online. A Gpu device belongs to the node of its nearest
+// Cpu device
+void RocmBandwidthTest::BindNumaNodes() {
+
+  vector<uint32_t> node_list;
+  ReadSysfsList(GetSysfsRoot() + "/devices/system/node/online", node_list);
+  uint32_t numa_idx = 0;
+  for (uint32_t idx = 0; idx < agent_index_; idx++) {
+    if (agent_list_[idx].device_type_ != HSA_DEVICE_TYPE_CPU) {
+      continue;
+    }
+    uint32_t numa_node = (numa_idx < node_list.size()) ? node_list[numa_idx] : numa_idx;
+    agent_list_[idx].numa_node_ = numa_node;
+    numa_idx++;
+
+    // Threads placed on a node whose cores are not known stay unpinned
+    vector<uint32_t> cpu_list;
+    GetNumaCpuList(numa_node, cpu_list);
+    if (cpu_list.empty()) {
+      std::cout << "Warning: Cores of NUMA node " << numa_node
+                << " are not known, threads on it are not pinned" << std::endl;
+    }
+  }
+
+  for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+    if (agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) {
+      continue;
+    }
+
+    // Link properties are reported for an agent accessing the pool
+    // of its peer, consult reverse direction if one is missing
+    uint32_t min_weight = 0xFFFFFFFF;
+    for (uint32_t cpu_idx = 0; cpu_idx < agent_index_; cpu_idx++) {
+      if (agent_list_[cpu_idx].device_type_ != HSA_DEVICE_TYPE_CPU) {
+        continue;
+      }
+      BindLinkPath(gpu_idx, cpu_idx);
+      uint32_t weight = link_matrix_[(gpu_idx * agent_index_) + cpu_idx];
+      if (weight == 0xFFFFFFFF) {
+        weight = link_matrix_[(cpu_idx * agent_index_) + gpu_idx];
+      }
+      if (weight < min_weight) {
+        min_weight = weight;
+        agent_list_[gpu_idx].numa_node_ = agent_list_[cpu_idx].numa_node_;
+      }
+    }
+  }
+}
+
+// @brief: Cpu device whose system memory is used for validating a
+// transaction. It is the Cpu device involved in the transaction if
+// any, else the Cpu device nearest to its source device
+uint32_t RocmBandwidthTest::GetTransHostIdx(const async_trans_t& trans) const {
+
+  uint32_t dev_list[2];
+  dev_list[0] = pool_list_[trans.copy.src_idx_].agent_index_;
+  dev_list[1] = pool_list_[trans.copy.dst_idx_].agent_index_;
+  for (uint32_t idx = 0; idx < 2; idx++) {
+    if (agent_list_[dev_list[idx]].device_type_ == HSA_DEVICE_TYPE_CPU) {
+      return dev_list[idx];
+    }
+  }
+  return GetPoolHostIdx(trans.copy.src_idx_);
+}
+
+// @brief: Cpu device nearest to a memory pool. It is the owner
+// of pool if a Cpu, else the Cpu device on NUMA node of owner
+uint32_t RocmBandwidthTest::GetPoolHostIdx(uint32_t pool_idx) const {
+
+  uint32_t dev_idx = pool_list_[pool_idx].agent_index_;
+  uint32_t numa_node = agent_list_[dev_idx].numa_node_;
+  if (agent_list_[dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+    return dev_idx;
+  }
+  for (uint32_t idx = 0; idx < agent_index_; idx++) {
+    if ((agent_list_[idx].device_type_ == HSA_DEVICE_TYPE_CPU) &&
+        (agent_list_[idx].numa_node_ == numa_node)) {
+      return idx;
+    }
+  }
+  return cpu_index_;
+}
+
+// @brief: System memory pool of a Cpu device, the system pool
+// is used if the device does not report a kernarg pool
+hsa_amd_memory_pool_t RocmBandwidthTest::GetHostPool(uint32_t host_idx) const {
+
+  hsa_amd_memory_pool_t pool = agent_list_[host_idx].host_pool_;
+  return (pool.handle == 0) ? sys_pool_ : pool;
+}
+
+// @brief: Cores of a NUMA node as listed by sysfs e.g. "0-7,16-23".
+// List is left empty if the node or its cores are not known
+void RocmBandwidthTest::GetNumaCpuList(uint32_t numa_node,
+                                       vector<uint32_t>& cpu_list) const {
+
+  std::stringstream path;
+  path << GetSysfsRoot() << "/devices/system/node/node" << numa_node << "/cpulist";
+  ReadSysfsList(path.str(), cpu_list);
+}
+
+// @brief: Pin the calling thread to the cores of a NUMA node.
+// Thread is left as is if the node or its cores are not known
+bool RocmBandwidthTest::PinToNumaNode(uint32_t numa_node) {
+
+  vector<uint32_t> cpu_list;
+  GetNumaCpuList(numa_node, cpu_list);
+  if (cpu_list.empty()) {
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (uint32_t idx = 0; idx < cpu_list.size(); idx++) {
+    CPU_SET(cpu_list[idx], &cpu_set);
+  }
+  return (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0);
+}
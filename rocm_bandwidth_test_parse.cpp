@@ -1,280 +1,515 @@
-////////////////////////////////////////////////////////////////////////////////
-//
-// The University of Illinois/NCSA
-// Open Source License (NCSA)
-// 
-// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
-// 
-// Developed by:
-// 
-//                 AMD Research and AMD HSA Software Development
-// 
-//                 Advanced Micro Devices, Inc.
-// 
-//                 www.amd.com
-// 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to
-// deal with the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-// 
-//  - Redistributions of source code must retain the above copyright notice,
-//    this list of conditions and the following disclaimers.
-//  - Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimers in
-//    the documentation and/or other materials provided with the distribution.
-//  - Neither the names of Advanced Micro Devices, Inc,
-//    nor the names of its contributors may be used to endorse or promote
-//    products derived from this Software without specific prior written
-//    permission.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-// DEALINGS WITH THE SOFTWARE.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-#include "common.hpp"
-#include "rocm_bandwidth_test.hpp"
-
-#include <algorithm>
-#include <sstream>
-#include <unistd.h>
-
-// Parse option value string. The string has one more decimal
-// values separated by comma - "3,6,9,12,15".
-static bool ParseOptionValue(char* value, vector<uint32_t>&value_list) {
- 
-  // Capture the option value string
-  std::stringstream stream;
-  stream << value;
-  
-  uint32_t token = 0x11231926;
-  do {
-    
-    // Read the option value
-    stream >> token;
-
-    // Update output list with values
-    value_list.push_back(token);
-
-    // Ignore the delimiter
-    if((stream.eof()) ||
-       (stream.peek() == ',')) {
-      stream.ignore();
-    } else {
-      return false;
-    }
-
-  } while (!stream.eof());
-
-  return true;
-}
-
-void RocmBandwidthTest::ParseArguments() {
-
-  bool print_help = false;
-  bool copy_all_bi = false;
-  bool copy_all_uni = false;
-  bool print_version = false;
-  bool print_topology = false;
-
-  // This will suppress prints from getopt implementation
-  // In case of error, it will return the character '?' as
-  // return value.
-  opterr = 0;
-  
-  int opt;
-  bool status;
-  while ((opt = getopt(usr_argc_, usr_argv_, "hqvctaAb:s:d:r:w:m:")) != -1) {
-    switch (opt) {
-
-      // Print help screen
-      case 'h':
-        print_help = true;
-        break;
-
-      // Print version of the test
-      case 'q':
-        print_version = true;
-        break;
-
-      // Print Cpu time
-      case 'c':
-        print_cpu_time_ = true;
-        break;
-
-      // Print system topology
-      case 't':
-        print_topology = true;
-        break;
-
-      // Set validation mode flag to true
-      case 'v':
-        validate_ = true;
-        req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
-        break;
-
-      // Collect list of agents involved in bidirectional copy operation
-      case 'b':
-        status = ParseOptionValue(optarg, bidir_list_);
-        if (status) {
-          req_copy_bidir_ = REQ_COPY_BIDIR;
-          break;
-        }
-        print_help = true;
-        break;
-
-      // Collect list of source buffers involved in unidirectional copy operation
-      case 's':
-        status = ParseOptionValue(optarg, src_list_);
-        if (status) {
-          req_copy_unidir_ = REQ_COPY_UNIDIR;
-          break;
-        }
-        print_help = true;
-        break;
-
-      // Collect list of destination buffers involved in unidirectional copy operation
-      case 'd':
-        status = ParseOptionValue(optarg, dst_list_);
-        if (status) {
-          req_copy_unidir_ = REQ_COPY_UNIDIR;
-          break;
-        }
-        print_help = true;
-        break;
-
-      // Collect request to read a buffer
-      case 'r':
-        req_read_ = REQ_READ;
-        status = ParseOptionValue(optarg, read_list_);
-        if (status == false) {
-          print_help = true;
-        }
-        break;
-
-      // Collect request to write a buffer
-      case 'w':
-        req_write_ = REQ_WRITE;
-        status = ParseOptionValue(optarg, write_list_);
-        if (status == false) {
-          print_help = true;
-        }
-        break;
-
-      // Size of buffers to use in copy and read/write operations
-      case 'm':
-        status = ParseOptionValue(optarg, size_list_);
-        if (status == false) {
-          print_help = true;
-        }
-        break;
-
-      // Enable Unidirectional copy among all valid buffers
-      case 'a':
-        copy_all_uni = true;
-        req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
-        break;
-
-      // Enable Bidirectional copy among all valid buffers
-      case 'A':
-        copy_all_bi = true;
-        req_copy_all_bidir_ = REQ_COPY_ALL_BIDIR;
-        break;
-
-      // getopt implementation returns the value of the unknown
-      // option or an option with missing operand in the variable
-      // optopt
-      case '?':
-        std::cout << "Argument is illegal or needs value: " << '?' << std::endl;
-        if ((optopt == 'b' || optopt == 's' || optopt == 'd' || optopt == 'e')) {
-          std::cout << "Error: Option -b -s -d and -e require argument" << std::endl;
-        }
-        print_help = true;
-        break;
-      default:
-        print_help = true;
-        break;
-    }
-  }
-  
-  // Print help screen if user option has "-h"
-  if (print_help) {
-    PrintHelpScreen();
-    exit(0);
-  }
-  
-  // Print version of the test
-  if (print_version) {
-    PrintVersion();
-    exit(0);
-  }
-  
-  // Initialize Roc Runtime
-  err_ = hsa_init();
-  ErrorCheck(err_);
-
-  // Discover the topology of RocR agent in system
-  DiscoverTopology();
-  
-  // Print system topology if user option has "-t"
-  if (print_topology) {
-    PrintTopology();
-    PrintAccessMatrix();
-    PrintLinkMatrix();
-    exit(0);
-  }
-
-  // Invalidate request if user has requested full
-  // copying for both unidirectional and bidirectional
-  if ((copy_all_bi) && (copy_all_uni)) {
-    PrintHelpScreen();
-    exit(0);
-  }
-
-  // Initialize buffer list if full copying in unidirectional mode is enabled
-  if ((copy_all_uni) || (validate_)) {
-    uint32_t size = pool_list_.size();
-    for (uint32_t idx = 0; idx < size; idx++) {
-      src_list_.push_back(idx);
-      dst_list_.push_back(idx);
-    }
-  }
-
-  // Initialize buffer list if full copying in bidirectional mode is enabled
-  if (copy_all_bi) {
-    uint32_t size = pool_list_.size();
-    for (uint32_t idx = 0; idx < size; idx++) {
-      bidir_list_.push_back(idx);
-    }
-  }
-
-  // Initialize the list of buffer sizes to use in copy/read/write operations
-  // For All Copy operations use only one buffer size
-  if (size_list_.size() == 0) {
-    uint32_t size_len = sizeof(SIZE_LIST)/sizeof(uint32_t);
-    for (uint32_t idx = 0; idx < size_len; idx++) {
-      if ((copy_all_bi) || (copy_all_uni) || (validate_)) {
-        if (idx == 16) {
-          size_list_.push_back(SIZE_LIST[idx]);
-        }
-      } else {
-        size_list_.push_back(SIZE_LIST[idx]);
-      }
-    }
-  } else {
-    uint32_t size_len = size_list_.size();
-    for (uint32_t idx = 0; idx < size_len; idx++) {
-      size_list_[idx] = size_list_[idx] * 1024 * 1024;
-    }
-  }
-  std::sort(size_list_.begin(), size_list_.end());
-}
-
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <unistd.h>
+
+// Parse option value string. The string has one more decimal
+// values separated by comma - "3,6,9,12,15".
+static bool ParseOptionValue(char* value, vector<uint32_t>&value_list) {
+ 
+  // Capture the option value string
+  std::stringstream stream;
+  stream << value;
+  
+  uint32_t token = 0x11231926;
+  do {
+    
+    // Read the option value
+    stream >> token;
+
+    // Update output list with values
+    value_list.push_back(token);
+
+    // Ignore the delimiter
+    if((stream.eof()) ||
+       (stream.peek() == ',')) {
+      stream.ignore();
+    } else {
+      return false;
+    }
+
+  } while (!stream.eof());
+
+  return true;
+}
+
+void RocmBandwidthTest::ParseArguments() {
+
+  bool print_help = false;
+  bool copy_all_bi = false;
+  bool copy_all_uni = false;
+  bool print_version = false;
+  bool print_topology = false;
+
+  // This will suppress prints from getopt implementation
+  // In case of error, it will return the character '?' as
+  // return value.
+  opterr = 0;
+  
+  int opt;
+  bool status;
+  while ((opt = getopt(usr_argc_, usr_argv_, "hqvctpSENkMlPCnaAb:s:d:r:w:m:R:L:H:V:B:I:D:")) != -1) {
+    switch (opt) {
+
+      // Print help screen
+      case 'h':
+        print_help = true;
+        break;
+
+      // Print version of the test
+      case 'q':
+        print_version = true;
+        break;
+
+      // Print Cpu time
+      case 'c':
+        print_cpu_time_ = true;
+        break;
+
+      // Print system topology
+      case 't':
+        print_topology = true;
+        break;
+
+      // Report result matrices per memory pool
+      case 'p':
+        pool_matrix_ = true;
+        break;
+
+      // Sweep all buffer sizes in all-pairs modes
+      case 'S':
+        sweep_sizes_ = true;
+        break;
+
+      // Report link efficiency against theoretical capacity
+      case 'E':
+        report_efficiency_ = true;
+        break;
+
+      // Measure every Gpu against system memory of every NUMA node
+      case 'N':
+        numa_sweep_ = true;
+        break;
+
+      // Measure every host copy kernel against pools accessible to Cpu
+      case 'k':
+        kernel_sweep_ = true;
+        break;
+
+      // Measure STREAM operations against pools accessible to Cpu
+      case 'M':
+        stream_sweep_ = true;
+        break;
+
+      // Measure latency of loads by every Cpu from pools it can access
+      case 'l':
+        latency_sweep_ = true;
+        break;
+
+      // Measure copies to every Gpu from pool, locked and staged host buffers
+      case 'P':
+        source_sweep_ = true;
+        break;
+
+      // Measure collectives across all Gpu devices
+      case 'C':
+        collective_sweep_ = true;
+        break;
+
+      // Measure bandwidth across bipartitions of Gpu devices, either
+      // all balanced ones or listed devices against the rest
+      case 'B':
+        bisection_sweep_ = true;
+        if (std::string(optarg) == "all") {
+          break;
+        }
+        status = ParseOptionValue(optarg, bisection_side_list_);
+        if (status) {
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Measure interference among copy paths, either of all devices
+      // or of listed devices
+      case 'I':
+        interference_sweep_ = true;
+        if (std::string(optarg) == "all") {
+          break;
+        }
+        status = ParseOptionValue(optarg, interference_dev_list_);
+        if (status) {
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Measure copies between Cpu and Gpu devices under load of
+      // host memory, either at default levels or listed levels
+      case 'D':
+        host_load_sweep_ = true;
+        if (std::string(optarg) == "all") {
+          break;
+        }
+        status = ParseOptionValue(optarg, load_level_list_);
+        if (status) {
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Collect sizes of pages, in KB, backing host buffers of NUMA sweep
+      case 'H':
+        status = ParseOptionValue(optarg, page_kind_list_);
+        if (status == false) {
+          print_help = true;
+        }
+        break;
+
+      // Build transactions and estimate their runtime only
+      case 'n':
+        dry_run_ = true;
+        break;
+
+      // Record topology of system into a snapshot file
+      case 'R':
+        topology_record_ = optarg;
+        break;
+
+      // Replay topology of system from a snapshot file
+      case 'L':
+        topology_replay_ = optarg;
+        break;
+
+      // Validate a random sample of copies, spending at most the
+      // given percentage of time of copies on their validation
+      case 'V': {
+        char* end = NULL;
+        double budget = strtod(optarg, &end);
+        if ((end == optarg) || (*end != '\0') || (budget <= 0) || (budget > 100)) {
+          print_help = true;
+        }
+        validate_budget_ = budget / 100;
+        break;
+      }
+
+      // Set validation mode flag to true
+      case 'v':
+        validate_ = true;
+        req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+        break;
+
+      // Collect list of agents involved in bidirectional copy operation
+      case 'b':
+        status = ParseOptionValue(optarg, bidir_list_);
+        if (status) {
+          req_copy_bidir_ = REQ_COPY_BIDIR;
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Collect list of source buffers involved in unidirectional copy operation
+      case 's':
+        status = ParseOptionValue(optarg, src_list_);
+        if (status) {
+          req_copy_unidir_ = REQ_COPY_UNIDIR;
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Collect list of destination buffers involved in unidirectional copy operation
+      case 'd':
+        status = ParseOptionValue(optarg, dst_list_);
+        if (status) {
+          req_copy_unidir_ = REQ_COPY_UNIDIR;
+          break;
+        }
+        print_help = true;
+        break;
+
+      // Collect request to read a buffer
+      case 'r':
+        req_read_ = REQ_READ;
+        status = ParseOptionValue(optarg, read_list_);
+        if (status == false) {
+          print_help = true;
+        }
+        break;
+
+      // Collect request to write a buffer
+      case 'w':
+        req_write_ = REQ_WRITE;
+        status = ParseOptionValue(optarg, write_list_);
+        if (status == false) {
+          print_help = true;
+        }
+        break;
+
+      // Size of buffers to use in copy and read/write operations
+      case 'm':
+        status = ParseOptionValue(optarg, size_list_);
+        if (status == false) {
+          print_help = true;
+        }
+        break;
+
+      // Enable Unidirectional copy among all valid buffers
+      case 'a':
+        copy_all_uni = true;
+        req_copy_all_unidir_ = REQ_COPY_ALL_UNIDIR;
+        break;
+
+      // Enable Bidirectional copy among all valid buffers
+      case 'A':
+        copy_all_bi = true;
+        req_copy_all_bidir_ = REQ_COPY_ALL_BIDIR;
+        break;
+
+      // getopt implementation returns the value of the unknown
+      // option or an option with missing operand in the variable
+      // optopt
+      case '?':
+        std::cout << "Argument is illegal or needs value: " << '?' << std::endl;
+        if ((optopt == 'b' || optopt == 's' || optopt == 'd' || optopt == 'e' ||
+             optopt == 'r' || optopt == 'w' || optopt == 'm' || optopt == 'H' ||
+             optopt == 'R' || optopt == 'L' || optopt == 'V' || optopt == 'B' ||
+             optopt == 'I' || optopt == 'D')) {
+          std::cout << "Error: Option -b -s -d -e -r -w -m -H -R -L -V -B -I and -D require argument"
+                    << std::endl;
+        }
+        print_help = true;
+        break;
+      default:
+        print_help = true;
+        break;
+    }
+  }
+  
+  // Print help screen if user option has "-h"
+  if (print_help) {
+    PrintHelpScreen();
+    exit(0);
+  }
+  
+  // Print version of the test
+  if (print_version) {
+    PrintVersion();
+    exit(0);
+  }
+  
+  // Replay topology from a snapshot, no device is needed and
+  // hence requests can only be run dry
+  if (topology_replay_ != NULL) {
+    if (ReadTopology(topology_replay_, true) == false) {
+      std::cout << "Error: Unable to replay topology from: "
+                << topology_replay_ << std::endl;
+      exit(1);
+    }
+    dry_run_ = true;
+  } else {
+
+    // Initialize Roc Runtime
+    err_ = backend_->Init();
+    ErrorCheck(err_);
+
+    // Discover the topology of RocR agent in system. Access and links
+    // among all agents are needed only to print topology, to record it
+    // or to run all-pairs requests, others query them as needed
+    bool eager = ((print_topology) || (copy_all_bi) || (copy_all_uni) ||
+                  (validate_) || (numa_sweep_) || (latency_sweep_) ||
+                  (collective_sweep_) || (bisection_sweep_) ||
+                  (interference_sweep_) || (host_load_sweep_) ||
+                  (topology_record_ != NULL));
+    DiscoverTopology(eager);
+  }
+  BindNumaNodes();
+
+  // Record topology of system if user has requested it
+  if (topology_record_ != NULL) {
+    SaveTopology(topology_record_);
+  }
+  
+  // Print system topology if user option has "-t"
+  if (print_topology) {
+    PrintTopology();
+    PrintAccessMatrix();
+    PrintLinkMatrix();
+    PrintLinkDescriptors();
+    exit(0);
+  }
+
+  // Invalidate request if user has requested full
+  // copying for both unidirectional and bidirectional
+  if ((copy_all_bi) && (copy_all_uni)) {
+    PrintHelpScreen();
+    exit(0);
+  }
+
+  // Sampled validation applies to copies that are not validated
+  // in full already
+  if ((validate_budget_ > 0) && (validate_)) {
+    PrintHelpScreen();
+    exit(0);
+  }
+
+  // NUMA sweep reports its own matrices and cannot
+  // be combined with other full copying requests
+  if ((numa_sweep_) && ((copy_all_bi) || (copy_all_uni) || (validate_))) {
+    PrintHelpScreen();
+    exit(0);
+  }
+
+  // Host copy kernel, STREAM, latency, host source, collective,
+  // bisection, interference and host load sweeps report their own
+  // matrices and cannot be combined with other full copying
+  uint32_t host_sweeps = (kernel_sweep_) + (stream_sweep_) +
+                         (latency_sweep_) + (source_sweep_) +
+                         (collective_sweep_) + (bisection_sweep_) +
+                         (interference_sweep_) + (host_load_sweep_);
+  if ((host_sweeps > 0) &&
+      ((copy_all_bi) || (copy_all_uni) || (validate_) || (numa_sweep_) ||
+       (host_sweeps > 1))) {
+    PrintHelpScreen();
+    exit(0);
+  }
+
+  // Initialize buffer list if full copying in unidirectional mode is enabled
+  if ((copy_all_uni) || (validate_)) {
+    uint32_t size = pool_list_.size();
+    for (uint32_t idx = 0; idx < size; idx++) {
+      src_list_.push_back(idx);
+      dst_list_.push_back(idx);
+    }
+  }
+
+  // Initialize buffer list if full copying in bidirectional mode is enabled
+  if (copy_all_bi) {
+    uint32_t size = pool_list_.size();
+    for (uint32_t idx = 0; idx < size; idx++) {
+      bidir_list_.push_back(idx);
+    }
+  }
+
+  // Initialize the list of buffer sizes to use in copy/read/write operations
+  // For All Copy operations use only one buffer size unless user has
+  // requested a sweep of all buffer sizes
+  if (size_list_.size() == 0) {
+    uint32_t size_len = sizeof(SIZE_LIST)/sizeof(uint32_t);
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+      if (((copy_all_bi) || (copy_all_uni) || (validate_) ||
+           (numa_sweep_) || (latency_sweep_) || (collective_sweep_) ||
+           (bisection_sweep_) || (interference_sweep_) ||
+           (host_load_sweep_)) &&
+          (sweep_sizes_ == false)) {
+        if (idx == 16) {
+          size_list_.push_back(SIZE_LIST[idx]);
+        }
+      } else {
+        size_list_.push_back(SIZE_LIST[idx]);
+      }
+    }
+  } else {
+    uint32_t size_len = size_list_.size();
+    for (uint32_t idx = 0; idx < size_len; idx++) {
+      size_list_[idx] = size_list_[idx] * 1024 * 1024;
+    }
+  }
+  std::sort(size_list_.begin(), size_list_.end());
+
+  // Levels of host load are percents of the unthrottled rate of
+  // load generator, led by the unloaded level every other level is
+  // compared against. Stream of load generator must be known
+  if (host_load_sweep_) {
+    if (load_level_list_.size() == 0) {
+      uint32_t level_list[] = { 0, 25, 50, 75, 100 };
+      load_level_list_.assign(level_list, level_list + 5);
+    }
+    load_level_list_.push_back(0);
+    std::sort(load_level_list_.begin(), load_level_list_.end());
+    load_level_list_.erase(std::unique(load_level_list_.begin(), load_level_list_.end()),
+                           load_level_list_.end());
+    if (host_load_op_name_ != NULL) {
+      host_load_op_ = HostLoadGenerator::GetOp(host_load_op_name_);
+    }
+    if ((load_level_list_.back() > 100) || (host_load_op_ == HOST_LOAD_OP_COUNT)) {
+      PrintHelpScreen();
+      exit(0);
+    }
+  }
+
+  // Map sizes of pages backing host buffers to their kinds. Pages
+  // apply only to NUMA sweep, which uses buffers of pool by default
+  if ((page_kind_list_.size() != 0) && (numa_sweep_ == false)) {
+    PrintHelpScreen();
+    exit(0);
+  }
+  uint32_t kind_len = page_kind_list_.size();
+  vector<uint32_t> kind_list;
+  for (uint32_t idx = 0; idx < kind_len; idx++) {
+    uint32_t page_kind = HostBufferProvider::GetPageKind(page_kind_list_[idx]);
+    if (page_kind == HOST_PAGE_KIND_COUNT) {
+      PrintHelpScreen();
+      exit(0);
+    }
+    if (HostBufferProvider::IsPageKindAvailable(page_kind, size_list_.back(),
+                                                GetSysfsRoot()) == false) {
+      std::cout << "Warning: Pages of " << HostBufferProvider::GetPageKindName(page_kind)
+                << " are not available, skipping them" << std::endl;
+      continue;
+    }
+    if (std::find(kind_list.begin(), kind_list.end(), page_kind) == kind_list.end()) {
+      kind_list.push_back(page_kind);
+    }
+  }
+  page_kind_list_ = kind_list;
+  if (page_kind_list_.size() == 0) {
+    page_kind_list_.push_back(HOST_PAGE_POOL);
+  }
+}
+
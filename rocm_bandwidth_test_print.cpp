@@ -1,332 +1,536 @@
-////////////////////////////////////////////////////////////////////////////////
-//
-// The University of Illinois/NCSA
-// Open Source License (NCSA)
-// 
-// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
-// 
-// Developed by:
-// 
-//                 AMD Research and AMD HSA Software Development
-// 
-//                 Advanced Micro Devices, Inc.
-// 
-//                 www.amd.com
-// 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to
-// deal with the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-// 
-//  - Redistributions of source code must retain the above copyright notice,
-//    this list of conditions and the following disclaimers.
-//  - Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimers in
-//    the documentation and/or other materials provided with the distribution.
-//  - Neither the names of Advanced Micro Devices, Inc,
-//    nor the names of its contributors may be used to endorse or promote
-//    products derived from this Software without specific prior written
-//    permission.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-// DEALINGS WITH THE SOFTWARE.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-#include "common.hpp"
-#include "rocm_bandwidth_test.hpp"
-
-// @Brief: Print Help Menu Screen
-void RocmBandwidthTest::PrintHelpScreen() {
-
-  std::cout << std::endl;
-  std::cout << "Supported arguments:" << std::endl;
-  std::cout << std::endl;
-  std::cout << "\t -h    Prints the help screen" << std::endl;
-  std::cout << "\t -q    Query version of the test" << std::endl;
-  std::cout << "\t -v    Run the test in validation mode" << std::endl;
-  std::cout << "\t -c    Time the operation using CPU Timers" << std::endl;
-  std::cout << "\t -t    Prints system topology and allocatable memory info" << std::endl;
-  std::cout << "\t -m    List of buffer sizes to use, specified in Megabytes" << std::endl;
-  std::cout << "\t -b    List devices to use in bidirectional copy operations" << std::endl;
-  std::cout << "\t -s    List of source devices to use in copy unidirectional operations" << std::endl;
-  std::cout << "\t -d    List of destination devices to use in unidirectional copy operations" << std::endl;
-  std::cout << "\t -a    Perform Unidirectional Copy involving all device combinations" << std::endl;
-  std::cout << "\t -A    Perform Bidirectional Copy involving all device combinations" << std::endl;
-  std::cout << std::endl;
-
-  std::cout << std::endl;
-
-}
-
-// @brief: Print the version of the test
-void RocmBandwidthTest::PrintVersion() const {
-
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  std::cout << std::endl;
-  std::cout.width(format);
-  std::cout << "";
-  std::cout << "RocmBandwidthTest Version: " << GetVersion() << std::endl;
-}
-
-// @brief: Print the topology of Memory Pools and Devices present in system
-void RocmBandwidthTest::PrintTopology() {
-
-  uint32_t format = 10;
-  size_t count = agent_pool_list_.size();
-  std::cout << std::endl;
-  for (uint32_t idx = 0; idx < count; idx++) {
-    agent_pool_info_t node = agent_pool_list_.at(idx);
-    
-    std::cout.width(format);
-    std::cout << "";
-    std::cout.width(format);
-
-    // Print device info
-    std::cout << "Device Index:                             "
-              << node.agent.index_ << std::endl;
-    
-    std::cout.width(format);
-    std::cout << "";
-    std::cout.width(format);
-    
-    if (HSA_DEVICE_TYPE_CPU == node.agent.device_type_)
-      std::cout << "  Device Type:                            CPU" << std::endl;
-    else if (HSA_DEVICE_TYPE_GPU == node.agent.device_type_)
-      std::cout << "  Device Type:                            GPU" << std::endl;
-
-    // Print pool info
-    size_t pool_count = node.pool_list.size();
-    for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
-      
-      std::cout.width(format);
-      std::cout << "";
-      std::cout.width(format);
-      
-      std::cout << "    Allocatable Memory Size (KB):         "
-           << node.pool_list.at(jdx).allocable_size_ / 1024 << std::endl;
-
-      /*
-      std::cout << "        is fine-grained:                  "
-           << node.pool_list.at(jdx).is_fine_grained_ << std::endl;
-      */
-    }
-    std::cout << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-void RocmBandwidthTest::PrintAccessMatrix() const {
-
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  
-  std::cout << "Device Access";
-  std::cout << std::endl;
-  std::cout << std::endl;
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  std::cout << "D/D";
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    std::cout.width(format);
-    std::cout << idx0;
-  }
-  std::cout << std::endl;
-  std::cout << std::endl;
-
-  for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
-    std::cout.width(format);
-    std::cout << "";
-    std::cout.width(format);
-    std::cout << src_idx;
-    for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
-      uint32_t path_exists = access_matrix_[(src_idx * agent_index_) + dst_idx];
-      std::cout.width(format);
-      if (path_exists == 2) {
-        path_exists = 1;
-      }
-      std::cout << path_exists;
-    }
-    std::cout << std::endl;
-    std::cout << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-void RocmBandwidthTest::PrintLinkMatrix() const {
-
-  // uint32_t format = 12;
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  // std::cout << std::endl;
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  std::cout << "Device Numa Distance";
-  std::cout << std::endl;
-  std::cout << std::endl;
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  std::cout << "D/D";
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    std::cout.width(format);
-    std::cout << idx0;
-  }
-  std::cout << std::endl;
-  std::cout << std::endl;
-
-  for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
-    std::cout.width(format);
-    std::cout << "";
-    std::cout.width(format);
-    std::cout << src_idx;
-    for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
-      uint32_t link_weight = link_matrix_[(src_idx * agent_index_) + dst_idx];
-      std::cout.width(format);
-      if (link_weight == 0xFFFFFFFF) {
-        std::cout << "N/A";
-      } else {
-        std::cout << link_weight;
-      }
-    }
-    std::cout << std::endl;
-    std::cout << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-// @brief: Print info on Devices in system
-void RocmBandwidthTest::PrintAgentsList() {
-
-  size_t count = agent_pool_list_.size();
-  for (uint32_t idx = 0; idx < count; idx++) {
-    std::cout << std::endl;
-    agent_pool_info_t node = agent_pool_list_.at(idx);
-    std::cout << "Device Index:                             "
-              << node.agent.index_ << std::endl;
-    if (HSA_DEVICE_TYPE_CPU == node.agent.device_type_)
-      std::cout << "  Device Type:                            CPU" << std::endl;
-    else if (HSA_DEVICE_TYPE_GPU == node.agent.device_type_)
-      std::cout << "  Device Type:                            GPU" << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-// @brief: Print info on memory pools in system
-void RocmBandwidthTest::PrintPoolsList() {
-
-  size_t pool_count = pool_list_.size();
-  for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
-    std::cout << std::endl;
-    std::cout << "Memory Pool Idx:                          "
-         << pool_list_.at(jdx).index_ << std::endl;
-    std::cout << "  max allocable size in KB:               "
-         << pool_list_.at(jdx).allocable_size_ / 1024 << std::endl;
-    std::cout << "  segment id:                             "
-         << pool_list_.at(jdx).segment_ << std::endl;
-    std::cout << "  is kernarg:                             "
-         << pool_list_.at(jdx).is_kernarg_ << std::endl;
-    std::cout << "  is fine-grained:                        "
-         << pool_list_.at(jdx).is_fine_grained_ << std::endl;
-    std::cout << "  accessible to owner:                    "
-         << pool_list_.at(jdx).owner_access_ << std::endl;
-    std::cout << "  accessible to all by default:           "
-         << pool_list_.at(jdx).access_to_all_ << std::endl;
-  }
-  std::cout << std::endl;
-
-}
-
-// @brief: Print the list of transactions that will be executed
-void RocmBandwidthTest::PrintTransList() {
-
-  size_t count = trans_list_.size();
-  for (uint32_t idx = 0; idx < count; idx++) {
-    async_trans_t trans = trans_list_.at(idx);
-    std::cout << std::endl;
-    std::cout << "                 Transaction Id: " << idx << std::endl;
-    std::cout << "               Transaction Type: " << trans.req_type_ << std::endl;
-    if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
-      std::cout << "Rocm Kernel used by Transaction: " << trans.kernel.code_ << std::endl;
-      std::cout << "Rocm Buffer index Used by Kernel: " << trans.kernel.pool_idx_ << std::endl;
-      std::cout << "  Rocm Device used for Execution: " << trans.kernel.agent_idx_ << std::endl;
-    }
-    if ((trans.req_type_ == REQ_COPY_BIDIR) || (trans.req_type_ == REQ_COPY_UNIDIR)) {
-      std::cout << "   Src Buffer used in Copy: " << trans.copy.src_idx_ << std::endl;
-      std::cout << "   Dst Buffer used in Copy: " << trans.copy.dst_idx_ << std::endl;
-    }
-    if ((trans.req_type_ == REQ_COPY_ALL_BIDIR) || (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) {
-      std::cout << "   Src Memory Pool used in Copy: " << trans.copy.src_idx_ << std::endl;
-      std::cout << "   Dst Memory Pool used in Copy: " << trans.copy.dst_idx_ << std::endl;
-    }
-
-  }
-  std::cout << std::endl;
-}
-
-// @brief: Prints error message when a request to copy between
-// source buffer and destination buffer is not possible
-void RocmBandwidthTest::PrintCopyAccessError(uint32_t src_idx, uint32_t dst_idx) {
-
-  // Retrieve Roc runtime handles for Src memory pool and devices
-  uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-  hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
-    
-  // Retrieve Roc runtime handles for Dst memory pool and devices
-  uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-  hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
-
-  std::cout << std::endl;
-  //std::cout << "Index of Src Memory: " << src_idx << std::endl;
-  //std::cout << "Index of Dst Memory: " << dst_idx << std::endl;
-  std::cout << "Src Device: Index "
-            << src_dev_idx
-            << ", Type: "
-            << ((src_dev_type == HSA_DEVICE_TYPE_CPU) ? "CPU" : "GPU") << std::endl;
-  std::cout << "Dst Device: Index "
-            << dst_dev_idx
-            << ", Type: "
-            << ((dst_dev_type == HSA_DEVICE_TYPE_CPU) ? "CPU" : "GPU") << std::endl;
-  std::cout << "Rocm Device hosting Src Memory cannot ACCESS Dst Memory" << std::endl;
-  std::cout << std::endl;
-}
-
-// @brief: Prints error message when a request to read / write from
-// a buffer of a device is not possible
-void RocmBandwidthTest::PrintIOAccessError(uint32_t exec_idx, uint32_t pool_idx) {
-
-  // Retrieve device type of executing device
-  hsa_device_type_t exec_dev_type = agent_list_[exec_idx].device_type_;
-    
-  // Retrieve device type of memory pool's device
-  uint32_t pool_dev_idx = pool_list_[pool_idx].agent_index_;
-  hsa_device_type_t pool_dev_type = agent_list_[pool_dev_idx].device_type_;
-
-  std::cout << std::endl;
-  std::cout << "Index of Executing Device: " << exec_idx << std::endl;
-  std::cout << "Device Type of Executing Device: " << exec_dev_type << std::endl;
-
-  std::cout << "Index of Buffer: " << pool_idx << std::endl;
-  std::cout << "Index of Buffer's Device: " << pool_dev_idx << std::endl;
-  std::cout << "Device Type Hosting Buffer: " << pool_dev_type << std::endl;
-  std::cout << "Rocm Device executing Read / Write request cannot ACCESS Buffer" << std::endl;
-  std::cout << std::endl;
-}
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <sstream>
+
+// @Brief: Print Help Menu Screen
+void RocmBandwidthTest::PrintHelpScreen() {
+
+  std::cout << std::endl;
+  std::cout << "Supported arguments:" << std::endl;
+  std::cout << std::endl;
+  std::cout << "\t -h    Prints the help screen" << std::endl;
+  std::cout << "\t -q    Query version of the test" << std::endl;
+  std::cout << "\t -v    Run the test in validation mode" << std::endl;
+  std::cout << "\t -V    Validate a random sample of copies, within a percentage of their time" << std::endl;
+  std::cout << "\t -c    Time the operation using CPU Timers" << std::endl;
+  std::cout << "\t -t    Prints system topology and allocatable memory info" << std::endl;
+  std::cout << "\t -m    List of buffer sizes to use, specified in Megabytes" << std::endl;
+  std::cout << "\t -b    List devices to use in bidirectional copy operations" << std::endl;
+  std::cout << "\t -s    List of source devices to use in copy unidirectional operations" << std::endl;
+  std::cout << "\t -d    List of destination devices to use in unidirectional copy operations" << std::endl;
+  std::cout << "\t -a    Perform Unidirectional Copy involving all device combinations" << std::endl;
+  std::cout << "\t -A    Perform Bidirectional Copy involving all device combinations" << std::endl;
+  std::cout << "\t -S    Sweep all buffer sizes in -a, -A and -v, reporting one matrix per size" << std::endl;
+  std::cout << "\t -E    Report efficiency of -a and -A results against theoretical link capacity" << std::endl;
+  std::cout << "\t -n    Print transactions and their estimated runtime without running them" << std::endl;
+  std::cout << "\t -R    Record system topology into a snapshot file" << std::endl;
+  std::cout << "\t -L    Replay system topology from a snapshot file, implies -n" << std::endl;
+  std::cout << "\t -p    Report results of -a, -A and -v per memory pool instead of per device" << std::endl;
+  std::cout << "\t -N    Perform Copy between every Gpu and system memory of every NUMA node" << std::endl;
+  std::cout << "\t -k    Perform Copy within every pool accessible to Cpu using every host copy kernel" << std::endl;
+  std::cout << "\t -M    Run STREAM Copy, Scale, Add and Triad on every pool accessible to Cpu" << std::endl;
+  std::cout << "\t -l    Measure pointer chase latency of every Cpu into every pool it can access" << std::endl;
+  std::cout << "\t -P    Perform Copy to every Gpu from pool, locked and staged malloc host buffers" << std::endl;
+  std::cout << "\t -C    Run AllReduce, Broadcast, AllToAll and ReduceScatter across all Gpus" << std::endl;
+  std::cout << "\t -B    Measure bisection bandwidth across balanced splits of Gpus, given \"all\"," << std::endl;
+  std::cout << "\t       or across the split of listed Gpus against the rest" << std::endl;
+  std::cout << "\t -I    Measure slowdown of every copy path while another one runs, among" << std::endl;
+  std::cout << "\t       all devices given \"all\", or among listed devices" << std::endl;
+  std::cout << "\t -D    Perform Copy between every Cpu and Gpu while loading host memory, at" << std::endl;
+  std::cout << "\t       levels of 0, 25, 50, 75 and 100 percent given \"all\", or listed levels" << std::endl;
+  std::cout << "\t -H    List of page sizes in KB backing host buffers of -N, one sweep per size:" << std::endl;
+  std::cout << "\t       0 for pool of runtime, 4, 2048 for THP and 1048576 for hugetlbfs" << std::endl;
+  std::cout << std::endl;
+
+  std::cout << std::endl;
+
+}
+
+// @brief: Print the version of the test
+void RocmBandwidthTest::PrintVersion() const {
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout << std::endl;
+  std::cout.width(format);
+  std::cout << "";
+  std::cout << "RocmBandwidthTest Version: " << GetVersion() << std::endl;
+}
+
+// @brief: Print the topology of Memory Pools and Devices present in system
+void RocmBandwidthTest::PrintTopology() {
+
+  uint32_t format = 10;
+  size_t count = agent_pool_list_.size();
+  std::cout << std::endl;
+  for (uint32_t idx = 0; idx < count; idx++) {
+    agent_pool_info_t node = agent_pool_list_.at(idx);
+    
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+
+    // Print device info
+    std::cout << "Device Index:                             "
+              << node.agent.index_ << std::endl;
+    
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    
+    if (HSA_DEVICE_TYPE_CPU == node.agent.device_type_)
+      std::cout << "  Device Type:                            CPU" << std::endl;
+    else if (HSA_DEVICE_TYPE_GPU == node.agent.device_type_)
+      std::cout << "  Device Type:                            GPU" << std::endl;
+
+    // Print NUMA node of device
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "  NUMA Node:                              "
+              << agent_list_[node.agent.index_].numa_node_ << std::endl;
+
+    // Print PCIe link of device if known
+    const agent_info_t& agent = agent_list_[node.agent.index_];
+    if (agent.pcie_max_width_ != 0) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << "  PCIe Link (Current / Max):              "
+                << agent.pcie_cur_speed_ << " GT/s x" << agent.pcie_cur_width_
+                << " / "
+                << agent.pcie_max_speed_ << " GT/s x" << agent.pcie_max_width_
+                << std::endl;
+    }
+
+    // Print pool info
+    size_t pool_count = node.pool_list.size();
+    for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
+      
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      
+      std::cout << "    Allocatable Memory Size (KB):         "
+           << node.pool_list.at(jdx).allocable_size_ / 1024 << std::endl;
+
+      /*
+      std::cout << "        is fine-grained:                  "
+           << node.pool_list.at(jdx).is_fine_grained_ << std::endl;
+      */
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+void RocmBandwidthTest::PrintAccessMatrix() const {
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  
+  std::cout << "Device Access";
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "D/D";
+  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+    std::cout.width(format);
+    std::cout << idx0;
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << src_idx;
+    for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
+      uint32_t path_exists = access_matrix_[(src_idx * agent_index_) + dst_idx];
+      std::cout.width(format);
+      if (path_exists == 2) {
+        path_exists = 1;
+      }
+      std::cout << path_exists;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+void RocmBandwidthTest::PrintLinkMatrix() const {
+
+  // uint32_t format = 12;
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  // std::cout << std::endl;
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "Device Numa Distance";
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "D/D";
+  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
+    std::cout.width(format);
+    std::cout << idx0;
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << src_idx;
+    for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
+      uint32_t link_weight = link_matrix_[(src_idx * agent_index_) + dst_idx];
+      std::cout.width(format);
+      if (link_weight == 0xFFFFFFFF) {
+        std::cout << "N/A";
+      } else {
+        std::cout << link_weight;
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+static const char* getLinkTypeStr(hsa_amd_link_info_type_t link_type) {
+
+  switch (link_type) {
+    case HSA_AMD_LINK_INFO_TYPE_HYPERTRANSPORT:
+      return "HT";
+    case HSA_AMD_LINK_INFO_TYPE_QPI:
+      return "QPI";
+    case HSA_AMD_LINK_INFO_TYPE_PCIE:
+      return "PCIe";
+    case HSA_AMD_LINK_INFO_TYPE_INFINBAND:
+      return "IB";
+    case HSA_AMD_LINK_INFO_TYPE_XGMI:
+      return "XGMI";
+    default:
+      return "Unknown";
+  }
+}
+
+std::string RocmBandwidthTest::GetLinkPathStr(uint32_t src_dev_idx,
+                                              uint32_t dst_dev_idx) const {
+
+  if (src_dev_idx == dst_dev_idx) {
+    return "Local";
+  }
+
+  // Link properties are reported for an agent accessing the pool
+  // of its peer, consult reverse direction if one is missing
+  uint32_t path_idx = (src_dev_idx * agent_index_) + dst_dev_idx;
+  if (link_hops_[path_idx].empty()) {
+    path_idx = (dst_dev_idx * agent_index_) + src_dev_idx;
+  }
+
+  const vector<hsa_amd_memory_pool_link_info_t>& hops = link_hops_[path_idx];
+  if (hops.empty()) {
+    return "N/A";
+  }
+
+  std::stringstream path;
+  for (uint32_t idx = 0; idx < hops.size(); idx++) {
+    path << ((idx == 0) ? "" : " > ") << getLinkTypeStr(hops[idx].link_type);
+  }
+  return path.str();
+}
+
+// @brief: Print properties of every hop of the links among devices.
+// Latency is in nanoseconds and bandwidth in MB/s, as reported by
+// Roc runtime, zero if the runtime does not report them
+void RocmBandwidthTest::PrintLinkDescriptors() const {
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout << "Device Link Descriptors";
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  const char* header[] = { "Src", "Dst", "Hop", "Type", "Distance",
+                           "Latency(ns)", "BW(MB/s)", "Atomics",
+                           "Coherent" };
+  const uint32_t width[] = { 6, 6, 6, 8, 10, 16, 16, 10, 10 };
+  std::cout.width(format);
+  std::cout << "";
+  for (uint32_t idx = 0; idx < 9; idx++) {
+    std::cout.width(width[idx]);
+    std::cout << header[idx];
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  for (uint32_t src_idx = 0; src_idx < agent_index_; src_idx++) {
+    for (uint32_t dst_idx = 0; dst_idx < agent_index_; dst_idx++) {
+      const vector<hsa_amd_memory_pool_link_info_t>& hops =
+                        link_hops_[(src_idx * agent_index_) + dst_idx];
+      for (uint32_t hop_idx = 0; hop_idx < hops.size(); hop_idx++) {
+        const hsa_amd_memory_pool_link_info_t& hop = hops[hop_idx];
+        std::stringstream latency;
+        latency << hop.min_latency << " - " << hop.max_latency;
+        std::stringstream bandwidth;
+        bandwidth << hop.min_bandwidth << " - " << hop.max_bandwidth;
+        std::stringstream atomics;
+        atomics << (hop.atomic_support_32bit ? "32" : "");
+        atomics << ((hop.atomic_support_32bit && hop.atomic_support_64bit) ? "/" : "");
+        atomics << (hop.atomic_support_64bit ? "64" : "");
+        std::string atomics_str = atomics.str();
+
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(width[0]);
+        std::cout << src_idx;
+        std::cout.width(width[1]);
+        std::cout << dst_idx;
+        std::cout.width(width[2]);
+        std::cout << hop_idx;
+        std::cout.width(width[3]);
+        std::cout << getLinkTypeStr(hop.link_type);
+        std::cout.width(width[4]);
+        std::cout << hop.numa_distance;
+        std::cout.width(width[5]);
+        std::cout << latency.str();
+        std::cout.width(width[6]);
+        std::cout << bandwidth.str();
+        std::cout.width(width[7]);
+        std::cout << (atomics_str.empty() ? "No" : atomics_str);
+        std::cout.width(width[8]);
+        std::cout << (hop.coherent_support ? "Yes" : "No");
+        std::cout << std::endl;
+      }
+    }
+  }
+  std::cout << std::endl;
+}
+
+// @brief: Print info on Devices in system
+void RocmBandwidthTest::PrintAgentsList() {
+
+  size_t count = agent_pool_list_.size();
+  for (uint32_t idx = 0; idx < count; idx++) {
+    std::cout << std::endl;
+    agent_pool_info_t node = agent_pool_list_.at(idx);
+    std::cout << "Device Index:                             "
+              << node.agent.index_ << std::endl;
+    if (HSA_DEVICE_TYPE_CPU == node.agent.device_type_)
+      std::cout << "  Device Type:                            CPU" << std::endl;
+    else if (HSA_DEVICE_TYPE_GPU == node.agent.device_type_)
+      std::cout << "  Device Type:                            GPU" << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+// @brief: Print info on memory pools in system
+void RocmBandwidthTest::PrintPoolsList() {
+
+  size_t pool_count = pool_list_.size();
+  for (uint32_t jdx = 0; jdx < pool_count; jdx++) {
+    std::cout << std::endl;
+    std::cout << "Memory Pool Idx:                          "
+         << pool_list_.at(jdx).index_ << std::endl;
+    std::cout << "  max allocable size in KB:               "
+         << pool_list_.at(jdx).allocable_size_ / 1024 << std::endl;
+    std::cout << "  segment id:                             "
+         << pool_list_.at(jdx).segment_ << std::endl;
+    std::cout << "  is kernarg:                             "
+         << pool_list_.at(jdx).is_kernarg_ << std::endl;
+    std::cout << "  is fine-grained:                        "
+         << pool_list_.at(jdx).is_fine_grained_ << std::endl;
+    std::cout << "  accessible to owner:                    "
+         << pool_list_.at(jdx).owner_access_ << std::endl;
+    std::cout << "  accessible to all by default:           "
+         << pool_list_.at(jdx).access_to_all_ << std::endl;
+  }
+  std::cout << std::endl;
+
+}
+
+// @brief: Print the list of transactions that will be executed
+void RocmBandwidthTest::PrintTransList() {
+
+  size_t count = trans_list_.size();
+  for (uint32_t idx = 0; idx < count; idx++) {
+    async_trans_t trans = trans_list_.at(idx);
+    std::cout << std::endl;
+    std::cout << "                 Transaction Id: " << idx << std::endl;
+    std::cout << "               Transaction Type: " << trans.req_type_ << std::endl;
+    if ((trans.req_type_ == REQ_READ) || (trans.req_type_ == REQ_WRITE)) {
+      std::cout << "Rocm Kernel used by Transaction: " << trans.kernel.code_ << std::endl;
+      std::cout << "Rocm Buffer index Used by Kernel: " << trans.kernel.pool_idx_ << std::endl;
+      std::cout << "  Rocm Device used for Execution: " << trans.kernel.agent_idx_ << std::endl;
+    }
+    if ((trans.req_type_ == REQ_COPY_BIDIR) || (trans.req_type_ == REQ_COPY_UNIDIR)) {
+      std::cout << "   Src Buffer used in Copy: " << trans.copy.src_idx_ << std::endl;
+      std::cout << "   Dst Buffer used in Copy: " << trans.copy.dst_idx_ << std::endl;
+    }
+    if (trans.req_type_ == REQ_INTERFERENCE) {
+      std::cout << "   Src Memory Pool used in Copy: " << trans.copy.src_idx_ << std::endl;
+      std::cout << "   Dst Memory Pool used in Copy: " << trans.copy.dst_idx_ << std::endl;
+      std::cout << "   Interfering Copy Paths: " << (interference_trans_list_.size() - 1) << std::endl;
+    }
+    if (trans.req_type_ == REQ_HOST_LOAD) {
+      std::cout << "   Src Memory Pool used in Copy: " << trans.copy.src_idx_ << std::endl;
+      std::cout << "   Dst Memory Pool used in Copy: " << trans.copy.dst_idx_ << std::endl;
+      std::cout << "   Host Load Stream: " << HostLoadGenerator::GetOpName(host_load_op_) << std::endl;
+    }
+    if (trans.req_type_ == REQ_HOST_SOURCE) {
+      std::cout << "   Src Memory Pool used in Copy: " << trans.copy.src_idx_ << std::endl;
+      std::cout << "   Dst Memory Pool used in Copy: " << trans.copy.dst_idx_ << std::endl;
+      std::cout << "   Host Buffer used in Copy: "
+                << HostBufferProvider::GetSourceModeName(trans.copy.source_mode_) << std::endl;
+    }
+    if ((trans.req_type_ == REQ_COPY_ALL_BIDIR) || (trans.req_type_ == REQ_COPY_ALL_UNIDIR)) {
+      std::cout << "   Src Memory Pool used in Copy: " << trans.copy.src_idx_ << std::endl;
+      std::cout << "   Dst Memory Pool used in Copy: " << trans.copy.dst_idx_ << std::endl;
+      if (numa_sweep_) {
+        std::cout << "   Host Pages used in Copy: "
+                  << HostBufferProvider::GetPageKindName(trans.copy.page_kind_) << std::endl;
+      }
+    }
+    if (trans.req_type_ == REQ_STREAM) {
+      std::cout << "        STREAM Operation: " << HostCopyEngine::GetStreamOpName(trans.kernel.op_) << std::endl;
+      std::cout << "   Memory Pool of Arrays: " << trans.kernel.pool_idx_ << std::endl;
+      std::cout << "  Device used for Execution: " << trans.kernel.agent_idx_ << std::endl;
+    }
+    if (trans.req_type_ == REQ_COLLECTIVE) {
+      std::cout << "   Collective Operation: " << GetCollectiveName(trans.kernel.op_) << std::endl;
+      std::cout << "   Number of Gpu Devices: " << collective_pool_list_.size() << std::endl;
+    }
+    if (trans.req_type_ == REQ_BISECTION) {
+      std::cout << "   Devices on each Side:";
+      for (uint32_t side = 0; side < 2; side++) {
+        std::cout << ((side == 0) ? "" : " |");
+        for (uint32_t rank = 0; rank < bisection_pool_list_.size(); rank++) {
+          if (((trans.side_mask_ >> rank) & 1) == (1 - side)) {
+            std::cout << " " << pool_list_[bisection_pool_list_[rank]].agent_index_;
+          }
+        }
+      }
+      std::cout << std::endl;
+      std::cout << "   Copies across Bisection: " << trans.kernel.op_ << std::endl;
+    }
+    if (trans.req_type_ == REQ_LATENCY) {
+      std::cout << "  Stride of Pointer Chase: " << trans.kernel.op_ << std::endl;
+      std::cout << "   Memory Pool of Chain: " << trans.kernel.pool_idx_ << std::endl;
+      std::cout << "  Device used for Execution: " << trans.kernel.agent_idx_ << std::endl;
+    }
+
+  }
+  std::cout << std::endl;
+}
+
+// @brief: Prints error message when a request to copy between
+// source buffer and destination buffer is not possible
+void RocmBandwidthTest::PrintCopyAccessError(uint32_t src_idx, uint32_t dst_idx) {
+
+  // Retrieve Roc runtime handles for Src memory pool and devices
+  uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
+  hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+    
+  // Retrieve Roc runtime handles for Dst memory pool and devices
+  uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
+  hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+
+  std::cout << std::endl;
+  //std::cout << "Index of Src Memory: " << src_idx << std::endl;
+  //std::cout << "Index of Dst Memory: " << dst_idx << std::endl;
+  std::cout << "Src Device: Index "
+            << src_dev_idx
+            << ", Type: "
+            << ((src_dev_type == HSA_DEVICE_TYPE_CPU) ? "CPU" : "GPU") << std::endl;
+  std::cout << "Dst Device: Index "
+            << dst_dev_idx
+            << ", Type: "
+            << ((dst_dev_type == HSA_DEVICE_TYPE_CPU) ? "CPU" : "GPU") << std::endl;
+  std::cout << "Rocm Device hosting Src Memory cannot ACCESS Dst Memory" << std::endl;
+  std::cout << std::endl;
+}
+
+// @brief: Prints error message when a request to read / write from
+// a buffer of a device is not possible
+void RocmBandwidthTest::PrintIOAccessError(uint32_t exec_idx, uint32_t pool_idx) {
+
+  // Retrieve device type of executing device
+  hsa_device_type_t exec_dev_type = agent_list_[exec_idx].device_type_;
+    
+  // Retrieve device type of memory pool's device
+  uint32_t pool_dev_idx = pool_list_[pool_idx].agent_index_;
+  hsa_device_type_t pool_dev_type = agent_list_[pool_dev_idx].device_type_;
+
+  std::cout << std::endl;
+  std::cout << "Index of Executing Device: " << exec_idx << std::endl;
+  std::cout << "Device Type of Executing Device: " << exec_dev_type << std::endl;
+
+  std::cout << "Index of Buffer: " << pool_idx << std::endl;
+  std::cout << "Index of Buffer's Device: " << pool_dev_idx << std::endl;
+  std::cout << "Device Type Hosting Buffer: " << pool_dev_type << std::endl;
+  std::cout << "Rocm Device executing Read / Write request cannot ACCESS Buffer" << std::endl;
+  std::cout << std::endl;
+}
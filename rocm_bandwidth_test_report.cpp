@@ -1,385 +1,1429 @@
-////////////////////////////////////////////////////////////////////////////////
-//
-// The University of Illinois/NCSA
-// Open Source License (NCSA)
-// 
-// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
-// 
-// Developed by:
-// 
-//                 AMD Research and AMD HSA Software Development
-// 
-//                 Advanced Micro Devices, Inc.
-// 
-//                 www.amd.com
-// 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to
-// deal with the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-// 
-//  - Redistributions of source code must retain the above copyright notice,
-//    this list of conditions and the following disclaimers.
-//  - Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimers in
-//    the documentation and/or other materials provided with the distribution.
-//  - Neither the names of Advanced Micro Devices, Inc,
-//    nor the names of its contributors may be used to endorse or promote
-//    products derived from this Software without specific prior written
-//    permission.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-// DEALINGS WITH THE SOFTWARE.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-#include "common.hpp"
-#include "rocm_bandwidth_test.hpp"
-
-#include <iomanip>
-#include <sstream>
-#include <algorithm>
-
-static void printRecord(uint32_t size, double avg_time,
-                        double bandwidth, double min_time,
-                        double peak_bandwidth) {
-
-  std::stringstream size_str;
-  if (size < 1024 * 1024) {
-    size_str << size / 1024 << " KB";
-  } else {
-    size_str << size / (1024 * 1024) << " MB";
-  }
-
-  uint32_t format = 15;
-  std::cout.precision(6);
-  std::cout << std::fixed;
-  std::cout.width(format);
-  std::cout << size_str.str();
-  // avg time
-  std::cout.width(format);
-  std::cout << (avg_time * 1e6);
-  // BW in GB/sec
-  std::cout.width(format);
-  std::cout << bandwidth;
-  // minimum time
-  std::cout.width(format);
-  std::cout << (min_time * 1e6);
-  // maximum BW
-  std::cout.width(format);
-  std::cout << peak_bandwidth;
-  std::cout << std::endl;
-}
-
-static void printCopyBanner(uint32_t src_pool_id, uint32_t src_agent_type,
-                            uint32_t dst_pool_id, uint32_t dst_agent_type) {
-
-  std::stringstream src_type;
-  std::stringstream dst_type;
-  (src_agent_type == 0) ? src_type <<  "Cpu" : src_type << "Gpu";
-  (dst_agent_type == 0) ? dst_type <<  "Cpu" : dst_type << "Gpu";
-
-  std::cout << std::endl;
-  std::cout << "================";
-  std::cout << "           Benchmark Result";
-  std::cout << "         ================";
-  std::cout << std::endl;
-  std::cout << "================";
-  std::cout << " Src Device Id: " << src_pool_id;
-  std::cout << " Src Device Type: " << src_type.str();
-  std::cout << " ================";
-  std::cout << std::endl;
-  std::cout << "================";
-  std::cout << " Dst Device Id: " << dst_pool_id;
-  std::cout << " Dst Device Type: " << dst_type.str();
-  std::cout << " ================";
-  std::cout << std::endl;
-  std::cout << std::endl;
-
-  uint32_t format = 15;
-  std::cout.setf(ios::left);
-  std::cout.width(format);
-  std::cout << "Data Size";
-  std::cout.width(format);
-  std::cout << "Avg Time(us)";
-  std::cout.width(format);
-  std::cout << "Avg BW(GB/s)";
-  std::cout.width(format);
-  std::cout << "Min Time(us)";
-  std::cout.width(format);
-  std::cout << "Peak BW(GB/s)";
-  std::cout << std::endl;
-}
-
-double RocmBandwidthTest::GetMinTime(std::vector<double>& vec) {
-
-  std::sort(vec.begin(), vec.end());
-  return vec.at(0);
-}
-
-double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
-
-  std::sort(vec.begin(), vec.end());
-  vec.erase(vec.begin());
-  vec.erase(vec.begin(), vec.begin() + num_iteration_ * 0.1);
-  vec.erase(vec.begin() + num_iteration_, vec.end());
-
-  double mean = 0.0;
-  int num = vec.size();
-  for (int it = 0; it < num; it++) {
-    mean += vec[it];
-  }
-  mean /= num;
-  return mean;
-}
-
-void RocmBandwidthTest::Display() const {
-
-  // Iterate through list of transactions and display its timing data
-  uint32_t trans_size = trans_list_.size();
-  if (trans_size == 0) {
-    std::cout << std::endl;
-    std::cout << "  Invalid Request" << std::endl;
-    std::cout << std::endl;
-    return;
-  }
-  
-  if (validate_) {
-    PrintVersion();
-    DisplayDevInfo();
-    PrintAccessMatrix();
-    DisplayValidationMatrix();
-    return;
-  }
-
-  if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
-    PrintVersion();
-    DisplayDevInfo();
-    PrintAccessMatrix();
-    PrintLinkMatrix();
-    DisplayCopyTimeMatrix(true);
-    return;
-  }
-
-  if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
-    if (bw_default_run_ == NULL) {
-      PrintVersion();
-      DisplayDevInfo();
-      PrintAccessMatrix();
-      PrintLinkMatrix();
-    }
-    DisplayCopyTimeMatrix(true);
-    return;
-  }
-
-  for (uint32_t idx = 0; idx < trans_size; idx++) {
-    async_trans_t trans = trans_list_[idx];
-    if ((trans.req_type_ == REQ_COPY_BIDIR) ||
-        (trans.req_type_ == REQ_COPY_UNIDIR)) {
-      DisplayCopyTime(trans);
-    }
-    if ((trans.req_type_ == REQ_READ) ||
-        (trans.req_type_ == REQ_WRITE)) {
-      DisplayIOTime(trans);
-    }
-  }
-  std::cout << std::endl;
-}
-
-void RocmBandwidthTest::DisplayIOTime(async_trans_t& trans) const {
-
-}
-
-void RocmBandwidthTest::DisplayCopyTime(async_trans_t& trans) const {
-
-  // Print Benchmark Header
-  uint32_t src_idx = trans.copy.src_idx_;
-  uint32_t dst_idx = trans.copy.dst_idx_;
-  uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-  hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
-  uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-  hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
-  printCopyBanner(src_idx, src_dev_type, dst_idx, dst_dev_type);
-
-  uint32_t size_len = size_list_.size();
-  for (uint32_t idx = 0; idx < size_len; idx++) {
-    printRecord(size_list_[idx], trans.avg_time_[idx],
-                trans.avg_bandwidth_[idx], trans.min_time_[idx],
-                trans.peak_bandwidth_[idx]);
-  }
-}
-
-void RocmBandwidthTest::DisplayCopyTimeMatrix(bool peak) const {
-
-  double* perf_matrix = new double[agent_index_ * agent_index_]();
-  uint32_t trans_size = trans_list_.size();
-  for (uint32_t idx = 0; idx < trans_size; idx++) {
-    async_trans_t trans = trans_list_[idx];
-    uint32_t src_idx = trans.copy.src_idx_;
-    uint32_t dst_idx = trans.copy.dst_idx_;
-    uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-    uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-    if (peak) {
-      perf_matrix[(src_dev_idx * agent_index_) + dst_dev_idx] = trans.peak_bandwidth_[0];
-    } else {
-      perf_matrix[(src_dev_idx * agent_index_) + dst_dev_idx] = trans.avg_bandwidth_[0];
-    }
-  }
-
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  
-  if ((peak) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
-    std::cout << "Unidirectional peak bandwidth GB/s";
-  }
-  
-  if ((peak == false) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
-    std::cout << "Unidirectional average bandwidth GB/s";
-  }
-  
-  if ((peak) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
-    std::cout << "Bdirectional peak bandwidth GB/s";
-  }
-  
-  if ((peak == false) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
-    std::cout << "Bidirectional average bandwidth GB/s";
-  }
-
-  std::cout << std::endl;
-  std::cout << std::endl;
-  std::cout.precision(6);
-  std::cout << std::fixed;
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  std::cout << "D/D";
-  format = 12;
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    std::cout.width(format);
-    std::stringstream agent_id;
-    agent_id << idx0;
-    std::cout << agent_id.str();
-  }
-  std::cout << std::endl;
-  std::cout << std::endl;
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    format = 10;
-    std::cout.width(format);
-    std::cout << "";
-    std::stringstream agent_id;
-    agent_id << idx0;
-    std::cout.width(format);
-    std::cout << agent_id.str();
-    for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
-      format = 12;
-      std::cout.width(format);
-      double value = perf_matrix[(idx0 * agent_index_) + idx1];
-      if (value == 0) {
-        std::cout << "N/A";
-      } else {
-        std::cout << perf_matrix[(idx0 * agent_index_) + idx1];
-      }
-    }
-    std::cout << std::endl;
-    std::cout << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-void RocmBandwidthTest::DisplayValidationMatrix() const {
-
-  double* perf_matrix = new double[agent_index_ * agent_index_]();
-  uint32_t trans_size = trans_list_.size();
-  for (uint32_t idx = 0; idx < trans_size; idx++) {
-    async_trans_t trans = trans_list_[idx];
-    uint32_t src_idx = trans.copy.src_idx_;
-    uint32_t dst_idx = trans.copy.dst_idx_;
-    uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-    uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-    perf_matrix[(src_dev_idx * agent_index_) + dst_dev_idx] = trans.peak_bandwidth_[0];
-  }
-
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  
-  std::cout << "Data Path Validation";
-
-  std::cout << std::endl;
-  std::cout << std::endl;
-  std::cout.precision(6);
-  std::cout << std::fixed;
-
-  std::cout.width(format);
-  std::cout << "";
-  std::cout.width(format);
-  std::cout << "D/D";
-  format = 12;
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    std::cout.width(format);
-    std::stringstream agent_id;
-    agent_id << idx0;
-    std::cout << agent_id.str();
-  }
-  std::cout << std::endl;
-  std::cout << std::endl;
-  for (uint32_t idx0 = 0; idx0 < agent_index_; idx0++) {
-    format = 10;
-    std::cout.width(format);
-    std::cout << "";
-    std::stringstream agent_id;
-    agent_id << idx0;
-    std::cout.width(format);
-    std::cout << agent_id.str();
-    for (uint32_t idx1 = 0; idx1 < agent_index_; idx1++) {
-      format = 12;
-      std::cout.width(format);
-      double value = perf_matrix[(idx0 * agent_index_) + idx1];
-      if (value == 0) {
-        std::cout << "N/A";
-      } else if (value < 1) {
-        std::cout << "FAIL";
-      } else {
-        std::cout << "PASS";
-      }
-    }
-    std::cout << std::endl;
-    std::cout << std::endl;
-  }
-  std::cout << std::endl;
-}
-
-void RocmBandwidthTest::DisplayDevInfo() const {
-
-  uint32_t format = 10;
-  std::cout.setf(ios::left);
-
-  std::cout << std::endl;
-  for (uint32_t idx = 0; idx < agent_index_; idx++) {
-    uint32_t active = active_agents_list_[idx];
-    if (active == 1) {
-      std::cout.width(format);
-      std::cout << "";
-      std::cout << "Device: " << idx;
-      std::cout << ",  " << agent_list_[idx].name_ << std::endl;
-    }
-  }
-  std::cout << std::endl;
-}
-
-
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+static std::string getSizeStr(uint32_t size) {
+
+  std::stringstream size_str;
+  if (size < 1024 * 1024) {
+    size_str << size / 1024 << " KB";
+  } else {
+    size_str << size / (1024 * 1024) << " MB";
+  }
+  return size_str.str();
+}
+
+// @brief: Name of a request type as printed in runtime estimates
+static const char* GetReqName(uint32_t req_type) {
+
+  switch (req_type) {
+    case REQ_READ:
+      return "Read";
+    case REQ_WRITE:
+      return "Write";
+    case REQ_STREAM:
+      return "STREAM";
+    case REQ_LATENCY:
+      return "Latency";
+    case REQ_COLLECTIVE:
+      return "Collective";
+    case REQ_BISECTION:
+      return "Bisection";
+    case REQ_INTERFERENCE:
+      return "Interference";
+    case REQ_HOST_LOAD:
+      return "Host load";
+    default:
+      return "Copy";
+  }
+}
+
+static void printRecord(uint32_t size, double avg_time,
+                        double bandwidth, double min_time,
+                        double peak_bandwidth) {
+
+  uint32_t format = 15;
+  std::cout.precision(6);
+  std::cout << std::fixed;
+  std::cout.width(format);
+  std::cout << getSizeStr(size);
+  // avg time
+  std::cout.width(format);
+  std::cout << (avg_time * 1e6);
+  // BW in GB/sec
+  std::cout.width(format);
+  std::cout << bandwidth;
+  // minimum time
+  std::cout.width(format);
+  std::cout << (min_time * 1e6);
+  // maximum BW
+  std::cout.width(format);
+  std::cout << peak_bandwidth;
+  std::cout << std::endl;
+}
+
+static void printRecordHeader() {
+
+  uint32_t format = 15;
+  std::cout.setf(ios::left);
+  std::cout.width(format);
+  std::cout << "Data Size";
+  std::cout.width(format);
+  std::cout << "Avg Time(us)";
+  std::cout.width(format);
+  std::cout << "Avg BW(GB/s)";
+  std::cout.width(format);
+  std::cout << "Min Time(us)";
+  std::cout.width(format);
+  std::cout << "Peak BW(GB/s)";
+  std::cout << std::endl;
+}
+
+static void printCopyBanner(uint32_t src_pool_id, uint32_t src_agent_type,
+                            uint32_t dst_pool_id, uint32_t dst_agent_type,
+                            const std::string& link_path) {
+
+  std::stringstream src_type;
+  std::stringstream dst_type;
+  (src_agent_type == 0) ? src_type <<  "Cpu" : src_type << "Gpu";
+  (dst_agent_type == 0) ? dst_type <<  "Cpu" : dst_type << "Gpu";
+
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << "           Benchmark Result";
+  std::cout << "         ================";
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << " Src Device Id: " << src_pool_id;
+  std::cout << " Src Device Type: " << src_type.str();
+  std::cout << " ================";
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << " Dst Device Id: " << dst_pool_id;
+  std::cout << " Dst Device Type: " << dst_type.str();
+  std::cout << " ================";
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << " Link Path: " << link_path;
+  std::cout << " ================";
+  std::cout << std::endl;
+  std::cout << std::endl;
+  printRecordHeader();
+}
+
+static void printIOBanner(uint32_t req_type, uint32_t pool_id,
+                          uint32_t dev_id, uint32_t exec_dev_id) {
+
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << "           Benchmark Result";
+  std::cout << "         ================";
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << ((req_type == REQ_READ) ? " Read" : " Write");
+  std::cout << " of Pool Id: " << pool_id;
+  std::cout << " of Device Id: " << dev_id;
+  std::cout << " ================";
+  std::cout << std::endl;
+  std::cout << "================";
+  std::cout << " Exec Device Id: " << exec_dev_id;
+  std::cout << " Exec Device Type: Cpu";
+  std::cout << " ================";
+  std::cout << std::endl;
+  std::cout << std::endl;
+  printRecordHeader();
+}
+
+double RocmBandwidthTest::GetMinTime(std::vector<double>& vec) {
+
+  std::sort(vec.begin(), vec.end());
+  return vec.at(0);
+}
+
+double RocmBandwidthTest::GetMeanTime(std::vector<double>& vec) {
+
+  std::sort(vec.begin(), vec.end());
+  vec.erase(vec.begin());
+  vec.erase(vec.begin(), vec.begin() + num_iteration_ * 0.1);
+  vec.erase(vec.begin() + num_iteration_, vec.end());
+
+  double mean = 0.0;
+  int num = vec.size();
+  for (int it = 0; it < num; it++) {
+    mean += vec[it];
+  }
+  mean /= num;
+  return mean;
+}
+
+void RocmBandwidthTest::Display() const {
+
+  // Iterate through list of transactions and display its timing data
+  uint32_t trans_size = trans_list_.size();
+  if (trans_size == 0) {
+    std::cout << std::endl;
+    std::cout << "  Invalid Request" << std::endl;
+    std::cout << std::endl;
+    return;
+  }
+  
+  if (validate_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintAccessMatrix();
+    DisplayValidationMatrix();
+    return;
+  }
+
+  if (numa_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    for (uint32_t idx = 0; idx < page_kind_list_.size(); idx++) {
+      DisplayNumaMatrix(true, page_kind_list_[idx]);
+      DisplayNumaMatrix(false, page_kind_list_[idx]);
+    }
+    return;
+  }
+
+  if ((kernel_sweep_) || (stream_sweep_)) {
+    PrintVersion();
+    DisplayDevInfo();
+    DisplayPoolKernelMatrix();
+    return;
+  }
+
+  if (latency_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintLinkMatrix();
+    uint32_t stride_len = sizeof(LATENCY_STRIDE_LIST) / sizeof(uint32_t);
+    for (uint32_t idx = 0; idx < stride_len; idx++) {
+      DisplayLatencyMatrix(LATENCY_STRIDE_LIST[idx]);
+    }
+    return;
+  }
+
+  if (source_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    DisplayHostSourceMatrix();
+    return;
+  }
+
+  if (collective_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintLinkMatrix();
+    DisplayCollectiveMatrix();
+    return;
+  }
+
+  if (bisection_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintLinkMatrix();
+    DisplayBisectionMatrix();
+    return;
+  }
+
+  if (interference_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintLinkMatrix();
+    DisplayInterferenceMatrix();
+    return;
+  }
+
+  if (host_load_sweep_) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintLinkMatrix();
+    DisplayHostLoadMatrix();
+    return;
+  }
+
+  if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
+    PrintVersion();
+    DisplayDevInfo();
+    PrintAccessMatrix();
+    PrintLinkMatrix();
+    PrintLinkDescriptors();
+    DisplayCopyTimeMatrices(true);
+    return;
+  }
+
+  if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
+    if (bw_default_run_ == NULL) {
+      PrintVersion();
+      DisplayDevInfo();
+      PrintAccessMatrix();
+      PrintLinkMatrix();
+      PrintLinkDescriptors();
+    }
+    DisplayCopyTimeMatrices(true);
+    return;
+  }
+
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t trans = trans_list_[idx];
+    if ((trans.req_type_ == REQ_COPY_BIDIR) ||
+        (trans.req_type_ == REQ_COPY_UNIDIR)) {
+      DisplayCopyTime(trans);
+    }
+    if ((trans.req_type_ == REQ_READ) ||
+        (trans.req_type_ == REQ_WRITE)) {
+      DisplayIOTime(trans);
+    }
+  }
+  std::cout << std::endl;
+}
+
+void RocmBandwidthTest::DisplayIOTime(async_trans_t& trans) const {
+
+  // Print Benchmark Header
+  uint32_t pool_idx = trans.kernel.pool_idx_;
+  printIOBanner(trans.req_type_, pool_idx,
+                pool_list_[pool_idx].agent_index_, trans.kernel.agent_idx_);
+
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+    printRecord(size_list_[idx], trans.avg_time_[idx],
+                trans.avg_bandwidth_[idx], trans.min_time_[idx],
+                trans.peak_bandwidth_[idx]);
+  }
+}
+
+void RocmBandwidthTest::DisplayCopyTime(async_trans_t& trans) const {
+
+  // Print Benchmark Header
+  uint32_t src_idx = trans.copy.src_idx_;
+  uint32_t dst_idx = trans.copy.dst_idx_;
+  uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
+  hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+  uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
+  hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+  printCopyBanner(src_idx, src_dev_type, dst_idx, dst_dev_type,
+                  GetLinkPathStr(src_dev_idx, dst_dev_idx));
+
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+    printRecord(size_list_[idx], trans.avg_time_[idx],
+                trans.avg_bandwidth_[idx], trans.min_time_[idx],
+                trans.peak_bandwidth_[idx]);
+  }
+}
+
+// @brief: Display peak bandwidth of every host copy kernel or STREAM
+// operation, one table per memory pool with a row per buffer size.
+// Bandwidth counts every read and write of memory of the pool
+void RocmBandwidthTest::DisplayPoolKernelMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t trans_size = trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t pool_idx = 0; pool_idx < pool_index_; pool_idx++) {
+
+    vector<const async_trans_t*> kernel_list;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      uint32_t trans_pool_idx = (trans.req_type_ == REQ_STREAM) ?
+                                trans.kernel.pool_idx_ : trans.copy.src_idx_;
+      if (trans_pool_idx == pool_idx) {
+        kernel_list.push_back(&trans_list_[idx]);
+      }
+    }
+    if (kernel_list.empty()) {
+      continue;
+    }
+
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << ((stream_sweep_) ? "STREAM" : "Host copy kernel")
+              << " peak bandwidth GB/s, Pool: " << pool_idx
+              << " of Device: " << pool_list_[pool_idx].agent_index_ << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Size";
+    for (uint32_t idx = 0; idx < kernel_list.size(); idx++) {
+      std::cout.width(12);
+      if (kernel_list[idx]->req_type_ == REQ_STREAM) {
+        std::cout << HostCopyEngine::GetStreamOpName(kernel_list[idx]->kernel.op_);
+      } else {
+        std::cout << HostCopyEngine::GetKernelName(kernel_list[idx]->copy.kernel_idx_);
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.precision(6);
+    std::cout << std::fixed;
+    for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << getSizeStr(size_list_[size_idx]);
+      for (uint32_t idx = 0; idx < kernel_list.size(); idx++) {
+        std::cout.width(12);
+        if (kernel_list[idx]->data_valid_ == false) {
+          std::cout << "N/A";
+        } else {
+          std::cout << kernel_list[idx]->peak_bandwidth_[size_idx];
+        }
+      }
+      std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// @brief: Display latency of loads in nanoseconds for a stride
+// of pointer chase, with a row per memory pool and a column per
+// Cpu device. Latency is the best of iterations of the walk
+void RocmBandwidthTest::DisplayLatencyMatrix(uint32_t stride) const {
+
+  uint32_t format = 10;
+  vector<uint32_t> host_list;
+  for (uint32_t idx = 0; idx < agent_index_; idx++) {
+    if (agent_list_[idx].device_type_ == HSA_DEVICE_TYPE_CPU) {
+      host_list.push_back(idx);
+    }
+  }
+
+  std::cout.setf(ios::left);
+  std::cout.width(format);
+  std::cout << "";
+  std::cout << "Pointer chase latency ns per access, Stride: "
+            << stride << " Bytes" << std::endl;
+  std::cout << std::endl;
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "Pool/D";
+  for (uint32_t idx = 0; idx < host_list.size(); idx++) {
+    std::cout.width(format);
+    std::cout << host_list[idx];
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  std::cout.precision(1);
+  std::cout << std::fixed;
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t pool_idx = 0; pool_idx < pool_index_; pool_idx++) {
+
+    vector<double> latency_list(host_list.size(), 0);
+    bool pool_used = false;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      if ((trans.req_type_ != REQ_LATENCY) ||
+          (trans.kernel.pool_idx_ != pool_idx) ||
+          (trans.kernel.op_ != stride) || (trans.min_time_.empty())) {
+        continue;
+      }
+      uint32_t col = std::find(host_list.begin(), host_list.end(),
+                               trans.kernel.agent_idx_) - host_list.begin();
+      latency_list[col] = trans.min_time_[0] * 1e9;
+      pool_used = true;
+    }
+    if (pool_used == false) {
+      continue;
+    }
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << pool_idx;
+    for (uint32_t idx = 0; idx < host_list.size(); idx++) {
+      std::cout.width(format);
+      if (latency_list[idx] == 0) {
+        std::cout << "N/A";
+      } else {
+        std::cout << latency_list[idx];
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+// @brief: Display peak bandwidth of copies to every Gpu from each
+// mode of sourcing host buffers side by side, one table per Gpu with
+// a row per buffer size. Last column gives the mean time spent to
+// lock and unlock buffers of malloc, which is part of Locked copies
+void RocmBandwidthTest::DisplayHostSourceMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t trans_size = trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t pool_idx = 0; pool_idx < pool_index_; pool_idx++) {
+
+    const async_trans_t* mode_list[HOST_SOURCE_MODE_COUNT] = { NULL };
+    const async_trans_t* first = NULL;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      if ((trans.req_type_ == REQ_HOST_SOURCE) && (trans.copy.dst_idx_ == pool_idx)) {
+        mode_list[trans.copy.source_mode_] = &trans_list_[idx];
+        first = &trans_list_[idx];
+      }
+    }
+    if (first == NULL) {
+      continue;
+    }
+
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Host to Device peak bandwidth GB/s, Pool: " << pool_idx
+              << " of Device: " << pool_list_[pool_idx].agent_index_
+              << " from Pool: " << first->copy.src_idx_
+              << " of Device: " << pool_list_[first->copy.src_idx_].agent_index_
+              << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Size";
+    for (uint32_t mode = 0; mode < HOST_SOURCE_MODE_COUNT; mode++) {
+      std::cout.width(12);
+      std::cout << HostBufferProvider::GetSourceModeName(mode);
+    }
+    std::cout.width(12);
+    std::cout << "Lock us";
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::fixed;
+    for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << getSizeStr(size_list_[size_idx]);
+      std::cout.precision(6);
+      for (uint32_t mode = 0; mode < HOST_SOURCE_MODE_COUNT; mode++) {
+        std::cout.width(12);
+        if ((mode_list[mode] == NULL) || (mode_list[mode]->peak_bandwidth_.empty())) {
+          std::cout << "N/A";
+        } else {
+          std::cout << mode_list[mode]->peak_bandwidth_[size_idx];
+        }
+      }
+      std::cout.width(12);
+      std::cout.precision(1);
+      const async_trans_t* locked = mode_list[HOST_SOURCE_LOCKED];
+      if ((locked == NULL) || (locked->setup_time_.empty())) {
+        std::cout << "N/A";
+      } else {
+        std::cout << (locked->setup_time_[size_idx] * 1e6);
+      }
+      std::cout << std::endl;
+    }
+    std::cout.precision(6);
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// @brief: Display collectives in the manner of NCCL tests, one table
+// per collective with a row per buffer size. Algorithm bandwidth is
+// buffer size of a device over mean time, bus bandwidth scales it by
+// the share of data a device sends or receives over its links
+void RocmBandwidthTest::DisplayCollectiveMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t num_ranks = collective_pool_list_.size();
+  uint32_t trans_size = trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    const async_trans_t& trans = trans_list_[idx];
+    if ((trans.req_type_ != REQ_COLLECTIVE) || (trans.avg_time_.empty())) {
+      continue;
+    }
+
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << GetCollectiveName(trans.kernel.op_) << " across Devices:";
+    for (uint32_t rank = 0; rank < num_ranks; rank++) {
+      std::cout << " " << pool_list_[collective_pool_list_[rank]].agent_index_;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Size";
+    std::cout.width(12);
+    std::cout << "Time us";
+    std::cout.width(12);
+    std::cout << "AlgBW GB/s";
+    std::cout.width(12);
+    std::cout << "BusBW GB/s";
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::fixed;
+    double bus_factor = GetCollectiveBusFactor(trans.kernel.op_, num_ranks);
+    for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << getSizeStr(size_list_[size_idx]);
+      std::cout.precision(1);
+      std::cout.width(12);
+      std::cout << (trans.avg_time_[size_idx] * 1e6);
+      std::cout.precision(6);
+      std::cout.width(12);
+      std::cout << trans.avg_bandwidth_[size_idx];
+      std::cout.width(12);
+      std::cout << (trans.avg_bandwidth_[size_idx] * bus_factor);
+      std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// @brief: Display bisection bandwidth, one table per buffer size with
+// a row per bipartition of Gpu devices. Bisection bandwidth of system
+// is the minimum over bipartitions, reported along with their average
+// and the number of bipartitions measured out of all balanced ones
+void RocmBandwidthTest::DisplayBisectionMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t num_ranks = bisection_pool_list_.size();
+  uint32_t trans_size = trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Bisection Bandwidth GB/s for Size: "
+              << getSizeStr(size_list_[size_idx]) << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(20);
+    std::cout << "Side A";
+    std::cout.width(20);
+    std::cout << "Side B";
+    std::cout.width(format);
+    std::cout << "Copies";
+    std::cout.width(12);
+    std::cout << "Peak";
+    std::cout.width(12);
+    std::cout << "Mean";
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    uint32_t num_splits = 0;
+    double min_peak = 0;
+    double min_avg = 0;
+    double sum_peak = 0;
+    double sum_avg = 0;
+    std::cout << std::fixed;
+    std::cout.precision(6);
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      if ((trans.req_type_ != REQ_BISECTION) || (trans.avg_time_.empty())) {
+        continue;
+      }
+
+      std::cout.width(format);
+      std::cout << "";
+      for (uint32_t side = 0; side < 2; side++) {
+        std::stringstream devices;
+        for (uint32_t rank = 0; rank < num_ranks; rank++) {
+          if (((trans.side_mask_ >> rank) & 1) == (1 - side)) {
+            devices << pool_list_[bisection_pool_list_[rank]].agent_index_ << " ";
+          }
+        }
+        std::cout.width(20);
+        std::cout << devices.str();
+      }
+      std::cout.width(format);
+      std::cout << trans.kernel.op_;
+      std::cout.width(12);
+      std::cout << trans.peak_bandwidth_[size_idx];
+      std::cout.width(12);
+      std::cout << trans.avg_bandwidth_[size_idx];
+      std::cout << std::endl;
+
+      if ((num_splits == 0) || (trans.peak_bandwidth_[size_idx] < min_peak)) {
+        min_peak = trans.peak_bandwidth_[size_idx];
+      }
+      if ((num_splits == 0) || (trans.avg_bandwidth_[size_idx] < min_avg)) {
+        min_avg = trans.avg_bandwidth_[size_idx];
+      }
+      sum_peak += trans.peak_bandwidth_[size_idx];
+      sum_avg += trans.avg_bandwidth_[size_idx];
+      num_splits++;
+    }
+    if (num_splits == 0) {
+      std::cout << std::endl;
+      continue;
+    }
+
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(50);
+    std::cout << "Minimum";
+    std::cout.width(12);
+    std::cout << min_peak;
+    std::cout.width(12);
+    std::cout << min_avg;
+    std::cout << std::endl;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(50);
+    std::cout << "Average";
+    std::cout.width(12);
+    std::cout << (sum_peak / num_splits);
+    std::cout.width(12);
+    std::cout << (sum_avg / num_splits);
+    std::cout << std::endl;
+
+    // Splits are a random sample if there are too many to measure,
+    // whose seed lets the same sample be measured again
+    if (bisection_split_count_ != 0) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout << "Splits measured: " << num_splits << " of " << bisection_split_count_;
+      if (bisection_sampled_) {
+        std::cout << ", drawn at random with ROCM_BW_BISECTION_SEED=" << bisection_seed_;
+      }
+      std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// @brief: Display interference among copy paths, one matrix per buffer
+// size. Row is the path timed, column the path run alongside it, and
+// entry the slowdown of the timed path: its bandwidth alone over its
+// bandwidth alongside. Paths sharing no link may still slow each
+// other through a common switch or root complex
+void RocmBandwidthTest::DisplayInterferenceMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t num_paths = interference_trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  vector<std::string> name_list(num_paths);
+  for (uint32_t path = 0; path < num_paths; path++) {
+    const async_trans_t& trans = trans_list_[interference_trans_list_[path]];
+    std::stringstream name;
+    name << pool_list_[trans.copy.src_idx_].agent_index_ << "->"
+         << pool_list_[trans.copy.dst_idx_].agent_index_;
+    name_list[path] = name.str();
+  }
+
+  for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+
+    std::cout.setf(ios::left);
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Slowdown of Copy Path in Row alongside Copy Path in Column for Size: "
+              << getSizeStr(size_list_[size_idx]) << std::endl;
+    std::cout << std::endl;
+
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << "Path";
+    std::cout.width(12);
+    std::cout << "Alone GB/s";
+    for (uint32_t path = 0; path < num_paths; path++) {
+      std::cout.width(format);
+      std::cout << name_list[path];
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::fixed;
+    for (uint32_t row = 0; row < num_paths; row++) {
+      const async_trans_t& trans = trans_list_[interference_trans_list_[row]];
+      if (trans.shared_bandwidth_.empty()) {
+        continue;
+      }
+      const double* bandwidth = &trans.shared_bandwidth_[size_idx * num_paths];
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << name_list[row];
+      std::cout.precision(6);
+      std::cout.width(12);
+      std::cout << bandwidth[row];
+      std::cout.precision(2);
+      for (uint32_t col = 0; col < num_paths; col++) {
+        std::cout.width(format);
+        if (col == row) {
+          std::cout << "N/A";
+        } else {
+          std::cout << (bandwidth[row] / bandwidth[col]);
+        }
+      }
+      std::cout << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// @brief: Display copies between Cpu and Gpu devices under load of
+// host memory, one table per NUMA node and buffer size with a row per
+// level of load. Row lists the rate load generator achieved, the
+// bandwidth of every copy path of node and their mean share of the
+// bandwidth they had with no load, which traces their degradation
+void RocmBandwidthTest::DisplayHostLoadMatrix() const {
+
+  uint32_t format = 10;
+  uint32_t num_levels = load_level_list_.size();
+  uint32_t size_len = size_list_.size();
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t host_idx = 0; host_idx < agent_index_; host_idx++) {
+
+    vector<uint32_t> path_list;
+    for (uint32_t idx = 0; idx < trans_size; idx++) {
+      const async_trans_t& trans = trans_list_[idx];
+      if ((trans.req_type_ == REQ_HOST_LOAD) && (trans.avg_time_.empty() == false) &&
+          (GetTransHostIdx(trans) == host_idx)) {
+        path_list.push_back(idx);
+      }
+    }
+    if (path_list.empty()) {
+      continue;
+    }
+    uint32_t num_paths = path_list.size();
+
+    for (uint32_t size_idx = 0; size_idx < size_len; size_idx++) {
+
+      std::cout.setf(ios::left);
+      std::cout.width(format);
+      std::cout << "";
+      std::cout << "Copy Bandwidth GB/s under " << HostLoadGenerator::GetOpName(host_load_op_)
+                << " Load of NUMA Node: " << agent_list_[host_idx].numa_node_
+                << ", Size: " << getSizeStr(size_list_[size_idx]) << std::endl;
+      std::cout << std::endl;
+
+      std::cout.width(format);
+      std::cout << "";
+      std::cout.width(format);
+      std::cout << "Load %";
+      std::cout.width(12);
+      std::cout << "Host GB/s";
+      for (uint32_t path = 0; path < num_paths; path++) {
+        const async_trans_t& trans = trans_list_[path_list[path]];
+        std::stringstream name;
+        name << pool_list_[trans.copy.src_idx_].agent_index_ << "->"
+             << pool_list_[trans.copy.dst_idx_].agent_index_;
+        std::cout.width(format);
+        std::cout << name.str();
+      }
+      std::cout.width(format);
+      std::cout << "Mean %";
+      std::cout << std::endl;
+      std::cout << std::endl;
+
+      std::cout << std::fixed;
+      for (uint32_t level_idx = 0; level_idx < num_levels; level_idx++) {
+        double load_rate = 0;
+        double share = 0;
+        for (uint32_t path = 0; path < num_paths; path++) {
+          const async_trans_t& trans = trans_list_[path_list[path]];
+          const double* bandwidth = &trans.shared_bandwidth_[size_idx * num_levels];
+          load_rate += trans.load_rate_[(size_idx * num_levels) + level_idx];
+          share += bandwidth[level_idx] / bandwidth[0];
+        }
+
+        std::cout.width(format);
+        std::cout << "";
+        std::cout.width(format);
+        std::cout << load_level_list_[level_idx];
+        std::cout.precision(6);
+        std::cout.width(12);
+        std::cout << (load_rate / num_paths);
+        std::cout.precision(2);
+        for (uint32_t path = 0; path < num_paths; path++) {
+          const async_trans_t& trans = trans_list_[path_list[path]];
+          std::cout.width(format);
+          std::cout << trans.shared_bandwidth_[(size_idx * num_levels) + level_idx];
+        }
+        std::cout.precision(1);
+        std::cout.width(format);
+        std::cout << (share * 100 / num_paths);
+        std::cout << std::endl;
+      }
+      std::cout << std::endl;
+      std::cout << std::endl;
+    }
+  }
+}
+
+uint32_t RocmBandwidthTest::GetMatrixDim() const {
+  return (pool_matrix_) ? pool_index_ : agent_index_;
+}
+
+uint32_t RocmBandwidthTest::GetMatrixIdx(uint32_t pool_idx) const {
+  return (pool_matrix_) ? pool_idx : pool_list_[pool_idx].agent_index_;
+}
+
+// @brief: Print attributes of memory pools that index the
+// rows and columns of a pool granular matrix
+void RocmBandwidthTest::PrintPoolLegend() const {
+
+  if (pool_matrix_ == false) {
+    return;
+  }
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+  for (uint32_t idx = 0; idx < pool_index_; idx++) {
+    const pool_info_t& pool = pool_list_[idx];
+    hsa_device_type_t dev_type = agent_list_[pool.agent_index_].device_type_;
+    std::cout.width(format);
+    std::cout << "";
+    std::cout << "Pool: " << idx;
+    std::cout << ",  Device: " << pool.agent_index_;
+    std::cout << ((dev_type == HSA_DEVICE_TYPE_CPU) ? " (CPU)" : " (GPU)");
+    std::cout << ((pool.is_fine_grained_) ? ",  Fine-grained" : ",  Coarse-grained");
+    std::cout << ((pool.is_kernarg_) ? ",  Kernarg" : "");
+    std::cout << ",  Size: " << (pool.allocable_size_ / (1024 * 1024)) << " MB";
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+// @brief: Print the column headings of a result matrix. Pool
+// columns carry their device index and granularity e.g. 3:1C
+void RocmBandwidthTest::PrintMatrixHeader() const {
+
+  uint32_t format = 10;
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << ((pool_matrix_) ? "P/P" : "D/D");
+  format = 12;
+  uint32_t dim = GetMatrixDim();
+  for (uint32_t idx0 = 0; idx0 < dim; idx0++) {
+    std::cout.width(format);
+    std::stringstream col_id;
+    col_id << idx0;
+    if (pool_matrix_) {
+      col_id << ":" << pool_list_[idx0].agent_index_;
+      col_id << ((pool_list_[idx0].is_fine_grained_) ? "F" : "C");
+    }
+    std::cout << col_id.str();
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+}
+
+void RocmBandwidthTest::PrintMatrixRowId(uint32_t idx) const {
+
+  uint32_t format = 10;
+  std::cout.width(format);
+  std::cout << "";
+  std::stringstream row_id;
+  row_id << idx;
+  if (pool_matrix_) {
+    row_id << ":" << pool_list_[idx].agent_index_;
+    row_id << ((pool_list_[idx].is_fine_grained_) ? "F" : "C");
+  }
+  std::cout.width(format);
+  std::cout << row_id.str();
+}
+
+// @brief: Display one bandwidth matrix per buffer size and, when
+// sizes are swept, the bandwidth versus size curve of every pair
+void RocmBandwidthTest::DisplayCopyTimeMatrices(bool peak) const {
+
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+    DisplayCopyTimeMatrix(peak, idx);
+    if (report_efficiency_) {
+      DisplayEfficiencyMatrix(peak, idx);
+    }
+  }
+
+  if (sweep_sizes_ == false) {
+    return;
+  }
+
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t trans = trans_list_[idx];
+    DisplayCopyTime(trans);
+  }
+  std::cout << std::endl;
+}
+
+void RocmBandwidthTest::DisplayCopyTimeMatrix(bool peak, uint32_t size_idx) const {
+
+  uint32_t dim = GetMatrixDim();
+  double* perf_matrix = new double[dim * dim]();
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t trans = trans_list_[idx];
+    uint32_t src_idx = GetMatrixIdx(trans.copy.src_idx_);
+    uint32_t dst_idx = GetMatrixIdx(trans.copy.dst_idx_);
+    if (peak) {
+      perf_matrix[(src_idx * dim) + dst_idx] = trans.peak_bandwidth_[size_idx];
+    } else {
+      perf_matrix[(src_idx * dim) + dst_idx] = trans.avg_bandwidth_[size_idx];
+    }
+  }
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  
+  if ((peak) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
+    std::cout << "Unidirectional peak bandwidth GB/s";
+  }
+  
+  if ((peak == false) && (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR)) {
+    std::cout << "Unidirectional average bandwidth GB/s";
+  }
+  
+  if ((peak) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
+    std::cout << "Bdirectional peak bandwidth GB/s";
+  }
+  
+  if ((peak == false) && (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR)) {
+    std::cout << "Bidirectional average bandwidth GB/s";
+  }
+
+  // Qualify the matrix with its buffer size when there are several
+  if (size_list_.size() > 1) {
+    std::cout << ", Data Size: " << getSizeStr(size_list_[size_idx]);
+  }
+
+  std::cout << std::endl;
+  std::cout << std::endl;
+  std::cout.precision(6);
+  std::cout << std::fixed;
+
+  PrintPoolLegend();
+  PrintMatrixHeader();
+  for (uint32_t idx0 = 0; idx0 < dim; idx0++) {
+    PrintMatrixRowId(idx0);
+    for (uint32_t idx1 = 0; idx1 < dim; idx1++) {
+      format = 12;
+      std::cout.width(format);
+      double value = perf_matrix[(idx0 * dim) + idx1];
+      if (value == 0) {
+        std::cout << "N/A";
+      } else {
+        std::cout << value;
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+  delete[] perf_matrix;
+}
+
+// @brief: Display peak bandwidth between system memory of every NUMA
+// node, in rows, and every Gpu, in columns. Cells of the node local
+// to a Gpu are marked by '*' and the last row gives the bandwidth of
+// the slowest remote node as a percentage of the local node. Host
+// buffers of the matrix are backed by pages of the given kind
+void RocmBandwidthTest::DisplayNumaMatrix(bool host_to_dev, uint32_t page_kind) const {
+
+  uint32_t dim = agent_index_;
+  double* perf_matrix = new double[dim * dim]();
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    const async_trans_t& trans = trans_list_[idx];
+    if (trans.copy.page_kind_ != page_kind) {
+      continue;
+    }
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    bool src_is_cpu = (agent_list_[src_dev_idx].device_type_ == HSA_DEVICE_TYPE_CPU);
+    if (src_is_cpu != host_to_dev) {
+      continue;
+    }
+    uint32_t cpu_idx = (host_to_dev) ? src_dev_idx : dst_dev_idx;
+    uint32_t gpu_idx = (host_to_dev) ? dst_dev_idx : src_dev_idx;
+    perf_matrix[(cpu_idx * dim) + gpu_idx] = trans.peak_bandwidth_[0];
+  }
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+  std::cout.width(format);
+  std::cout << "";
+  if (host_to_dev) {
+    std::cout << "Host to Device peak bandwidth GB/s per NUMA node";
+  } else {
+    std::cout << "Device to Host peak bandwidth GB/s per NUMA node";
+  }
+  if (page_kind != HOST_PAGE_POOL) {
+    std::cout << ", Host pages: " << HostBufferProvider::GetPageKindName(page_kind);
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+  std::cout.precision(6);
+  std::cout << std::fixed;
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "C/G";
+  for (uint32_t gpu_idx = 0; gpu_idx < dim; gpu_idx++) {
+    if (agent_list_[gpu_idx].device_type_ == HSA_DEVICE_TYPE_GPU) {
+      std::cout.width(14);
+      std::cout << gpu_idx;
+    }
+  }
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  for (uint32_t cpu_idx = 0; cpu_idx < dim; cpu_idx++) {
+    if (agent_list_[cpu_idx].device_type_ != HSA_DEVICE_TYPE_CPU) {
+      continue;
+    }
+    std::cout.width(format);
+    std::cout << "";
+    std::cout.width(format);
+    std::cout << cpu_idx;
+    for (uint32_t gpu_idx = 0; gpu_idx < dim; gpu_idx++) {
+      if (agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) {
+        continue;
+      }
+      std::stringstream cell;
+      double value = perf_matrix[(cpu_idx * dim) + gpu_idx];
+      if (value == 0) {
+        cell << "N/A";
+      } else {
+        cell << std::fixed << std::setprecision(6) << value;
+        if (agent_list_[cpu_idx].numa_node_ == agent_list_[gpu_idx].numa_node_) {
+          cell << "*";
+        }
+      }
+      std::cout.width(14);
+      std::cout << cell.str();
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+
+  // Compare slowest remote node against local node of every Gpu
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  std::cout << "Remote %";
+  std::cout.precision(1);
+  for (uint32_t gpu_idx = 0; gpu_idx < dim; gpu_idx++) {
+    if (agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) {
+      continue;
+    }
+    double local = 0;
+    double remote = 0;
+    for (uint32_t cpu_idx = 0; cpu_idx < dim; cpu_idx++) {
+      double value = perf_matrix[(cpu_idx * dim) + gpu_idx];
+      if ((agent_list_[cpu_idx].device_type_ != HSA_DEVICE_TYPE_CPU) || (value == 0)) {
+        continue;
+      }
+      if (agent_list_[cpu_idx].numa_node_ == agent_list_[gpu_idx].numa_node_) {
+        local = value;
+      } else if ((remote == 0) || (value < remote)) {
+        remote = value;
+      }
+    }
+    std::cout.width(14);
+    if ((local == 0) || (remote == 0)) {
+      std::cout << "N/A";
+    } else {
+      std::cout << ((remote * 100) / local);
+    }
+  }
+  std::cout.precision(6);
+  std::cout << std::endl;
+  std::cout << std::endl;
+  std::cout << std::endl;
+  delete[] perf_matrix;
+}
+
+// @brief: Display measured bandwidth as a percentage of the theoretical
+// capacity of each data path. Paths that fall below the threshold are
+// marked with an asterisk so that degraded links stand out
+void RocmBandwidthTest::DisplayEfficiencyMatrix(bool peak, uint32_t size_idx) const {
+
+  // Efficiency below which a data path is flagged as degraded
+  const double threshold = 60.0;
+
+  uint32_t dim = GetMatrixDim();
+  double* eff_matrix = new double[dim * dim]();
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t trans = trans_list_[idx];
+    uint32_t src_dev_idx = pool_list_[trans.copy.src_idx_].agent_index_;
+    uint32_t dst_dev_idx = pool_list_[trans.copy.dst_idx_].agent_index_;
+    double capacity = GetPathCapacity(src_dev_idx, dst_dev_idx, trans.copy.bidir_);
+    if (capacity == 0) {
+      continue;
+    }
+    double bandwidth = (peak) ? trans.peak_bandwidth_[size_idx] :
+                                trans.avg_bandwidth_[size_idx];
+    uint32_t src_idx = GetMatrixIdx(trans.copy.src_idx_);
+    uint32_t dst_idx = GetMatrixIdx(trans.copy.dst_idx_);
+    eff_matrix[(src_idx * dim) + dst_idx] = (bandwidth * 100) / capacity;
+  }
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout.precision(1);
+  std::cout << std::fixed;
+  std::cout.width(format);
+  std::cout << "";
+  std::cout << "Link efficiency, percent of theoretical capacity";
+  if (size_list_.size() > 1) {
+    std::cout << ", Data Size: " << getSizeStr(size_list_[size_idx]);
+  }
+  std::cout << " (* below " << threshold << "%)";
+  std::cout << std::endl;
+  std::cout << std::endl;
+
+  PrintMatrixHeader();
+  for (uint32_t idx0 = 0; idx0 < dim; idx0++) {
+    PrintMatrixRowId(idx0);
+    for (uint32_t idx1 = 0; idx1 < dim; idx1++) {
+      format = 12;
+      std::cout.width(format);
+      double value = eff_matrix[(idx0 * dim) + idx1];
+      if (value == 0) {
+        std::cout << "N/A";
+      } else {
+        std::stringstream eff_str;
+        eff_str.precision(1);
+        eff_str << std::fixed << value << ((value < threshold) ? "%*" : "%");
+        std::cout << eff_str.str();
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+  std::cout.precision(6);
+  delete[] eff_matrix;
+}
+
+// @brief: Display estimated runtime of copy transactions, used
+// to plan runs on systems that are not at hand
+void RocmBandwidthTest::DisplayRunEstimate() const {
+
+  uint32_t format = 15;
+  std::cout.setf(ios::left);
+  std::cout << std::endl;
+  std::cout.width(format);
+  std::cout << "Transaction";
+  std::cout.width(format);
+  std::cout << "Src Pool";
+  std::cout.width(format);
+  std::cout << "Dst Pool";
+  std::cout.width(format);
+  std::cout << "Bidirectional";
+  std::cout.width(format);
+  std::cout << "Est Time(s)";
+  std::cout << std::endl;
+
+  double total_time = 0;
+  uint32_t skip_count[REQ_INVALID] = {0};
+  uint32_t trans_size = trans_list_.size();
+  uint32_t size_len = size_list_.size();
+  std::cout.precision(3);
+  std::cout << std::fixed;
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    const async_trans_t& trans = trans_list_[idx];
+    if ((trans.req_type_ == REQ_READ) ||
+        (trans.req_type_ == REQ_WRITE) ||
+        (trans.req_type_ == REQ_STREAM) ||
+        (trans.req_type_ == REQ_LATENCY) ||
+        (trans.req_type_ == REQ_COLLECTIVE) ||
+        (trans.req_type_ == REQ_BISECTION) ||
+        (trans.req_type_ == REQ_INTERFERENCE) ||
+        (trans.req_type_ == REQ_HOST_LOAD)) {
+      skip_count[trans.req_type_]++;
+      std::cout.width(format);
+      std::cout << idx;
+      std::cout.width(format * 3);
+      std::cout << GetReqName(trans.req_type_);
+      std::cout.width(format);
+      std::cout << "Not estimated";
+      std::cout << std::endl;
+      continue;
+    }
+
+    double trans_time = 0;
+    for (uint32_t jdx = 0; jdx < size_len; jdx++) {
+      trans_time += EstimateCopyTime(trans, size_list_[jdx]);
+    }
+    total_time += trans_time;
+
+    std::cout.width(format);
+    std::cout << idx;
+    std::cout.width(format);
+    std::cout << trans.copy.src_idx_;
+    std::cout.width(format);
+    std::cout << trans.copy.dst_idx_;
+    std::cout.width(format);
+    std::cout << ((trans.copy.bidir_) ? "Yes" : "No");
+    std::cout.width(format);
+    std::cout << trans_time;
+    std::cout << std::endl;
+  }
+
+  std::cout << std::endl;
+  std::cout << "Estimated runtime of copy transactions (s): " << total_time << std::endl;
+
+  // Runtime of other transactions is not modelled, hence not part of
+  // the total, which may otherwise be taken for the whole run
+  for (uint32_t req_type = 0; req_type < REQ_INVALID; req_type++) {
+    if (skip_count[req_type] != 0) {
+      std::cout << "Not estimated, not part of total: " << skip_count[req_type]
+                << " " << GetReqName(req_type) << " transactions" << std::endl;
+    }
+  }
+  std::cout << std::endl;
+  std::cout.precision(6);
+}
+
+void RocmBandwidthTest::DisplayValidationMatrix() const {
+
+  uint32_t dim = GetMatrixDim();
+  double* perf_matrix = new double[dim * dim]();
+  uint32_t trans_size = trans_list_.size();
+  for (uint32_t idx = 0; idx < trans_size; idx++) {
+    async_trans_t trans = trans_list_[idx];
+    uint32_t src_idx = GetMatrixIdx(trans.copy.src_idx_);
+    uint32_t dst_idx = GetMatrixIdx(trans.copy.dst_idx_);
+    perf_matrix[(src_idx * dim) + dst_idx] = (trans.data_valid_) ? 2 : 1;
+  }
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout.width(format);
+  std::cout << "";
+  std::cout.width(format);
+  
+  std::cout << "Data Path Validation";
+
+  // A path passes only if copies of every buffer size are valid
+  if (size_list_.size() > 1) {
+    std::cout << ", Data Sizes:";
+    for (uint32_t idx = 0; idx < size_list_.size(); idx++) {
+      std::cout << ((idx == 0) ? " " : ", ") << getSizeStr(size_list_[idx]);
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << std::endl;
+  std::cout.precision(6);
+  std::cout << std::fixed;
+
+  PrintPoolLegend();
+  PrintMatrixHeader();
+  for (uint32_t idx0 = 0; idx0 < dim; idx0++) {
+    PrintMatrixRowId(idx0);
+    for (uint32_t idx1 = 0; idx1 < dim; idx1++) {
+      format = 12;
+      std::cout.width(format);
+      double value = perf_matrix[(idx0 * dim) + idx1];
+      if (value == 0) {
+        std::cout << "N/A";
+      } else if (value < 2) {
+        std::cout << "FAIL";
+      } else {
+        std::cout << "PASS";
+      }
+    }
+    std::cout << std::endl;
+    std::cout << std::endl;
+  }
+  std::cout << std::endl;
+  delete[] perf_matrix;
+}
+
+void RocmBandwidthTest::DisplayDevInfo() const {
+
+  uint32_t format = 10;
+  std::cout.setf(ios::left);
+
+  std::cout << std::endl;
+  for (uint32_t idx = 0; idx < agent_index_; idx++) {
+    uint32_t active = active_agents_list_[idx];
+    if (active == 1) {
+      std::cout.width(format);
+      std::cout << "";
+      std::cout << "Device: " << idx;
+      std::cout << ",  " << agent_list_[idx].name_ << std::endl;
+    }
+  }
+  std::cout << std::endl;
+}
+
+
@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Size of each bounce buffer staging copies from pageable memory.
+// Two of them let the Cpu fill one while the device drains the other
+static const size_t STAGING_CHUNK_SIZE = 4 * 1024 * 1024;
+static const uint32_t STAGING_BUFFER_NUM = 2;
+
+// @brief: Copy a pageable buffer to a device through locked bounce
+// buffers. Cpu copies a chunk into a bounce buffer while the device
+// copies out the chunk staged before it
+void RocmBandwidthTest::CopyStaged(void* dst, hsa_agent_t dst_agent, const char* src,
+                                   char** bounce_list, hsa_signal_t* signal_list,
+                                   hsa_agent_t host_agent, size_t size) {
+
+  uint32_t slot = 0;
+  for (size_t offset = 0; offset < size; offset += STAGING_CHUNK_SIZE) {
+
+    // Wait for the copy out of bounce buffer to drain
+    size_t chunk = std::min(STAGING_CHUNK_SIZE, size - offset);
+    while (backend_->SignalWait(signal_list[slot], HSA_SIGNAL_CONDITION_LT, 1,
+                                HSA_WAIT_STATE_ACTIVE));
+
+    HostCopyEngine::host_copy_job_t job;
+    job.dst_ = bounce_list[slot];
+    job.src_ = src + offset;
+    job.size_ = chunk;
+    host_engine_->Copy(&job, 1);
+
+    backend_->SignalStore(signal_list[slot], 1);
+    err_ = backend_->AsyncCopy((char*)dst + offset, dst_agent,
+                               bounce_list[slot], host_agent,
+                               chunk, 0, NULL, signal_list[slot]);
+    ErrorCheck(err_);
+    slot = (slot + 1) % STAGING_BUFFER_NUM;
+  }
+
+  for (uint32_t idx = 0; idx < STAGING_BUFFER_NUM; idx++) {
+    while (backend_->SignalWait(signal_list[idx], HSA_SIGNAL_CONDITION_LT, 1,
+                                HSA_WAIT_STATE_ACTIVE));
+  }
+}
+
+// @brief: Run copies to a Gpu from system memory of the Cpu device
+// of its NUMA node. Buffers of malloc are either locked around every
+// copy or staged, time of either being part of time of copy
+void RocmBandwidthTest::RunHostSourceBenchmark(async_trans_t& trans) {
+
+  uint32_t src_idx = trans.copy.src_idx_;
+  uint32_t dst_idx = trans.copy.dst_idx_;
+  uint32_t host_idx = pool_list_[src_idx].agent_index_;
+  uint32_t mode = trans.copy.source_mode_;
+  hsa_agent_t host_agent = agent_list_[host_idx].agent_;
+  hsa_agent_t dev_agent = pool_list_[dst_idx].owner_agent_;
+  PinToNumaNode(agent_list_[host_idx].numa_node_);
+
+  // Allocate destination from the pool of Gpu and source either
+  // from the pool of Cpu or from malloc, as an application would
+  uint32_t max_size = size_list_.back();
+  void* dst = NULL;
+  char* src = NULL;
+  err_ = backend_->PoolAllocate(trans.copy.dst_pool_, max_size, 0, &dst);
+  ErrorCheck(err_);
+  if (mode == HOST_SOURCE_POOL) {
+    err_ = backend_->PoolAllocate(trans.copy.src_pool_, max_size, 0, (void**)&src);
+    ErrorCheck(err_);
+    AcquirePoolAcceses(src_idx, src, dst_idx, dst);
+  } else {
+    src = (char*)malloc(max_size);
+    err_ = (src == NULL) ? HSA_STATUS_ERROR_OUT_OF_RESOURCES : HSA_STATUS_SUCCESS;
+    ErrorCheck(err_);
+    if (GetPoolAccess(host_idx, dst_idx) != HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+      AcquireAccess(host_agent, dst);
+    }
+  }
+
+  // Touch source so that its pages are resident, as they would
+  // be in an application that produced the data
+  memset(src, 0x23, max_size);
+
+  // Bounce buffers of staged copies are allocated from the pool
+  // of Cpu and hence are locked once for all copies
+  char* bounce_list[STAGING_BUFFER_NUM] = { NULL };
+  hsa_signal_t signal_list[STAGING_BUFFER_NUM];
+  if (mode == HOST_SOURCE_STAGED) {
+    BindHostCopyEngine(agent_list_[host_idx].numa_node_);
+    for (uint32_t idx = 0; idx < STAGING_BUFFER_NUM; idx++) {
+      err_ = backend_->PoolAllocate(trans.copy.src_pool_, STAGING_CHUNK_SIZE, 0,
+                                    (void**)&bounce_list[idx]);
+      ErrorCheck(err_);
+      AcquireAccess(dev_agent, bounce_list[idx]);
+      err_ = backend_->SignalCreate(0, &signal_list[idx]);
+      ErrorCheck(err_);
+    }
+  }
+  hsa_signal_t signal;
+  err_ = backend_->SignalCreate(1, &signal);
+  ErrorCheck(err_);
+
+  uint32_t iterations = GetIterationNum();
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    uint32_t curr_size = size_list_[idx];
+    cout << endl << "RUNNING " << iterations << " ITERATIONS of "
+         << HostBufferProvider::GetSourceModeName(mode) << " copy for buffer size "
+         << curr_size << endl;
+
+    // Time every iteration by Cpu, as locking and staging
+    // are not visible to the timestamps of device
+    double total_time = 0;
+    double setup_time = 0;
+    double min_time = std::numeric_limits<double>::max();
+    for (uint32_t it = 0; it < iterations; it++) {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      if (mode == HOST_SOURCE_STAGED) {
+        CopyStaged(dst, dev_agent, src, bounce_list, signal_list, host_agent, curr_size);
+      } else {
+
+        // Lock the buffer of malloc for the device and unlock it
+        // once copied, charging both to the time of copy
+        void* agent_ptr = src;
+        if (mode == HOST_SOURCE_LOCKED) {
+          err_ = backend_->MemoryLock(src, curr_size, &dev_agent, 1, &agent_ptr);
+          ErrorCheck(err_);
+        }
+        std::chrono::steady_clock::time_point copy_start = std::chrono::steady_clock::now();
+        backend_->SignalStore(signal, 1);
+        err_ = backend_->AsyncCopy(dst, dev_agent, agent_ptr, host_agent,
+                                   curr_size, 0, NULL, signal);
+        ErrorCheck(err_);
+        while (backend_->SignalWait(signal, HSA_SIGNAL_CONDITION_LT, 1,
+                                    HSA_WAIT_STATE_ACTIVE));
+        std::chrono::steady_clock::time_point copy_end = std::chrono::steady_clock::now();
+        if (mode == HOST_SOURCE_LOCKED) {
+          err_ = backend_->MemoryUnlock(src);
+          ErrorCheck(err_);
+          std::chrono::duration<double> lock_time = (copy_start - start) +
+                                  (std::chrono::steady_clock::now() - copy_end);
+          setup_time += lock_time.count();
+        }
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      total_time += elapsed.count();
+      min_time = std::min(min_time, elapsed.count());
+    }
+
+    double avg_time = total_time / iterations;
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.setup_time_.push_back(setup_time / iterations);
+    trans.avg_bandwidth_.push_back((double)curr_size / avg_time / 1000 / 1000 / 1000);
+    trans.peak_bandwidth_.push_back((double)curr_size / min_time / 1000 / 1000 / 1000);
+  }
+
+  err_ = backend_->SignalDestroy(signal);
+  ErrorCheck(err_);
+  if (mode == HOST_SOURCE_STAGED) {
+    for (uint32_t idx = 0; idx < STAGING_BUFFER_NUM; idx++) {
+      err_ = backend_->PoolFree(bounce_list[idx]);
+      ErrorCheck(err_);
+      err_ = backend_->SignalDestroy(signal_list[idx]);
+      ErrorCheck(err_);
+    }
+  }
+  if (mode == HOST_SOURCE_POOL) {
+    err_ = backend_->PoolFree(src);
+    ErrorCheck(err_);
+  } else {
+    free(src);
+  }
+  err_ = backend_->PoolFree(dst);
+  ErrorCheck(err_);
+}
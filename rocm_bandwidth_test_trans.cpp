@@ -1,351 +1,930 @@
-////////////////////////////////////////////////////////////////////////////////
-//
-// The University of Illinois/NCSA
-// Open Source License (NCSA)
-// 
-// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
-// 
-// Developed by:
-// 
-//                 AMD Research and AMD HSA Software Development
-// 
-//                 Advanced Micro Devices, Inc.
-// 
-//                 www.amd.com
-// 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to
-// deal with the Software without restriction, including without limitation
-// the rights to use, copy, modify, merge, publish, distribute, sublicense,
-// and/or sell copies of the Software, and to permit persons to whom the
-// Software is furnished to do so, subject to the following conditions:
-// 
-//  - Redistributions of source code must retain the above copyright notice,
-//    this list of conditions and the following disclaimers.
-//  - Redistributions in binary form must reproduce the above copyright
-//    notice, this list of conditions and the following disclaimers in
-//    the documentation and/or other materials provided with the distribution.
-//  - Neither the names of Advanced Micro Devices, Inc,
-//    nor the names of its contributors may be used to endorse or promote
-//    products derived from this Software without specific prior written
-//    permission.
-// 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
-// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
-// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
-// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
-// DEALINGS WITH THE SOFTWARE.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-#include "common.hpp"
-#include "rocm_bandwidth_test.hpp"
-
-bool RocmBandwidthTest::BuildReadOrWriteTrans(uint32_t req_type,
-                                      vector<uint32_t>& in_list) {
-
-  // Validate the list of pool-agent tuples
-  hsa_status_t status;
-  hsa_amd_memory_pool_access_t access;
-  uint32_t list_size = in_list.size();
-  for (uint32_t idx = 0; idx < list_size; idx+=2) {
-
-    uint32_t pool_idx = in_list[idx];
-    uint32_t exec_idx = in_list[idx + 1];
-
-    // Retrieve Roc runtime handles for memory pool and agent
-    hsa_agent_t exec_agent = agent_list_[exec_idx].agent_;
-    hsa_amd_memory_pool_t pool = pool_list_[pool_idx].pool_;
-
-    // Determine agent can access the memory pool
-    status = hsa_amd_agent_memory_pool_get_info(exec_agent, pool,
-                           HSA_AMD_AGENT_MEMORY_POOL_INFO_ACCESS, &access);
-    ErrorCheck(status);
-
-    // Determine if accessibility to agent is not denied
-    if (access == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
-      PrintIOAccessError(exec_idx, pool_idx);
-      return false;
-    }
-
-    // Agent has access, build an instance of transaction
-    // and add it to the list of transactions
-    async_trans_t trans(req_type);
-    trans.kernel.code_ = NULL;
-    trans.kernel.pool_ = pool;
-    trans.kernel.pool_idx_ = pool_idx;
-    trans.kernel.agent_ = exec_agent;
-    trans.kernel.agent_idx_ = exec_idx;
-    trans_list_.push_back(trans);
-  }
-  return true;
-}
-
-bool RocmBandwidthTest::BuildReadTrans() {
-  return BuildReadOrWriteTrans(REQ_READ, read_list_);
-}
-
-bool RocmBandwidthTest::BuildWriteTrans() {
-  return BuildReadOrWriteTrans(REQ_WRITE, write_list_);
-}
-
-bool RocmBandwidthTest::FilterCpuPool(uint32_t req_type,
-                              hsa_device_type_t dev_type,
-                              bool fine_grained) {
-
-  if ((req_type != REQ_COPY_ALL_BIDIR) &&
-      (req_type != REQ_COPY_ALL_UNIDIR)) {
-    return false;
-  }
-
-  // Determine if device is a Cpu - filter out only if
-  // it is a Cpu device
-  if (dev_type != HSA_DEVICE_TYPE_CPU) {
-    return false;
-  }
-
-  // If env to skip fine grain is NULL it means
-  // we should filter out coarse-grain pools
-  if (skip_fine_grain_ == NULL) {
-    return (fine_grained == false);
-  }
-
-  // If env to skip fine grain is NON-NULL it means
-  // we should filter out fine-grain pools
-  return (fine_grained == true);
-}
-
-bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type,
-                               vector<uint32_t>& src_list,
-                               vector<uint32_t>& dst_list) {
-
-  // bool filter_out;
-  uint32_t src_size = src_list.size();
-  uint32_t dst_size = dst_list.size();
-
-  // hsa_status_t status;
-  // hsa_amd_memory_pool_access_t access;
-  for (uint32_t idx = 0; idx < src_size; idx++) {
-
-    // Retrieve Roc runtime handles for Src memory pool and agents
-    uint32_t src_idx = src_list[idx];
-    uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
-    // hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
-    hsa_amd_memory_pool_t src_pool = pool_list_[src_idx].pool_;
-    // bool src_fine_grained =  pool_list_[src_idx].is_fine_grained_;
-    hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
-
-    /*
-     * This block of code makes sense only if both Fine and Coarse
-     * grained memory pools are captured. This does not make sense
-     * if only of them is captured
-    filter_out = FilterCpuPool(req_type, src_dev_type, src_fine_grained);
-    if (filter_out) {
-      continue;
-    }
-    */
-
-    for (uint32_t jdx = 0; jdx < dst_size; jdx++) {
-
-      // Retrieve Roc runtime handles for Dst memory pool and agents
-      uint32_t dst_idx = dst_list[jdx];
-      uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
-      // hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
-      hsa_amd_memory_pool_t dst_pool = pool_list_[dst_idx].pool_;
-      // bool dst_fine_grained =  pool_list_[dst_idx].is_fine_grained_;
-      hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
-
-    /*
-     * This block of code makes sense only if both Fine and Coarse
-     * grained memory pools are captured. This does not make sense
-     * if only of them is captured
-      filter_out = FilterCpuPool(req_type, dst_dev_type, dst_fine_grained);
-      if (filter_out) {
-        continue;
-      }
-      */
-
-      // Filter out transactions that involve only Cpu agents/devices
-      // without regard to type of request, default run, partial or full
-      // unidirectional or bidirectional copies
-      if ((src_dev_type == HSA_DEVICE_TYPE_CPU) &&
-          (dst_dev_type == HSA_DEVICE_TYPE_CPU)) {
-        continue;
-      }
-
-      // Filter out transactions that involve only same GPU as both
-      // Src and Dst device if the request is bidirectional copy that
-      // is either partial or full
-      if ((req_type == REQ_COPY_BIDIR) ||
-          (req_type == REQ_COPY_ALL_BIDIR)) {
-        if (src_dev_idx == dst_dev_idx) {
-          continue;
-        }
-      }
-
-      // Determine if accessibility to src pool for dst agent is not denied
-      uint32_t path_exists = access_matrix_[(src_dev_idx * agent_index_) + dst_dev_idx];
-      if (path_exists == 0) {
-        if ((req_type == REQ_COPY_ALL_BIDIR) ||
-            (req_type == REQ_COPY_ALL_UNIDIR)) {
-          continue;
-        } else {
-          PrintCopyAccessError(src_idx, dst_idx);
-          return false;
-        }
-      }
-
-      // Update the list of agents active in any copy operation
-      if (active_agents_list_ == NULL) {
-        active_agents_list_  = new uint32_t[agent_index_]();
-      }
-      active_agents_list_[src_dev_idx] = 1;
-      active_agents_list_[dst_dev_idx] = 1;
-
-      // Agents have access, build an instance of transaction
-      // and add it to the list of transactions
-      async_trans_t trans(req_type);
-      trans.copy.src_idx_ = src_idx;
-      trans.copy.dst_idx_ = dst_idx;
-      trans.copy.src_pool_ = src_pool;
-      trans.copy.dst_pool_ = dst_pool;
-      trans.copy.bidir_ = ((req_type == REQ_COPY_BIDIR) ||
-                           (req_type == REQ_COPY_ALL_BIDIR));
-      trans.copy.uses_gpu_ = ((src_dev_type == HSA_DEVICE_TYPE_GPU) ||
-                              (dst_dev_type == HSA_DEVICE_TYPE_GPU));
-      trans_list_.push_back(trans);
-    }
-  }
-
-  return true;
-}
-
-bool RocmBandwidthTest::BuildBidirCopyTrans() {
-  return BuildCopyTrans(REQ_COPY_BIDIR, bidir_list_, bidir_list_);
-}
-
-bool RocmBandwidthTest::BuildUnidirCopyTrans() {
-  return BuildCopyTrans(REQ_COPY_UNIDIR, src_list_, dst_list_);
-}
-
-bool RocmBandwidthTest::BuildAllPoolsBidirCopyTrans() {
-  return BuildCopyTrans(REQ_COPY_ALL_BIDIR, bidir_list_, bidir_list_);
-}
-
-bool RocmBandwidthTest::BuildAllPoolsUnidirCopyTrans() {
-  return BuildCopyTrans(REQ_COPY_ALL_UNIDIR, src_list_, dst_list_);
-}
-
-// @brief: Builds a list of transaction per user request
-bool RocmBandwidthTest::BuildTransList() {
-
-  // Build list of Read transactions per user request
-  bool status = false;
-  if (req_read_ == REQ_READ) {
-    status = BuildReadTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // Build list of Write transactions per user request
-  status = false;
-  if (req_write_ == REQ_WRITE) {
-    status = BuildWriteTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // Build list of Bidirectional Copy transactions per user request
-  status = false;
-  if (req_copy_bidir_ == REQ_COPY_BIDIR) {
-    status = BuildBidirCopyTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // Build list of Unidirectional Copy transactions per user request
-  status = false;
-  if (req_copy_unidir_ == REQ_COPY_UNIDIR) {
-    status = BuildUnidirCopyTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // Build list of All Bidir Copy transactions per user request
-  status = false;
-  if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
-    status = BuildAllPoolsBidirCopyTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // Build list of All Unidir Copy transactions per user request
-  status = false;
-  if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
-    status = BuildAllPoolsUnidirCopyTrans();
-    if (status == false) {
-      return status;
-    }
-  }
-
-  // All of the transaction are built up
-  return true;
-}
-
-void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
-
-  // Get the frequency of Gpu Timestamping
-  uint64_t sys_freq = 0;
-  hsa_system_get_info(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
-
-  double avg_time = 0;
-  double min_time = 0;
-  uint32_t data_size = 0;
-  double avg_bandwidth = 0;
-  double peak_bandwidth = 0;
-  uint32_t size_len = size_list_.size();
-  for (uint32_t idx = 0; idx < size_len; idx++) {
-
-    // Adjust size of data involved in copy
-    data_size = size_list_[idx];
-    if (trans.copy.bidir_ == true) {
-      data_size += size_list_[idx];
-    }
-
-    // Double data size if copying the same device
-    if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
-      data_size += data_size;
-    }
-
-    // Copy operation does not involve a Gpu device
-    if (trans.copy.uses_gpu_ != true) {
-      avg_time = trans.cpu_avg_time_[idx];
-      min_time = trans.cpu_min_time_[idx];
-      avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
-      peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
-    } else {
-      if (print_cpu_time_ == false) {
-        avg_time = trans.gpu_avg_time_[idx] / sys_freq;
-        min_time = trans.gpu_min_time_[idx] / sys_freq;
-      } else {
-        avg_time = trans.cpu_avg_time_[idx];
-        min_time = trans.cpu_min_time_[idx];
-      }
-      avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
-      peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
-    }
-
-    trans.min_time_.push_back(min_time);
-    trans.avg_time_.push_back(avg_time);
-    trans.avg_bandwidth_.push_back(avg_bandwidth);
-    trans.peak_bandwidth_.push_back(peak_bandwidth);
-  }
-}
-
+////////////////////////////////////////////////////////////////////////////////
+//
+// The University of Illinois/NCSA
+// Open Source License (NCSA)
+// 
+// Copyright (c) 2014-2015, Advanced Micro Devices, Inc. All rights reserved.
+// 
+// Developed by:
+// 
+//                 AMD Research and AMD HSA Software Development
+// 
+//                 Advanced Micro Devices, Inc.
+// 
+//                 www.amd.com
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal with the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// 
+//  - Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimers.
+//  - Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimers in
+//    the documentation and/or other materials provided with the distribution.
+//  - Neither the names of Advanced Micro Devices, Inc,
+//    nor the names of its contributors may be used to endorse or promote
+//    products derived from this Software without specific prior written
+//    permission.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE CONTRIBUTORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS WITH THE SOFTWARE.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common.hpp"
+#include "rocm_bandwidth_test.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+
+// Bound on balanced bipartitions measured, which grow as binomial
+// coefficients with the number of Gpu devices. Beyond it a sample
+// of bipartitions is drawn at random
+static const uint32_t BISECTION_PARTITION_MAX = 128;
+
+// Bound on Gpu devices of a bisection, whose sides are kept as
+// masks of their ranks
+static const uint32_t BISECTION_RANK_MAX = 63;
+
+bool RocmBandwidthTest::BuildReadOrWriteTrans(uint32_t req_type,
+                                      vector<uint32_t>& in_list) {
+
+  // Validate the list of pool-agent tuples
+  uint32_t list_size = in_list.size();
+  for (uint32_t idx = 0; idx < list_size; idx+=2) {
+
+    uint32_t pool_idx = in_list[idx];
+    uint32_t exec_idx = in_list[idx + 1];
+
+    // Retrieve Roc runtime handles for memory pool and agent
+    hsa_agent_t exec_agent = agent_list_[exec_idx].agent_;
+    hsa_amd_memory_pool_t pool = pool_list_[pool_idx].pool_;
+
+    // Determine if accessibility to agent is not denied
+    if (GetPoolAccess(exec_idx, pool_idx) == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+      PrintIOAccessError(exec_idx, pool_idx);
+      return false;
+    }
+
+    // Agent has access, build an instance of transaction
+    // and add it to the list of transactions
+    async_trans_t trans(req_type);
+    trans.kernel.code_ = NULL;
+    trans.kernel.pool_ = pool;
+    trans.kernel.pool_idx_ = pool_idx;
+    trans.kernel.agent_ = exec_agent;
+    trans.kernel.agent_idx_ = exec_idx;
+    trans_list_.push_back(trans);
+  }
+  return true;
+}
+
+bool RocmBandwidthTest::BuildReadTrans() {
+  return BuildReadOrWriteTrans(REQ_READ, read_list_);
+}
+
+bool RocmBandwidthTest::BuildWriteTrans() {
+  return BuildReadOrWriteTrans(REQ_WRITE, write_list_);
+}
+
+bool RocmBandwidthTest::FilterCpuPool(uint32_t req_type,
+                              hsa_device_type_t dev_type,
+                              bool fine_grained) {
+
+  if ((req_type != REQ_COPY_ALL_BIDIR) &&
+      (req_type != REQ_COPY_ALL_UNIDIR)) {
+    return false;
+  }
+
+  // Determine if device is a Cpu - filter out only if
+  // it is a Cpu device
+  if (dev_type != HSA_DEVICE_TYPE_CPU) {
+    return false;
+  }
+
+  // If env to skip fine grain is NULL it means
+  // we should filter out coarse-grain pools
+  if (skip_fine_grain_ == NULL) {
+    return (fine_grained == false);
+  }
+
+  // If env to skip fine grain is NON-NULL it means
+  // we should filter out fine-grain pools
+  return (fine_grained == true);
+}
+
+bool RocmBandwidthTest::BuildCopyTrans(uint32_t req_type,
+                               vector<uint32_t>& src_list,
+                               vector<uint32_t>& dst_list) {
+
+  // bool filter_out;
+  uint32_t src_size = src_list.size();
+  uint32_t dst_size = dst_list.size();
+
+  // hsa_status_t status;
+  // hsa_amd_memory_pool_access_t access;
+  for (uint32_t idx = 0; idx < src_size; idx++) {
+
+    // Retrieve Roc runtime handles for Src memory pool and agents
+    uint32_t src_idx = src_list[idx];
+    uint32_t src_dev_idx = pool_list_[src_idx].agent_index_;
+    // hsa_agent_t src_agent = pool_list_[src_idx].owner_agent_;
+    hsa_amd_memory_pool_t src_pool = pool_list_[src_idx].pool_;
+    // bool src_fine_grained =  pool_list_[src_idx].is_fine_grained_;
+    hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+
+    /*
+     * This block of code makes sense only if both Fine and Coarse
+     * grained memory pools are captured. This does not make sense
+     * if only of them is captured
+    filter_out = FilterCpuPool(req_type, src_dev_type, src_fine_grained);
+    if (filter_out) {
+      continue;
+    }
+    */
+
+    for (uint32_t jdx = 0; jdx < dst_size; jdx++) {
+
+      // Retrieve Roc runtime handles for Dst memory pool and agents
+      uint32_t dst_idx = dst_list[jdx];
+      uint32_t dst_dev_idx = pool_list_[dst_idx].agent_index_;
+      // hsa_agent_t dst_agent = pool_list_[dst_idx].owner_agent_;
+      hsa_amd_memory_pool_t dst_pool = pool_list_[dst_idx].pool_;
+      // bool dst_fine_grained =  pool_list_[dst_idx].is_fine_grained_;
+      hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+
+    /*
+     * This block of code makes sense only if both Fine and Coarse
+     * grained memory pools are captured. This does not make sense
+     * if only of them is captured
+      filter_out = FilterCpuPool(req_type, dst_dev_type, dst_fine_grained);
+      if (filter_out) {
+        continue;
+      }
+      */
+
+      // Filter out transactions that involve only same GPU as both
+      // Src and Dst device if the request is bidirectional copy that
+      // is either partial or full
+      if ((req_type == REQ_COPY_BIDIR) ||
+          (req_type == REQ_COPY_ALL_BIDIR)) {
+        if (src_dev_idx == dst_dev_idx) {
+          continue;
+        }
+      }
+
+      // Determine if accessibility to src pool for dst agent is not denied
+      uint32_t path_exists = GetPoolPathAccess(src_idx, dst_idx);
+      if (path_exists == 0) {
+        if ((req_type == REQ_COPY_ALL_BIDIR) ||
+            (req_type == REQ_COPY_ALL_UNIDIR)) {
+          continue;
+        } else {
+          PrintCopyAccessError(src_idx, dst_idx);
+          return false;
+        }
+      }
+
+      // Update the list of agents active in any copy operation
+      if (active_agents_list_ == NULL) {
+        active_agents_list_  = new uint32_t[agent_index_]();
+      }
+      active_agents_list_[src_dev_idx] = 1;
+      active_agents_list_[dst_dev_idx] = 1;
+
+      // Discover links traversed by copy if not known already
+      BindLinkPath(src_dev_idx, dst_dev_idx);
+
+      // Agents have access, build an instance of transaction
+      // and add it to the list of transactions
+      async_trans_t trans(req_type);
+      trans.copy.src_idx_ = src_idx;
+      trans.copy.dst_idx_ = dst_idx;
+      trans.copy.src_pool_ = src_pool;
+      trans.copy.dst_pool_ = dst_pool;
+      trans.copy.bidir_ = ((req_type == REQ_COPY_BIDIR) ||
+                           (req_type == REQ_COPY_ALL_BIDIR));
+      trans.copy.uses_gpu_ = ((src_dev_type == HSA_DEVICE_TYPE_GPU) ||
+                              (dst_dev_type == HSA_DEVICE_TYPE_GPU));
+      trans.copy.kernel_idx_ = HostCopyEngine::GetBestKernel();
+      trans.copy.page_kind_ = HOST_PAGE_POOL;
+      trans_list_.push_back(trans);
+    }
+  }
+
+  return true;
+}
+
+bool RocmBandwidthTest::BuildBidirCopyTrans() {
+  return BuildCopyTrans(REQ_COPY_BIDIR, bidir_list_, bidir_list_);
+}
+
+bool RocmBandwidthTest::BuildUnidirCopyTrans() {
+  return BuildCopyTrans(REQ_COPY_UNIDIR, src_list_, dst_list_);
+}
+
+bool RocmBandwidthTest::BuildAllPoolsBidirCopyTrans() {
+  return BuildCopyTrans(REQ_COPY_ALL_BIDIR, bidir_list_, bidir_list_);
+}
+
+bool RocmBandwidthTest::BuildAllPoolsUnidirCopyTrans() {
+  return BuildCopyTrans(REQ_COPY_ALL_UNIDIR, src_list_, dst_list_);
+}
+
+// @brief: Builds copy transactions from the system memory of every
+// NUMA node to every Gpu and back. System memory of a node is the
+// first memory pool of its Cpu device
+bool RocmBandwidthTest::BuildNumaCopyTrans() {
+
+  for (uint32_t cpu_idx = 0; cpu_idx < agent_index_; cpu_idx++) {
+    if ((agent_list_[cpu_idx].device_type_ != HSA_DEVICE_TYPE_CPU) ||
+        (agent_pool_list_[cpu_idx].pool_list.size() == 0)) {
+      continue;
+    }
+    uint32_t host_pool_idx = agent_pool_list_[cpu_idx].pool_list[0].index_;
+
+    for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+      if ((agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) ||
+          (agent_pool_list_[gpu_idx].pool_list.size() == 0)) {
+        continue;
+      }
+      uint32_t dev_pool_idx = agent_pool_list_[gpu_idx].pool_list[0].index_;
+      if (GetPoolPathAccess(host_pool_idx, dev_pool_idx) == 0) {
+        continue;
+      }
+
+      // Update the list of agents active in any copy operation
+      if (active_agents_list_ == NULL) {
+        active_agents_list_  = new uint32_t[agent_index_]();
+      }
+      active_agents_list_[cpu_idx] = 1;
+      active_agents_list_[gpu_idx] = 1;
+
+      // Build host to device and device to host transactions,
+      // once per kind of pages backing the host buffer
+      uint32_t pool_pair[2][2] = { { host_pool_idx, dev_pool_idx },
+                                   { dev_pool_idx, host_pool_idx } };
+      for (uint32_t kind_idx = 0; kind_idx < page_kind_list_.size(); kind_idx++) {
+        for (uint32_t idx = 0; idx < 2; idx++) {
+          async_trans_t trans(REQ_COPY_ALL_UNIDIR);
+          trans.copy.src_idx_ = pool_pair[idx][0];
+          trans.copy.dst_idx_ = pool_pair[idx][1];
+          trans.copy.src_pool_ = pool_list_[pool_pair[idx][0]].pool_;
+          trans.copy.dst_pool_ = pool_list_[pool_pair[idx][1]].pool_;
+          trans.copy.bidir_ = false;
+          trans.copy.uses_gpu_ = true;
+          trans.copy.kernel_idx_ = HostCopyEngine::GetBestKernel();
+          trans.copy.page_kind_ = page_kind_list_[kind_idx];
+          trans_list_.push_back(trans);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// @brief: Builds a copy transaction within every memory pool that
+// is accessible to Cpu, once per host copy kernel supported by Cpu.
+// Pool of a Gpu is accessed from the Cpu device on its NUMA node
+bool RocmBandwidthTest::BuildHostKernelTrans() {
+
+  uint32_t pool_size = pool_list_.size();
+  for (uint32_t pool_idx = 0; pool_idx < pool_size; pool_idx++) {
+
+    async_trans_t trans(REQ_COPY_UNIDIR);
+    trans.copy.src_idx_ = pool_idx;
+    trans.copy.dst_idx_ = pool_idx;
+    trans.copy.src_pool_ = pool_list_[pool_idx].pool_;
+    trans.copy.dst_pool_ = pool_list_[pool_idx].pool_;
+    trans.copy.bidir_ = false;
+    trans.copy.uses_gpu_ = false;
+    trans.copy.page_kind_ = HOST_PAGE_POOL;
+    uint32_t host_idx = GetPoolHostIdx(pool_idx);
+    if (GetPoolAccess(host_idx, pool_idx) == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+      continue;
+    }
+
+    // Update the list of agents active in any copy operation
+    if (active_agents_list_ == NULL) {
+      active_agents_list_  = new uint32_t[agent_index_]();
+    }
+    active_agents_list_[pool_list_[pool_idx].agent_index_] = 1;
+
+    for (uint32_t kernel_idx = 0; kernel_idx < HOST_COPY_KERNEL_COUNT; kernel_idx++) {
+      if (HostCopyEngine::IsKernelSupported(kernel_idx)) {
+        trans.copy.kernel_idx_ = kernel_idx;
+        trans_list_.push_back(trans);
+      }
+    }
+  }
+  return true;
+}
+
+// @brief: Builds a transaction per STREAM operation for every memory
+// pool that is accessible to Cpu. Operations are run by the Cpu
+// device nearest to the pool
+bool RocmBandwidthTest::BuildStreamTrans() {
+
+  uint32_t pool_size = pool_list_.size();
+  for (uint32_t pool_idx = 0; pool_idx < pool_size; pool_idx++) {
+
+    uint32_t host_idx = GetPoolHostIdx(pool_idx);
+    if (GetPoolAccess(host_idx, pool_idx) == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED) {
+      continue;
+    }
+
+    // Update the list of agents active in any operation
+    if (active_agents_list_ == NULL) {
+      active_agents_list_  = new uint32_t[agent_index_]();
+    }
+    active_agents_list_[pool_list_[pool_idx].agent_index_] = 1;
+
+    for (uint32_t op = 0; op < HOST_STREAM_OP_COUNT; op++) {
+      async_trans_t trans(REQ_STREAM);
+      trans.kernel.code_ = NULL;
+      trans.kernel.pool_ = pool_list_[pool_idx].pool_;
+      trans.kernel.pool_idx_ = pool_idx;
+      trans.kernel.agent_ = agent_list_[host_idx].agent_;
+      trans.kernel.agent_idx_ = host_idx;
+      trans.kernel.op_ = op;
+      trans_list_.push_back(trans);
+    }
+  }
+  return true;
+}
+
+// @brief: Builds a pointer chase per stride for every Cpu device
+// and every memory pool it can access
+bool RocmBandwidthTest::BuildLatencyTrans() {
+
+  uint32_t pool_size = pool_list_.size();
+  uint32_t stride_len = sizeof(LATENCY_STRIDE_LIST) / sizeof(uint32_t);
+  for (uint32_t pool_idx = 0; pool_idx < pool_size; pool_idx++) {
+    for (uint32_t host_idx = 0; host_idx < agent_index_; host_idx++) {
+
+      if ((agent_list_[host_idx].device_type_ != HSA_DEVICE_TYPE_CPU) ||
+          (GetPoolAccess(host_idx, pool_idx) == HSA_AMD_MEMORY_POOL_ACCESS_NEVER_ALLOWED)) {
+        continue;
+      }
+
+      // Update the list of agents active in any operation
+      if (active_agents_list_ == NULL) {
+        active_agents_list_  = new uint32_t[agent_index_]();
+      }
+      active_agents_list_[host_idx] = 1;
+      active_agents_list_[pool_list_[pool_idx].agent_index_] = 1;
+
+      for (uint32_t idx = 0; idx < stride_len; idx++) {
+        async_trans_t trans(REQ_LATENCY);
+        trans.kernel.code_ = NULL;
+        trans.kernel.pool_ = pool_list_[pool_idx].pool_;
+        trans.kernel.pool_idx_ = pool_idx;
+        trans.kernel.agent_ = agent_list_[host_idx].agent_;
+        trans.kernel.agent_idx_ = host_idx;
+        trans.kernel.op_ = LATENCY_STRIDE_LIST[idx];
+        trans_list_.push_back(trans);
+      }
+    }
+  }
+  return true;
+}
+
+// @brief: Builds copies to every Gpu from system memory of the Cpu
+// device on its NUMA node, once per mode of sourcing host buffers
+bool RocmBandwidthTest::BuildHostSourceTrans() {
+
+  for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+    if ((agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) ||
+        (agent_pool_list_[gpu_idx].pool_list.size() == 0)) {
+      continue;
+    }
+    uint32_t dev_pool_idx = agent_pool_list_[gpu_idx].pool_list[0].index_;
+    uint32_t host_idx = GetPoolHostIdx(dev_pool_idx);
+    if ((agent_list_[host_idx].device_type_ != HSA_DEVICE_TYPE_CPU) ||
+        (agent_pool_list_[host_idx].pool_list.size() == 0)) {
+      continue;
+    }
+    uint32_t host_pool_idx = agent_pool_list_[host_idx].pool_list[0].index_;
+    if (GetPoolPathAccess(host_pool_idx, dev_pool_idx) == 0) {
+      continue;
+    }
+
+    // Update the list of agents active in any copy operation
+    if (active_agents_list_ == NULL) {
+      active_agents_list_  = new uint32_t[agent_index_]();
+    }
+    active_agents_list_[host_idx] = 1;
+    active_agents_list_[gpu_idx] = 1;
+
+    for (uint32_t mode = 0; mode < HOST_SOURCE_MODE_COUNT; mode++) {
+      async_trans_t trans(REQ_HOST_SOURCE);
+      trans.copy.src_idx_ = host_pool_idx;
+      trans.copy.dst_idx_ = dev_pool_idx;
+      trans.copy.src_pool_ = pool_list_[host_pool_idx].pool_;
+      trans.copy.dst_pool_ = pool_list_[dev_pool_idx].pool_;
+      trans.copy.bidir_ = false;
+      trans.copy.uses_gpu_ = true;
+      trans.copy.kernel_idx_ = HostCopyEngine::GetBestKernel();
+      trans.copy.page_kind_ = HOST_PAGE_POOL;
+      trans.copy.source_mode_ = mode;
+      trans_list_.push_back(trans);
+    }
+  }
+  return true;
+}
+
+// @brief: Builds a transaction per collective across Gpu devices,
+// ranked in order of their indices. A device joins only if its pool
+// can be copied to and from the pools of every device ranked before
+bool RocmBandwidthTest::BuildCollectiveTrans() {
+
+  for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+    if ((agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) ||
+        (agent_pool_list_[gpu_idx].pool_list.size() == 0)) {
+      continue;
+    }
+    uint32_t pool_idx = agent_pool_list_[gpu_idx].pool_list[0].index_;
+    bool reachable = true;
+    for (uint32_t rank = 0; rank < collective_pool_list_.size(); rank++) {
+      if ((GetPoolPathAccess(pool_idx, collective_pool_list_[rank]) == 0) ||
+          (GetPoolPathAccess(collective_pool_list_[rank], pool_idx) == 0)) {
+        reachable = false;
+      }
+    }
+    if (reachable) {
+      collective_pool_list_.push_back(pool_idx);
+    }
+  }
+
+  // Collectives need at least two devices
+  if (collective_pool_list_.size() < 2) {
+    collective_pool_list_.clear();
+    return true;
+  }
+
+  // Update the list of agents active in any copy operation
+  if (active_agents_list_ == NULL) {
+    active_agents_list_  = new uint32_t[agent_index_]();
+  }
+  for (uint32_t rank = 0; rank < collective_pool_list_.size(); rank++) {
+    active_agents_list_[pool_list_[collective_pool_list_[rank]].agent_index_] = 1;
+  }
+
+  for (uint32_t op = 0; op < COLLECTIVE_OP_COUNT; op++) {
+    async_trans_t trans(REQ_COLLECTIVE);
+    trans.kernel.code_ = NULL;
+    trans.kernel.pool_idx_ = collective_pool_list_[0];
+    trans.kernel.pool_ = pool_list_[collective_pool_list_[0]].pool_;
+    trans.kernel.agent_idx_ = pool_list_[collective_pool_list_[0]].agent_index_;
+    trans.kernel.agent_ = pool_list_[collective_pool_list_[0]].owner_agent_;
+    trans.kernel.op_ = op;
+    trans_list_.push_back(trans);
+  }
+  return true;
+}
+
+// @brief: Builds a transaction per bipartition of Gpu devices, which
+// is either the split given by user, listed devices against the rest,
+// or every balanced bipartition. Copies cross the cut in both
+// directions between every pair of devices whose pools can reach
+// each other, as given by the access matrix
+bool RocmBandwidthTest::BuildBisectionTrans() {
+
+  for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+    if ((agent_list_[gpu_idx].device_type_ == HSA_DEVICE_TYPE_GPU) &&
+        (agent_pool_list_[gpu_idx].pool_list.size() != 0) &&
+        (bisection_pool_list_.size() < BISECTION_RANK_MAX)) {
+      bisection_pool_list_.push_back(agent_pool_list_[gpu_idx].pool_list[0].index_);
+    }
+  }
+
+  // Bisection needs at least two devices
+  uint32_t num_ranks = bisection_pool_list_.size();
+  if (num_ranks < 2) {
+    bisection_pool_list_.clear();
+    return true;
+  }
+
+  // Mask of ranks on one side of every bipartition. A split of user
+  // must list Gpu devices and leave at least one on the other side
+  vector<uint64_t> mask_list;
+  uint64_t all_mask = (1ULL << num_ranks) - 1;
+  if (bisection_side_list_.size() != 0) {
+    uint64_t mask = 0;
+    for (uint32_t idx = 0; idx < bisection_side_list_.size(); idx++) {
+      uint32_t rank = 0;
+      while ((rank < num_ranks) &&
+             (pool_list_[bisection_pool_list_[rank]].agent_index_ != bisection_side_list_[idx])) {
+        rank++;
+      }
+      if ((rank == num_ranks) || (mask & (1ULL << rank))) {
+        return false;
+      }
+      mask |= (1ULL << rank);
+    }
+    if (mask == all_mask) {
+      return false;
+    }
+    mask_list.push_back(mask);
+  } else {
+
+    // Count balanced bipartitions, binomial coefficient of half the
+    // ranks. With an even number of ranks, a mask and its complement
+    // are the same split, which is counted once by keeping the first
+    // rank on this side
+    uint32_t half = num_ranks / 2;
+    vector<uint64_t> binomial_list(num_ranks + 1, 0);
+    binomial_list[0] = 1;
+    for (uint32_t row = 1; row <= num_ranks; row++) {
+      for (uint32_t col = row; col > 0; col--) {
+        binomial_list[col] += binomial_list[col - 1];
+      }
+    }
+    bisection_split_count_ = binomial_list[half];
+    if ((num_ranks % 2) == 0) {
+      bisection_split_count_ /= 2;
+    }
+
+    if (bisection_split_count_ <= BISECTION_PARTITION_MAX) {
+
+      // Walk masks of half the ranks in increasing order
+      uint64_t mask = (1ULL << half) - 1;
+      while (mask <= all_mask) {
+        if (((num_ranks % 2) != 0) || (mask & 1)) {
+          mask_list.push_back(mask);
+        }
+        uint64_t low = mask & (~mask + 1);
+        uint64_t ripple = mask + low;
+        mask = ripple | (((mask ^ ripple) >> 2) / low);
+      }
+    } else {
+
+      // Draw distinct splits uniformly at random, each the first half
+      // of a random permutation of ranks. Splits are not taken in
+      // increasing order, which would keep the low ranks on one side
+      bisection_sampled_ = true;
+      bisection_seed_ = ((bisection_seed_str_ != NULL) && (*bisection_seed_str_ != '\0')) ?
+                        strtoull(bisection_seed_str_, NULL, 0) :
+                        (((uint64_t)std::random_device{}() << 32) | std::random_device{}());
+      std::mt19937_64 split_rng(bisection_seed_);
+      vector<uint32_t> rank_list(num_ranks);
+      for (uint32_t rank = 0; rank < num_ranks; rank++) {
+        rank_list[rank] = rank;
+      }
+      std::set<uint64_t> mask_set;
+      while (mask_set.size() < BISECTION_PARTITION_MAX) {
+        std::shuffle(rank_list.begin(), rank_list.end(), split_rng);
+        uint64_t mask = 0;
+        for (uint32_t rank = 0; rank < half; rank++) {
+          mask |= (1ULL << rank_list[rank]);
+        }
+        if (((num_ranks % 2) == 0) && ((mask & 1) == 0)) {
+          mask ^= all_mask;
+        }
+        mask_set.insert(mask);
+      }
+      mask_list.assign(mask_set.begin(), mask_set.end());
+    }
+  }
+
+  // Update the list of agents active in any copy operation
+  if (active_agents_list_ == NULL) {
+    active_agents_list_  = new uint32_t[agent_index_]();
+  }
+  for (uint32_t rank = 0; rank < num_ranks; rank++) {
+    active_agents_list_[pool_list_[bisection_pool_list_[rank]].agent_index_] = 1;
+  }
+
+  for (uint32_t idx = 0; idx < mask_list.size(); idx++) {
+    uint32_t num_copies = 0;
+    for (uint32_t src = 0; src < num_ranks; src++) {
+      for (uint32_t dst = 0; dst < num_ranks; dst++) {
+        bool src_side = (mask_list[idx] >> src) & 1;
+        bool dst_side = (mask_list[idx] >> dst) & 1;
+        if ((src_side != dst_side) &&
+            (GetPoolPathAccess(bisection_pool_list_[src], bisection_pool_list_[dst]) != 0)) {
+          num_copies++;
+        }
+      }
+    }
+    if (num_copies == 0) {
+      continue;
+    }
+    async_trans_t trans(REQ_BISECTION);
+    trans.kernel.code_ = NULL;
+    trans.kernel.pool_idx_ = bisection_pool_list_[0];
+    trans.kernel.pool_ = pool_list_[bisection_pool_list_[0]].pool_;
+    trans.kernel.agent_idx_ = pool_list_[bisection_pool_list_[0]].agent_index_;
+    trans.kernel.agent_ = pool_list_[bisection_pool_list_[0]].owner_agent_;
+    trans.kernel.op_ = num_copies;
+    trans.side_mask_ = mask_list[idx];
+    trans_list_.push_back(trans);
+  }
+  return true;
+}
+
+// @brief: Builds a transaction per copy path of interference sweep,
+// which runs from the first pool of a device into the first pool of
+// another, either of them a Gpu. Paths are limited to devices listed
+// by user, if any, and to pools that can reach each other
+bool RocmBandwidthTest::BuildInterferenceTrans() {
+
+  for (uint32_t src_dev_idx = 0; src_dev_idx < agent_index_; src_dev_idx++) {
+    for (uint32_t dst_dev_idx = 0; dst_dev_idx < agent_index_; dst_dev_idx++) {
+
+      if ((src_dev_idx == dst_dev_idx) ||
+          (agent_pool_list_[src_dev_idx].pool_list.size() == 0) ||
+          (agent_pool_list_[dst_dev_idx].pool_list.size() == 0)) {
+        continue;
+      }
+      hsa_device_type_t src_dev_type = agent_list_[src_dev_idx].device_type_;
+      hsa_device_type_t dst_dev_type = agent_list_[dst_dev_idx].device_type_;
+      if ((src_dev_type != HSA_DEVICE_TYPE_GPU) &&
+          (dst_dev_type != HSA_DEVICE_TYPE_GPU)) {
+        continue;
+      }
+      if ((interference_dev_list_.size() != 0) &&
+          ((std::find(interference_dev_list_.begin(), interference_dev_list_.end(),
+                      src_dev_idx) == interference_dev_list_.end()) ||
+           (std::find(interference_dev_list_.begin(), interference_dev_list_.end(),
+                      dst_dev_idx) == interference_dev_list_.end()))) {
+        continue;
+      }
+
+      uint32_t src_idx = agent_pool_list_[src_dev_idx].pool_list[0].index_;
+      uint32_t dst_idx = agent_pool_list_[dst_dev_idx].pool_list[0].index_;
+      if (GetPoolPathAccess(src_idx, dst_idx) == 0) {
+        continue;
+      }
+
+      // Update the list of agents active in any copy operation
+      if (active_agents_list_ == NULL) {
+        active_agents_list_  = new uint32_t[agent_index_]();
+      }
+      active_agents_list_[src_dev_idx] = 1;
+      active_agents_list_[dst_dev_idx] = 1;
+
+      async_trans_t trans(REQ_INTERFERENCE);
+      trans.copy.src_idx_ = src_idx;
+      trans.copy.dst_idx_ = dst_idx;
+      trans.copy.src_pool_ = pool_list_[src_idx].pool_;
+      trans.copy.dst_pool_ = pool_list_[dst_idx].pool_;
+      trans.copy.bidir_ = false;
+      trans.copy.uses_gpu_ = true;
+      trans.copy.kernel_idx_ = HostCopyEngine::GetBestKernel();
+      trans.copy.page_kind_ = HOST_PAGE_POOL;
+      interference_trans_list_.push_back(trans_list_.size());
+      trans_list_.push_back(trans);
+    }
+  }
+
+  // Interference needs at least two paths
+  if (interference_trans_list_.size() < 2) {
+    trans_list_.erase(trans_list_.end() - interference_trans_list_.size(),
+                      trans_list_.end());
+    interference_trans_list_.clear();
+  }
+  return true;
+}
+
+// @brief: Builds a transaction per direction of copy between the
+// first pool of every Cpu device and the first pool of every Gpu,
+// where pools can reach each other
+bool RocmBandwidthTest::BuildHostLoadTrans() {
+
+  for (uint32_t host_idx = 0; host_idx < agent_index_; host_idx++) {
+    if ((agent_list_[host_idx].device_type_ != HSA_DEVICE_TYPE_CPU) ||
+        (agent_pool_list_[host_idx].pool_list.size() == 0)) {
+      continue;
+    }
+    for (uint32_t gpu_idx = 0; gpu_idx < agent_index_; gpu_idx++) {
+      if ((agent_list_[gpu_idx].device_type_ != HSA_DEVICE_TYPE_GPU) ||
+          (agent_pool_list_[gpu_idx].pool_list.size() == 0)) {
+        continue;
+      }
+
+      uint32_t host_pool_idx = agent_pool_list_[host_idx].pool_list[0].index_;
+      uint32_t gpu_pool_idx = agent_pool_list_[gpu_idx].pool_list[0].index_;
+      for (uint32_t dir = 0; dir < 2; dir++) {
+        uint32_t src_idx = (dir == 0) ? host_pool_idx : gpu_pool_idx;
+        uint32_t dst_idx = (dir == 0) ? gpu_pool_idx : host_pool_idx;
+        if (GetPoolPathAccess(src_idx, dst_idx) == 0) {
+          continue;
+        }
+
+        // Update the list of agents active in any copy operation
+        if (active_agents_list_ == NULL) {
+          active_agents_list_  = new uint32_t[agent_index_]();
+        }
+        active_agents_list_[host_idx] = 1;
+        active_agents_list_[gpu_idx] = 1;
+
+        async_trans_t trans(REQ_HOST_LOAD);
+        trans.copy.src_idx_ = src_idx;
+        trans.copy.dst_idx_ = dst_idx;
+        trans.copy.src_pool_ = pool_list_[src_idx].pool_;
+        trans.copy.dst_pool_ = pool_list_[dst_idx].pool_;
+        trans.copy.bidir_ = false;
+        trans.copy.uses_gpu_ = true;
+        trans.copy.kernel_idx_ = HostCopyEngine::GetBestKernel();
+        trans.copy.page_kind_ = HOST_PAGE_POOL;
+        trans_list_.push_back(trans);
+      }
+    }
+  }
+  return true;
+}
+
+// @brief: Builds a list of transaction per user request
+bool RocmBandwidthTest::BuildTransList() {
+
+  // Build list of Read transactions per user request
+  bool status = false;
+  if (req_read_ == REQ_READ) {
+    status = BuildReadTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of Write transactions per user request
+  status = false;
+  if (req_write_ == REQ_WRITE) {
+    status = BuildWriteTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of Bidirectional Copy transactions per user request
+  status = false;
+  if (req_copy_bidir_ == REQ_COPY_BIDIR) {
+    status = BuildBidirCopyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of Unidirectional Copy transactions per user request
+  status = false;
+  if (req_copy_unidir_ == REQ_COPY_UNIDIR) {
+    status = BuildUnidirCopyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of All Bidir Copy transactions per user request
+  status = false;
+  if (req_copy_all_bidir_ == REQ_COPY_ALL_BIDIR) {
+    status = BuildAllPoolsBidirCopyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of All Unidir Copy transactions per user request
+  status = false;
+  if (req_copy_all_unidir_ == REQ_COPY_ALL_UNIDIR) {
+    status = BuildAllPoolsUnidirCopyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of NUMA sweep transactions per user request
+  if (numa_sweep_) {
+    status = BuildNumaCopyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of host copy kernel transactions per user request
+  if (kernel_sweep_) {
+    status = BuildHostKernelTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of STREAM transactions per user request
+  if (stream_sweep_) {
+    status = BuildStreamTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of pointer chase transactions per user request
+  if (latency_sweep_) {
+    status = BuildLatencyTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of host source transactions per user request
+  if (source_sweep_) {
+    status = BuildHostSourceTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of collective transactions per user request
+  if (collective_sweep_) {
+    status = BuildCollectiveTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of bisection transactions per user request
+  if (bisection_sweep_) {
+    status = BuildBisectionTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of interference transactions per user request
+  if (interference_sweep_) {
+    status = BuildInterferenceTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // Build list of host load transactions per user request
+  if (host_load_sweep_) {
+    status = BuildHostLoadTrans();
+    if (status == false) {
+      return status;
+    }
+  }
+
+  // All of the transaction are built up
+  return true;
+}
+
+void RocmBandwidthTest::ComputeCopyTime(async_trans_t& trans) {
+
+  // Get the frequency of Gpu Timestamping
+  uint64_t sys_freq = 0;
+  backend_->SystemGetInfo(HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY, &sys_freq);
+
+  double avg_time = 0;
+  double min_time = 0;
+  uint32_t data_size = 0;
+  double avg_bandwidth = 0;
+  double peak_bandwidth = 0;
+  uint32_t size_len = size_list_.size();
+  for (uint32_t idx = 0; idx < size_len; idx++) {
+
+    // Adjust size of data involved in copy
+    data_size = size_list_[idx];
+    if (trans.copy.bidir_ == true) {
+      data_size += size_list_[idx];
+    }
+
+    // Double data size if copying the same device
+    if (trans.copy.src_idx_ == trans.copy.dst_idx_) {
+      data_size += data_size;
+    }
+
+    // Copy operation does not involve a Gpu device
+    if (trans.copy.uses_gpu_ != true) {
+      avg_time = trans.cpu_avg_time_[idx];
+      min_time = trans.cpu_min_time_[idx];
+      avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
+      peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
+    } else {
+      if (print_cpu_time_ == false) {
+        avg_time = trans.gpu_avg_time_[idx] / sys_freq;
+        min_time = trans.gpu_min_time_[idx] / sys_freq;
+      } else {
+        avg_time = trans.cpu_avg_time_[idx];
+        min_time = trans.cpu_min_time_[idx];
+      }
+      avg_bandwidth = (double)data_size / avg_time / 1000 / 1000 / 1000;
+      peak_bandwidth = (double)data_size / min_time / 1000 / 1000 / 1000;
+    }
+
+    trans.min_time_.push_back(min_time);
+    trans.avg_time_.push_back(avg_time);
+    trans.avg_bandwidth_.push_back(avg_bandwidth);
+    trans.peak_bandwidth_.push_back(peak_bandwidth);
+  }
+}
+